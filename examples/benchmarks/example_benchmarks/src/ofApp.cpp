@@ -0,0 +1,1138 @@
+//
+// Copyright (c) 2009 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofApp.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "Poco/DeflatingStream.h"
+#include "Poco/HexBinaryDecoder.h"
+#include "Poco/HexBinaryEncoder.h"
+#include "Poco/InflatingStream.h"
+#include "Poco/UnbufferedStreamBuf.h"
+#include "Poco/URI.h"
+
+
+// Count every heap allocation made by the benchmark process.
+static std::atomic<uint64_t> allocationCount(0);
+
+
+void* operator new(std::size_t size)
+{
+    ++allocationCount;
+
+    if (void* p = std::malloc(size))
+    {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+
+const std::size_t ofApp::BYTES_PER_BENCHMARK = 256 * 1024 * 1024;
+
+
+// The original one-byte-per-virtual-call stream buffer, for comparison.
+class UnbufferedOutputStreamBuf: public Poco::UnbufferedStreamBuf
+{
+public:
+    UnbufferedOutputStreamBuf(ofxIO::ByteBuffer& buffer): _buffer(buffer)
+    {
+    }
+
+protected:
+    int writeToDevice(char byte) override
+    {
+        _buffer.writeByte(byte);
+        return charToInt(byte);
+    }
+
+private:
+    ofxIO::ByteBuffer& _buffer;
+
+};
+
+
+// The original byte loop COBS encoder, for comparison.
+static std::size_t encodeCOBSByteLoop(const uint8_t* buffer,
+                                      std::size_t size,
+                                      uint8_t* encoded)
+{
+    std::size_t read_index  = 0;
+    std::size_t write_index = 1;
+    std::size_t code_index  = 0;
+    uint8_t code = 1;
+
+    while (read_index < size)
+    {
+        if (buffer[read_index] == 0)
+        {
+            encoded[code_index] = code;
+            code = 1;
+            code_index = write_index++;
+            read_index++;
+        }
+        else
+        {
+            encoded[write_index++] = buffer[read_index++];
+            code++;
+
+            if (code == 0xFF)
+            {
+                encoded[code_index] = code;
+                code = 1;
+                code_index = write_index++;
+            }
+        }
+    }
+
+    encoded[code_index] = code;
+
+    return write_index;
+}
+
+
+void ofApp::setup()
+{
+    benchmarkStreams(1024);
+    benchmarkStreams(64 * 1024);
+    benchmarkStreams(64 * 1024 * 1024);
+    benchmarkAllocations();
+    benchmarkMappedFile(std::size_t(1024) * 1024 * 1024);
+    benchmarkFiles(200 * 1024 * 1024);
+    benchmarkAsyncFiles(10000, 4096);
+    benchmarkByteOperations(16 * 1024 * 1024);
+    benchmarkBase64(1024 * 1024);
+    benchmarkHexBinary(1024 * 1024);
+    benchmarkCOBSFrames(100000, 64);
+    benchmarkCOBS(1024 * 1024);
+    benchmarkSLIPFrames(100000, 32);
+    benchmarkURI(100000);
+    benchmarkPipeline(16 * 1024 * 1024);
+    benchmarkZlib(4 * 1024 * 1024);
+    benchmarkLZ4(64 * 1024 * 1024);
+    benchmarkCompressionLevels(1024 * 1024);
+    benchmarkCompressors(10000, 512);
+    benchmarkDictionaries(10000);
+    benchmarkParallelCompression(256 * 1024 * 1024);
+}
+
+
+void ofApp::draw()
+{
+    ofBackgroundGradient(ofColor::white, ofColor::black);
+    ofDrawBitmapStringHighlight("See console for output.", ofPoint(30, 30));
+}
+
+
+void ofApp::benchmarkStreams(std::size_t size)
+{
+    ofxIO::ByteBuffer payload(size, 'x');
+
+    run("Unbuffered write " + ofToString(size) + " B", size, [&]() {
+        ofxIO::ByteBuffer buffer;
+        UnbufferedOutputStreamBuf streamBuf(buffer);
+        std::ostream ostr(&streamBuf);
+        ostr << payload;
+    });
+
+    run("ByteBufferOutputStream " + ofToString(size) + " B", size, [&]() {
+        ofxIO::ByteBuffer buffer;
+        ofxIO::ByteBufferOutputStream ostr(buffer);
+        ostr << payload;
+        ostr.flush();
+    });
+
+    run("ByteBufferInputStream " + ofToString(size) + " B", size, [&]() {
+        ofxIO::ByteBuffer buffer;
+        ofxIO::ByteBufferInputStream istr(payload);
+        istr >> buffer;
+    });
+
+    ofxIO::ByteBuffer encoded;
+    ofxIO::Base64Encoding base64;
+    base64.encode(payload, encoded);
+
+    run("Base64Encoding::encode " + ofToString(size) + " B", size, [&]() {
+        ofxIO::ByteBuffer buffer;
+        base64.encode(payload, buffer);
+    });
+
+    run("Base64Encoding::decode " + ofToString(size) + " B", size, [&]() {
+        ofxIO::ByteBuffer buffer;
+        base64.decode(encoded, buffer);
+    });
+}
+
+
+void ofApp::benchmarkAllocations()
+{
+    const std::size_t iterations = 1000;
+
+    ofxIO::ByteBuffer payload(64 * 1024, 'x');
+
+    std::vector<std::pair<std::string, std::shared_ptr<ofxIO::AbstractByteEncoderDecoder>>> encoders = {
+        { "Base64Encoding", std::make_shared<ofxIO::Base64Encoding>() },
+        { "HexBinaryEncoding", std::make_shared<ofxIO::HexBinaryEncoding>() },
+        { "COBSEncoding", std::make_shared<ofxIO::COBSEncoding>() },
+        { "SLIPEncoding", std::make_shared<ofxIO::SLIPEncoding>() },
+        { "URIEncoding", std::make_shared<ofxIO::URIEncoding>() }
+    };
+
+    ofxIO::ByteBufferPool& pool = ofxIO::ByteBufferPool::threadLocal();
+
+    for (auto& encoder: encoders)
+    {
+        uint64_t start = allocationCount;
+
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            ofxIO::ByteBuffer encoded;
+            ofxIO::ByteBuffer decoded;
+            encoder.second->encode(payload, encoded);
+            encoder.second->decode(encoded, decoded);
+        }
+
+        uint64_t unpooled = allocationCount - start;
+
+        start = allocationCount;
+
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            ofxIO::ByteBuffer encoded = pool.acquire();
+            ofxIO::ByteBuffer decoded = pool.acquire();
+            encoder.second->encode(payload, encoded);
+            encoder.second->decode(encoded, decoded);
+            pool.recycle(std::move(encoded));
+            pool.recycle(std::move(decoded));
+        }
+
+        uint64_t pooled = allocationCount - start;
+
+        ofLogNotice("ofApp::benchmarkAllocations") << encoder.first << ": "
+            << (double(unpooled) / iterations) << " allocations / round trip, "
+            << (double(pooled) / iterations) << " pooled.";
+    }
+
+    pool.reset();
+}
+
+
+void ofApp::benchmarkMappedFile(std::size_t size)
+{
+    const std::string path = ofToDataPath("mapped_file_benchmark.bin", true);
+
+    {
+        std::ofstream ostr(path, std::ios::binary | std::ios::trunc);
+        std::vector<char> chunk(1024 * 1024, 'x');
+
+        for (std::size_t written = 0; written < size; written += chunk.size())
+        {
+            ostr.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        }
+    }
+
+    // Touch every byte so that mapped pages are actually read.
+    auto sum = [](const uint8_t* data, std::size_t size) {
+        uint64_t total = 0;
+        for (std::size_t i = 0; i < size; ++i) total += data[i];
+        return total;
+    };
+
+    uint64_t start = ofGetElapsedTimeMicros();
+    ofxIO::ByteBuffer buffer;
+    ofxIO::ByteBufferUtils::loadFromFile(path, buffer);
+    uint64_t streamTotal = sum(buffer.getPtr(), buffer.size());
+    double streamSeconds = (ofGetElapsedTimeMicros() - start) / 1000000.0;
+    buffer = ofxIO::ByteBuffer();
+
+    start = ofGetElapsedTimeMicros();
+    ofxIO::MappedFileBuffer mapped(path);
+    uint64_t mappedTotal = sum(mapped.getPtr(), mapped.size());
+    double mappedSeconds = (ofGetElapsedTimeMicros() - start) / 1000000.0;
+    mapped.close();
+
+    double megabytes = size / (1024.0 * 1024.0);
+
+    ofLogNotice("ofApp::benchmarkMappedFile") << "loadFromFile " << ofToString(megabytes, 0) << " MB: " << ofToString(megabytes / streamSeconds, 1) << " MB/s";
+    ofLogNotice("ofApp::benchmarkMappedFile") << "MappedFileBuffer " << ofToString(megabytes, 0) << " MB: " << ofToString(megabytes / mappedSeconds, 1) << " MB/s";
+
+    if (streamTotal != mappedTotal)
+    {
+        ofLogError("ofApp::benchmarkMappedFile") << "Checksum mismatch.";
+    }
+
+    ofFile::removeFile(path, false);
+}
+
+
+void ofApp::benchmarkFiles(std::size_t size)
+{
+    const std::string path = ofToDataPath("file_benchmark.bin", true);
+    const ofxIO::ByteBuffer payload(size, 'x');
+    const std::string suffix = " " + ofToString(size / (1024 * 1024)) + " MB";
+
+    // Adding std::ios::in keeps saveToFile() on the Poco stream path.
+    run("save stream" + suffix, size, [&]() {
+        ofxIO::ByteBufferUtils::saveToFile(payload, path, std::ios::out | std::ios::trunc | std::ios::binary | std::ios::in);
+    });
+
+    run("save fd" + suffix, size, [&]() {
+        ofxIO::ByteBufferUtils::saveToFileDescriptor(payload, path, ofxIO::ByteBufferUtils::FILE_DEFAULT);
+    });
+
+    run("save fd fdatasync" + suffix, size, [&]() {
+        ofxIO::ByteBufferUtils::saveToFileDescriptor(payload, path, ofxIO::ByteBufferUtils::FILE_SYNC);
+    });
+
+    run("load stream" + suffix, size, [&]() {
+        std::ifstream istr(path, std::ios::binary);
+        ofxIO::ByteBuffer buffer = ofxIO::ByteBufferUtils::makeBuffer(istr);
+    });
+
+    run("load fd" + suffix, size, [&]() {
+        ofxIO::ByteBuffer buffer;
+        ofxIO::ByteBufferUtils::loadFromFileDescriptor(path, buffer, false, ofxIO::ByteBufferUtils::FILE_DEFAULT);
+    });
+
+    run("load fd O_DIRECT" + suffix, size, [&]() {
+        ofxIO::ByteBuffer buffer;
+        ofxIO::ByteBufferUtils::loadFromFileDescriptor(path, buffer, false, ofxIO::ByteBufferUtils::FILE_DIRECT);
+    });
+
+    ofFile::removeFile(path, false);
+}
+
+
+void ofApp::benchmarkAsyncFiles(std::size_t count, std::size_t size)
+{
+    const std::string directory = ofToDataPath("async_file_benchmark", true);
+    ofDirectory::createDirectory(directory, false, true);
+
+    std::vector<std::string> paths;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        paths.push_back(ofFilePath::join(directory, ofToString(i) + ".bin"));
+    }
+
+    auto report = [&](const std::string& name, uint64_t start) {
+        double seconds = (ofGetElapsedTimeMicros() - start) / 1000000.0;
+        ofLogNotice("ofApp::benchmarkAsyncFiles") << name << ": " << ofToString(count / seconds, 0) << " files/s";
+    };
+
+    uint64_t start = ofGetElapsedTimeMicros();
+
+    for (const auto& path: paths)
+    {
+        ofxIO::ByteBufferUtils::saveToFileDescriptor(ofxIO::ByteBuffer(size, 'x'), path, ofxIO::ByteBufferUtils::FILE_DEFAULT);
+    }
+
+    report("save sequential", start);
+
+    start = ofGetElapsedTimeMicros();
+
+    for (const auto& path: paths)
+    {
+        ofxIO::ByteBuffer buffer;
+        ofxIO::ByteBufferUtils::loadFromFileDescriptor(path, buffer, false, ofxIO::ByteBufferUtils::FILE_DEFAULT);
+    }
+
+    report("load sequential", start);
+
+    for (auto backend: { ofxIO::AsyncFileIO::Backend::IO_URING, ofxIO::AsyncFileIO::Backend::THREAD_POOL })
+    {
+        ofxIO::AsyncFileIO io(backend);
+        const std::string name = io.backend() == ofxIO::AsyncFileIO::Backend::IO_URING ? "io_uring" : "thread pool";
+
+        std::vector<ofxIO::AsyncFileRequest> writes;
+
+        for (const auto& path: paths)
+        {
+            writes.push_back(ofxIO::AsyncFileRequest::write(path, ofxIO::ByteBuffer(size, 'x')));
+        }
+
+        start = ofGetElapsedTimeMicros();
+        for (auto& result: io.submit(std::move(writes))) result.wait();
+        report("save " + name, start);
+
+        std::vector<ofxIO::AsyncFileRequest> reads;
+
+        for (const auto& path: paths)
+        {
+            reads.push_back(ofxIO::AsyncFileRequest::read(path));
+        }
+
+        start = ofGetElapsedTimeMicros();
+        for (auto& result: io.submit(std::move(reads))) result.wait();
+        report("load " + name, start);
+    }
+
+    ofDirectory::removeDirectory(directory, true, false);
+}
+
+
+void ofApp::benchmarkByteOperations(std::size_t size)
+{
+    // Chunked Base64 text, the worst case for the Base64Encoding clean up.
+    static const std::string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    ofxIO::ByteBuffer text;
+    text.reserve(size);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        text.writeByte((i % 78 == 76) ? '\r' : (i % 78 == 77) ? '\n' : alphabet[static_cast<std::size_t>(ofRandom(alphabet.size()))]);
+    }
+
+    std::array<uint8_t, 256> urlSafe = ofxIO::ByteBuffer::identityTable();
+    urlSafe['+'] = '-';
+    urlSafe['/'] = '_';
+
+    const std::string suffix = " " + ofToString(size / (1024 * 1024)) + " MB";
+
+    run("remove \\r \\n" + suffix, size, [&]() {
+        ofxIO::ByteBuffer buffer = text;
+        buffer.remove(ofxIO::ByteSet({ '\r', '\n' }));
+    });
+
+    run("replace" + suffix, size, [&]() {
+        ofxIO::ByteBuffer buffer = text;
+        buffer.replace('+', '-');
+    });
+
+    run("translate" + suffix, size, [&]() {
+        ofxIO::ByteBuffer buffer = text;
+        buffer.translate(urlSafe);
+    });
+
+    run("find" + suffix, size, [&]() {
+        text.find(ofxIO::ByteSet({ '=', '\0' }));
+    });
+
+    run("count" + suffix, size, [&]() {
+        text.count('+');
+    });
+}
+
+
+void ofApp::benchmarkBase64(std::size_t size)
+{
+    ofxIO::ByteBuffer payload;
+    payload.reserve(size);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        payload.writeByte(static_cast<uint8_t>(ofRandom(256)));
+    }
+
+    const std::string suffix = " " + ofToString(size / 1024) + " KB";
+
+    // The pointer API into a preallocated buffer, without any allocation.
+    std::vector<uint8_t> encoded(ofxIO::Base64Encoding::encodedSize(size, true, true));
+    std::vector<uint8_t> decoded(size);
+    std::size_t encodedSize = 0;
+
+    run("Base64 encode pointer" + suffix, size, [&]() {
+        encodedSize = ofxIO::Base64Encoding::encode(payload.getPtr(), size, encoded.data());
+    });
+
+    run("Base64 decode pointer" + suffix, size, [&]() {
+        ofxIO::Base64Encoding::decode(encoded.data(), encodedSize, decoded.data());
+    });
+
+    // The stream encoder, fed in 64 KB chunks.
+    ofxIO::Base64Encoding base64;
+    std::unique_ptr<ofxIO::AbstractByteTransform> encoder = base64.createStreamEncoder();
+
+    run("Base64 encode stream" + suffix, size, [&]() {
+        ofxIO::ByteBuffer buffer;
+
+        for (std::size_t offset = 0; offset < size; offset += 64 * 1024)
+        {
+            std::size_t chunk = std::min(size - offset, std::size_t(64 * 1024));
+            buffer.clear();
+            encoder->update(ofxIO::ByteBufferView(payload.getPtr() + offset, chunk), buffer);
+        }
+
+        encoder->finish(buffer);
+    });
+
+    std::vector<std::pair<std::string, ofxIO::Base64Encoding>> variants = {
+        { "standard", ofxIO::Base64Encoding(false, false, false) },
+        { "URL safe", ofxIO::Base64Encoding(true, false, false) },
+        { "padded", ofxIO::Base64Encoding(false, false, true) },
+        { "chunked", ofxIO::Base64Encoding(false, true, true) }
+    };
+
+    for (auto& variant: variants)
+    {
+        ofxIO::ByteBuffer buffer;
+        ofxIO::ByteBuffer text;
+        variant.second.encode(payload, text);
+
+        run("Base64 encode " + variant.first + suffix, size, [&]() {
+            variant.second.encode(payload, buffer);
+        });
+
+        run("Base64 decode " + variant.first + suffix, size, [&]() {
+            variant.second.decode(text, buffer);
+        });
+    }
+}
+
+
+void ofApp::benchmarkHexBinary(std::size_t size)
+{
+    ofxIO::ByteBuffer payload;
+    payload.reserve(size);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        payload.writeByte(static_cast<uint8_t>(ofRandom(256)));
+    }
+
+    const std::string suffix = " " + ofToString(size / 1024) + " KB";
+
+    // The previous implementation, through the Poco stream codecs.
+    ofxIO::ByteBuffer text;
+
+    run("Hex encode Poco" + suffix, size, [&]() {
+        text.clear();
+        ofxIO::ByteBufferOutputStream os(text);
+        Poco::HexBinaryEncoder encoder(os);
+        encoder.write(payload.getCharPtr(), static_cast<std::streamsize>(size));
+        encoder.close();
+        os.flush();
+    });
+
+    run("Hex decode Poco" + suffix, size, [&]() {
+        ofxIO::ByteBuffer buffer;
+        ofxIO::ByteBufferInputStream is(text);
+        Poco::HexBinaryDecoder decoder(is);
+        ofxIO::ByteBufferUtils::copyStreamToBuffer(decoder, buffer);
+    });
+
+    // The pointer API into a preallocated buffer, without any allocation.
+    std::vector<uint8_t> encoded(ofxIO::HexBinaryEncoding::encodedSize(size));
+    std::vector<uint8_t> decoded(size);
+
+    run("Hex encode pointer" + suffix, size, [&]() {
+        ofxIO::HexBinaryEncoding::encode(payload.getPtr(), size, encoded.data());
+    });
+
+    run("Hex decode pointer" + suffix, size, [&]() {
+        ofxIO::HexBinaryEncoding::decode(encoded.data(), encoded.size(), decoded.data());
+    });
+
+    std::vector<std::pair<std::string, ofxIO::HexBinaryEncoding>> variants = {
+        { "default", ofxIO::HexBinaryEncoding() },
+        { "upper case", ofxIO::HexBinaryEncoding(true, "", 0) },
+        { "separated", ofxIO::HexBinaryEncoding(false, " ", 16) }
+    };
+
+    for (auto& variant: variants)
+    {
+        ofxIO::ByteBuffer buffer;
+        variant.second.encode(payload, text);
+
+        run("Hex encode " + variant.first + suffix, size, [&]() {
+            variant.second.encode(payload, buffer);
+        });
+
+        run("Hex decode " + variant.first + suffix, size, [&]() {
+            variant.second.decode(text, buffer);
+        });
+    }
+}
+
+
+void ofApp::benchmarkCOBSFrames(std::size_t framesPerSecond, std::size_t frameSize)
+{
+    // Encode one second of delimited frames.
+    ofxIO::ByteBuffer stream;
+    std::vector<uint8_t> frame(frameSize);
+    std::vector<uint8_t> encoded(frameSize + frameSize / 254 + 1);
+
+    for (std::size_t i = 0; i < framesPerSecond; ++i)
+    {
+        for (auto& byte: frame)
+        {
+            byte = static_cast<uint8_t>(ofRandom(256));
+        }
+
+        std::size_t size = ofxIO::COBSEncoding::encode(frame.data(), frame.size(), encoded.data());
+        stream.writeBytes(encoded.data(), size);
+        stream.writeByte(0);
+    }
+
+    // Feed the stream in small chunks, as a serial port read would.
+    const std::size_t chunkSize = 64;
+
+    ofxIO::COBSStreamDecoder decoder(frameSize, 256);
+    std::size_t frames = 0;
+
+    uint64_t start = ofGetElapsedTimeMicros();
+
+    for (std::size_t offset = 0; offset < stream.size(); offset += chunkSize)
+    {
+        decoder.update(stream.getPtr() + offset, std::min(chunkSize, stream.size() - offset));
+
+        while (!decoder.empty())
+        {
+            ++frames;
+            decoder.pop();
+        }
+    }
+
+    double seconds = (ofGetElapsedTimeMicros() - start) / 1000000.0;
+
+    ofLogNotice("ofApp::benchmarkCOBSFrames") << frames << " frames of " << frameSize << " bytes in "
+                                             << ofToString(seconds * 1000.0, 2) << " ms: "
+                                             << ofToString(frames / seconds, 0) << " frames/s, "
+                                             << ofToString(1.0 / seconds, 1)
+                                             << "x the " << framesPerSecond << " frames/s target.";
+}
+
+
+void ofApp::benchmarkSLIPFrames(std::size_t frameCount, std::size_t frameSize)
+{
+    std::vector<ofxIO::ByteBuffer> messages(frameCount);
+
+    for (auto& message: messages)
+    {
+        for (std::size_t i = 0; i < frameSize; ++i)
+        {
+            message.writeByte(static_cast<uint8_t>(ofRandom(256)));
+        }
+    }
+
+    const std::size_t bytes = frameCount * frameSize;
+    const std::string suffix = " " + ofToString(frameCount) + " x " + ofToString(frameSize) + " B";
+
+    // One encoded buffer, and so one write(), per frame.
+    ofxIO::SLIPEncoding slip;
+    std::vector<ofxIO::ByteBuffer> encodedMessages(frameCount);
+
+    run("SLIP encode per frame" + suffix, bytes, [&]() {
+        for (std::size_t i = 0; i < frameCount; ++i)
+        {
+            slip.encode(messages[i], encodedMessages[i]);
+        }
+    });
+
+    // All frames in one contiguous buffer.
+    ofxIO::SLIPStreamEncoder encoder;
+
+    run("SLIP encode batch" + suffix, bytes, [&]() {
+        encoder.clear();
+
+        for (const auto& message: messages)
+        {
+            encoder.write(message);
+        }
+    });
+
+    // Decode the batch in serial port sized reads.
+    const std::size_t chunkSize = 4096;
+    const ofxIO::ByteBuffer& stream = encoder.buffer();
+
+    ofxIO::SLIPStreamDecoder decoder;
+    std::vector<ofxIO::ByteBuffer> frames;
+
+    run("SLIP decode stream" + suffix, bytes, [&]() {
+        for (std::size_t offset = 0; offset < stream.size(); offset += chunkSize)
+        {
+            decoder.update(ofxIO::ByteBufferView(stream.getPtr() + offset,
+                                                 std::min(chunkSize, stream.size() - offset)),
+                           frames);
+        }
+    });
+}
+
+
+void ofApp::benchmarkCOBS(std::size_t size)
+{
+    // Telemetry-like floats, which rarely contain a zero byte.
+    std::vector<uint8_t> payload(size);
+
+    for (std::size_t i = 0; i + sizeof(float) <= size; i += sizeof(float))
+    {
+        float value = ofRandom(1, 1000);
+        std::memcpy(&payload[i], &value, sizeof(float));
+    }
+
+    const std::string suffix = " " + ofToString(size / 1024) + " KB";
+
+    std::vector<uint8_t> encoded(size + size / 254 + 1);
+    std::vector<uint8_t> decoded(size);
+    std::size_t encodedSize = 0;
+
+    run("COBS encode byte loop" + suffix, size, [&]() {
+        encodeCOBSByteLoop(payload.data(), size, encoded.data());
+    });
+
+    run("COBS encode runs" + suffix, size, [&]() {
+        encodedSize = ofxIO::COBSEncoding::encode(payload.data(), size, encoded.data());
+    });
+
+    run("COBS decode runs" + suffix, size, [&]() {
+        ofxIO::COBSEncoding::decode(encoded.data(), encodedSize, decoded.data());
+    });
+
+    run("COBS/R encode runs" + suffix, size, [&]() {
+        encodedSize = ofxIO::COBSEncoding::encode(payload.data(), size, encoded.data(), true);
+    });
+
+    run("COBS/R decode runs" + suffix, size, [&]() {
+        ofxIO::COBSEncoding::decode(encoded.data(), encodedSize, decoded.data(), true);
+    });
+}
+
+
+void ofApp::benchmarkURI(std::size_t count)
+{
+    static const std::string WORDS[] = {
+        "ofxIO", "hello world", "a&b=c", "caf\xC3\xA9", "2019-01-01T00:00:00Z", "x+y/z"
+    };
+
+    std::vector<std::string> values(count);
+    std::size_t size = 0;
+
+    for (auto& value: values)
+    {
+        value = WORDS[std::size_t(ofRandom(6)) % 6] + " " + WORDS[std::size_t(ofRandom(6)) % 6];
+        size += value.size();
+    }
+
+    const std::string suffix = " " + ofToString(count) + " values";
+
+    // The previous implementation, through Poco::URI.
+    std::vector<std::string> encoded(count);
+
+    run("URI encode Poco" + suffix, size, [&]() {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            encoded[i].clear();
+            Poco::URI::encode(values[i], "&=+", encoded[i]);
+        }
+    });
+
+    run("URI decode Poco" + suffix, size, [&]() {
+        std::string decoded;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            decoded.clear();
+            Poco::URI::decode(encoded[i], decoded);
+        }
+    });
+
+    run("URI encode string" + suffix, size, [&]() {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            encoded[i] = ofxIO::URIEncoding::encode(values[i], "&=+");
+        }
+    });
+
+    // The pointer API into one preallocated buffer, decoding in place.
+    std::vector<uint8_t> buffer(3 * size);
+    std::size_t encodedSize = 0;
+
+    run("URI encode pointer QUERY" + suffix, size, [&]() {
+        encodedSize = 0;
+
+        for (const auto& value: values)
+        {
+            encodedSize += ofxIO::URIEncoding::encode(reinterpret_cast<const uint8_t*>(value.data()),
+                                                      value.size(),
+                                                      buffer.data() + encodedSize,
+                                                      ofxIO::URIEncoding::Profile::QUERY);
+        }
+    });
+
+    std::vector<uint8_t> copy(buffer.size());
+
+    run("URI decode pointer in place" + suffix, size, [&]() {
+        std::memcpy(copy.data(), buffer.data(), encodedSize);
+        ofxIO::URIEncoding::decode(copy.data(), encodedSize, copy.data());
+    });
+}
+
+
+void ofApp::benchmarkPipeline(std::size_t size)
+{
+    // Repetitive text, so the compression stage has something to do.
+    ofxIO::ByteBuffer payload;
+    payload.reserve(size);
+
+    while (payload.size() < size)
+    {
+        payload.writeBytes("{\"id\":" + ofToString(int(ofRandom(10000))) + ",\"value\":" + ofToString(ofRandom(1)) + "}\n");
+    }
+
+    const std::string suffix = " " + ofToString(size / (1024 * 1024)) + " MB";
+
+    ofxIO::CompressionEncoding snappy(ofxIO::Compression::SNAPPY);
+    ofxIO::Base64Encoding base64;
+    ofxIO::CodecPipeline pipeline("SNAPPY|BASE64");
+
+    ofxIO::ByteBuffer compressed;
+    ofxIO::ByteBuffer encoded;
+
+    run("SNAPPY then BASE64 two passes" + suffix, payload.size(), [&]() {
+        snappy.encode(payload, compressed);
+        base64.encode(compressed, encoded);
+    });
+
+    run("SNAPPY|BASE64 pipeline" + suffix, payload.size(), [&]() {
+        pipeline.encode(payload, encoded);
+    });
+
+    run("GZIP|BASE64 pipeline" + suffix, payload.size(), [&]() {
+        ofxIO::CodecPipeline("GZIP|BASE64").encode(payload, encoded);
+    });
+}
+
+
+void ofApp::benchmarkZlib(std::size_t size)
+{
+    ofxIO::ByteBuffer json;
+    json.reserve(size);
+
+    while (json.size() < size)
+    {
+        json.writeBytes("{\"id\":" + ofToString(int(ofRandom(10000))) + ",\"value\":" + ofToString(ofRandom(1)) + "}\n");
+    }
+
+    // A noisy gradient, like a camera frame.
+    ofPixels pixels;
+    pixels.allocate(1024, size / (1024 * 3), OF_PIXELS_RGB);
+
+    for (std::size_t i = 0; i < pixels.size(); ++i)
+    {
+        pixels[i] = static_cast<uint8_t>((i / 3) % 1024 / 4 + ofRandom(8));
+    }
+
+    ofxIO::ByteBuffer image(pixels.getData(), pixels.size());
+
+    std::vector<std::pair<std::string, const ofxIO::ByteBuffer*>> corpora = {
+        { "JSON", &json },
+        { "image", &image }
+    };
+
+    for (auto& corpus: corpora)
+    {
+        const ofxIO::ByteBuffer& payload = *corpus.second;
+        const std::string suffix = " " + corpus.first + " " + ofToString(payload.size() / 1024) + " KB";
+
+        ofxIO::ByteBuffer compressed;
+        ofxIO::ByteBuffer uncompressed;
+
+        // The previous implementation, through the Poco streams.
+        run("GZIP compress Poco" + suffix, payload.size(), [&]() {
+            compressed.clear();
+            ofxIO::ByteBufferOutputStream ostr(compressed);
+            Poco::DeflatingOutputStream deflater(ostr, Poco::DeflatingStreamBuf::STREAM_GZIP);
+            deflater.write(payload.getCharPtr(), static_cast<std::streamsize>(payload.size()));
+            deflater.close();
+            ostr.flush();
+        });
+
+        run("GZIP uncompress Poco" + suffix, payload.size(), [&]() {
+            uncompressed.clear();
+            ofxIO::ByteBufferInputStream istr(compressed);
+            Poco::InflatingInputStream inflater(istr, Poco::InflatingStreamBuf::STREAM_GZIP);
+            inflater >> uncompressed;
+        });
+
+        run("GZIP compress zlib" + suffix, payload.size(), [&]() {
+            ofxIO::Compression::compress(payload, compressed, ofxIO::Compression::GZIP);
+        });
+
+        run("GZIP uncompress zlib" + suffix, payload.size(), [&]() {
+            ofxIO::Compression::uncompress(compressed, uncompressed, ofxIO::Compression::GZIP);
+        });
+
+        run("ZLIB compress zlib level 1" + suffix, payload.size(), [&]() {
+            ofxIO::Compression::compress(payload, compressed, ofxIO::Compression::ZLIB, 1);
+        });
+    }
+}
+
+
+void ofApp::benchmarkLZ4(std::size_t size)
+{
+    // 16 bit samples of a slow signal, which repeat for many samples.
+    std::vector<int16_t> samples(size / sizeof(int16_t));
+
+    for (std::size_t i = 0; i < samples.size(); ++i)
+    {
+        samples[i] = static_cast<int16_t>(1000 * std::sin(i / 50000.0));
+    }
+
+    ofxIO::ByteBufferView payload(reinterpret_cast<const uint8_t*>(samples.data()),
+                                  samples.size() * sizeof(int16_t));
+
+    const std::string suffix = " " + ofToString(size / (1024 * 1024)) + " MB";
+
+    ofxIO::ByteBuffer compressed;
+    ofxIO::ByteBuffer uncompressed;
+
+    run("LZ4 frame compress" + suffix, payload.size(), [&]() {
+        ofxIO::Compression::compress(payload, compressed, ofxIO::Compression::LZ4);
+    });
+
+    run("LZ4 frame uncompress" + suffix, payload.size(), [&]() {
+        ofxIO::Compression::uncompress(compressed, uncompressed, ofxIO::Compression::LZ4);
+    });
+
+    ofLogNotice("ofApp::benchmarkLZ4") << "Ratio: " << ofToString(double(payload.size()) / compressed.size(), 1) << ":1";
+}
+
+
+void ofApp::benchmarkCompressionLevels(std::size_t size)
+{
+    ofxIO::ByteBuffer payload;
+    payload.reserve(size);
+
+    while (payload.size() < size)
+    {
+        payload.writeBytes("{\"id\":" + ofToString(int(ofRandom(10000))) + ",\"value\":" + ofToString(ofRandom(1)) + "}\n");
+    }
+
+    const std::string suffix = " " + ofToString(payload.size() / 1024) + " KB";
+
+    ofxIO::ByteBuffer compressed;
+
+    for (int level: { 9, 3, -1, -4, -16 })
+    {
+        run("LZ4 level " + ofToString(level) + suffix, payload.size(), [&]() {
+            ofxIO::Compression::compress(payload, compressed, ofxIO::Compression::LZ4, level);
+        });
+
+        ofLogNotice("ofApp::benchmarkCompressionLevels") << "Ratio: " << ofToString(double(payload.size()) / compressed.size(), 1) << ":1";
+    }
+
+    for (int level: { 1, 5, 9, 11 })
+    {
+        run("Brotli quality " + ofToString(level) + suffix, payload.size(), [&]() {
+            ofxIO::Compression::compress(payload, compressed, ofxIO::Compression::BR, level);
+        });
+
+        ofLogNotice("ofApp::benchmarkCompressionLevels") << "Ratio: " << ofToString(double(payload.size()) / compressed.size(), 1) << ":1";
+    }
+}
+
+
+void ofApp::benchmarkCompressors(std::size_t count, std::size_t size)
+{
+    std::vector<ofxIO::ByteBuffer> messages(count);
+
+    for (auto& message: messages)
+    {
+        while (message.size() < size)
+        {
+            message.writeBytes("{\"id\":" + ofToString(int(ofRandom(10000))) + ",\"value\":" + ofToString(ofRandom(1)) + "}");
+        }
+    }
+
+    std::size_t bytes = 0;
+
+    for (const auto& message: messages)
+    {
+        bytes += message.size();
+    }
+
+    const std::string suffix = " " + ofToString(count) + " x " + ofToString(size) + " B";
+
+    ofxIO::ByteBuffer compressed;
+    ofxIO::ByteBuffer uncompressed;
+
+    for (auto type: { ofxIO::Compression::ZLIB,
+                      ofxIO::Compression::LZ4,
+                      ofxIO::Compression::SNAPPY,
+                      ofxIO::Compression::BR })
+    {
+        const std::string name = ofxIO::Compression::toString(type);
+
+        run(name + " new Compressor" + suffix, bytes, [&]() {
+            for (const auto& message: messages)
+            {
+                ofxIO::Compressor compressor(type);
+                compressor.compress(message, compressed);
+            }
+        });
+
+        ofxIO::Compressor compressor(type);
+
+        run(name + " reused Compressor" + suffix, bytes, [&]() {
+            for (const auto& message: messages)
+            {
+                compressor.compress(message, compressed);
+            }
+        });
+
+        ofxIO::Decompressor decompressor(type);
+
+        run(name + " reused round trip" + suffix, bytes, [&]() {
+            for (const auto& message: messages)
+            {
+                compressor.compress(message, compressed);
+                decompressor.uncompress(compressed, uncompressed);
+            }
+        });
+    }
+}
+
+
+void ofApp::benchmarkDictionaries(std::size_t count)
+{
+    // Telemetry messages of 200 - 800 bytes, with the same keys.
+    auto message = []() {
+        std::string json = "{\"device\":\"sensor-" + ofToString(int(ofRandom(50))) + "\",\"readings\":[";
+
+        const int readings = int(ofRandom(3, 10));
+
+        for (int i = 0; i < readings; ++i)
+        {
+            json += std::string(i > 0 ? "," : "") + "{\"name\":\"reading-" + ofToString(int(ofRandom(8))) + "\",\"value\":" + ofToString(ofRandom(100), 2) + ",\"unit\":\"si\"}";
+        }
+
+        return ofxIO::ByteBuffer(json + "],\"status\":\"ok\"}");
+    };
+
+    std::vector<ofxIO::ByteBuffer> samples;
+    std::vector<ofxIO::ByteBuffer> messages;
+    std::size_t bytes = 0;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        samples.push_back(message());
+        messages.push_back(message());
+        bytes += messages.back().size();
+    }
+
+    uint64_t start = ofGetElapsedTimeMicros();
+    auto dictionary = ofxIO::CompressionDictionary::train(samples);
+
+    ofLogNotice("ofApp::benchmarkDictionaries") << "Trained " << dictionary.size() << " bytes in " << ofToString((ofGetElapsedTimeMicros() - start) / 1000.0, 1) << " ms";
+
+    const std::string suffix = " " + ofToString(count) + " messages";
+
+    ofxIO::ByteBuffer compressed;
+    ofxIO::ByteBuffer uncompressed;
+
+    for (auto type: { ofxIO::Compression::ZLIB,
+                      ofxIO::Compression::LZ4,
+                      ofxIO::Compression::BR })
+    {
+        const std::string name = ofxIO::Compression::toString(type);
+
+        for (bool useDictionary: { false, true })
+        {
+            ofxIO::Compressor compressor(type, useDictionary ? dictionary : ofxIO::CompressionDictionary());
+            ofxIO::Decompressor decompressor(type, useDictionary ? dictionary : ofxIO::CompressionDictionary());
+
+            const std::string label = name + (useDictionary ? " with dictionary" : " without dictionary") + suffix;
+
+            std::size_t compressedBytes = 0;
+
+            run(label + " compress", bytes, [&]() {
+                compressedBytes = 0;
+
+                for (const auto& message: messages)
+                {
+                    compressedBytes += compressor.compress(message, compressed);
+                }
+            });
+
+            run(label + " round trip", bytes, [&]() {
+                for (const auto& message: messages)
+                {
+                    compressor.compress(message, compressed);
+                    decompressor.uncompress(compressed, uncompressed);
+                }
+            });
+
+            ofLogNotice("ofApp::benchmarkDictionaries") << "Ratio: " << ofToString(double(bytes) / compressedBytes, 1) << ":1";
+        }
+    }
+}
+
+
+void ofApp::benchmarkParallelCompression(std::size_t size)
+{
+    ofxIO::ByteBuffer buffer;
+    buffer.reserve(size);
+
+    while (buffer.size() < size)
+    {
+        buffer.writeBytes("{\"id\":" + ofToString(int(ofRandom(100000))) + ",\"value\":" + ofToString(ofRandom(1)) + "}\n");
+    }
+
+    const std::string suffix = " " + ofToString(size / (1024 * 1024)) + " MB";
+
+    ofxIO::ByteBuffer compressed;
+    ofxIO::ByteBuffer uncompressed;
+
+    for (auto type: { ofxIO::Compression::GZIP,
+                      ofxIO::Compression::LZ4,
+                      ofxIO::Compression::BR })
+    {
+        const std::string name = ofxIO::Compression::toString(type);
+
+        // Brotli's default quality is too slow for a benchmark of this size.
+        const int level = type == ofxIO::Compression::BR ? 5 : ofxIO::Compressor::defaultLevel(type);
+
+        for (std::size_t numThreads: { 1, 2, 4, 8 })
+        {
+            ofxIO::ParallelCompression::Settings settings;
+            settings.numThreads = numThreads;
+
+            const std::string label = name + " " + ofToString(numThreads) + " threads" + suffix;
+
+            run(label + " compress", buffer.size(), [&]() {
+                ofxIO::ParallelCompression::compress(buffer, compressed, type, level, settings);
+            });
+
+            run(label + " uncompress", buffer.size(), [&]() {
+                ofxIO::ParallelCompression::uncompress(compressed, uncompressed, type, settings);
+            });
+        }
+
+        ofLogNotice("ofApp::benchmarkParallelCompression") << name << " ratio: " << ofToString(double(buffer.size()) / compressed.size(), 1) << ":1";
+    }
+}
+
+
+void ofApp::run(const std::string& name,
+                std::size_t bytes,
+                std::function<void()> function)
+{
+    std::size_t iterations = std::max(std::size_t(1), BYTES_PER_BENCHMARK / bytes);
+
+    uint64_t start = ofGetElapsedTimeMicros();
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        function();
+    }
+
+    double seconds = (ofGetElapsedTimeMicros() - start) / 1000000.0;
+    double megabytesPerSecond = (bytes * iterations) / (1024.0 * 1024.0) / seconds;
+
+    ofLogNotice("ofApp::run") << name << ": " << ofToString(megabytesPerSecond, 1) << " MB/s";
+}
@@ -0,0 +1,122 @@
+//
+// Copyright (c) 2009 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include "ofMain.h"
+#include "ofxIO.h"
+
+
+class ofApp: public ofBaseApp
+{
+public:
+    void setup() override;
+    void draw() override;
+
+    /// \brief Compare stream throughput for a payload of the given size.
+    /// \param size The payload size in bytes.
+    void benchmarkStreams(std::size_t size);
+
+    /// \brief Count heap allocations per call for each encoder.
+    ///
+    /// Each encoder is run with a fresh output ByteBuffer and with an output
+    /// ByteBuffer recycled through a ByteBufferPool.
+    void benchmarkAllocations();
+
+    /// \brief Compare MappedFileBuffer with ByteBufferUtils::loadFromFile.
+    /// \param size The size of the test file in bytes.
+    void benchmarkMappedFile(std::size_t size);
+
+    /// \brief Compare stream and file descriptor file loading and saving.
+    /// \param size The size of the test file in bytes.
+    void benchmarkFiles(std::size_t size);
+
+    /// \brief Compare sequential and AsyncFileIO loading of many small files.
+    /// \param count The number of files.
+    /// \param size The size of each file in bytes.
+    void benchmarkAsyncFiles(std::size_t count, std::size_t size);
+
+    /// \brief Measure ByteBuffer remove, replace, translate, find and count.
+    /// \param size The buffer size in bytes.
+    void benchmarkByteOperations(std::size_t size);
+
+    /// \brief Measure Base64Encoding for each output variant.
+    /// \param size The payload size in bytes.
+    void benchmarkBase64(std::size_t size);
+
+    /// \brief Compare HexBinaryEncoding with Poco::HexBinaryEncoder.
+    /// \param size The payload size in bytes.
+    void benchmarkHexBinary(std::size_t size);
+
+    /// \brief Measure COBSStreamDecoder on one second of serial traffic.
+    /// \param framesPerSecond The number of frames in the stream.
+    /// \param frameSize The decoded size of each frame in bytes.
+    void benchmarkCOBSFrames(std::size_t framesPerSecond, std::size_t frameSize);
+
+    /// \brief Compare the byte loop and run-based COBS encoders on a
+    /// zero-free float payload, and measure COBS/R.
+    /// \param size The payload size in bytes.
+    void benchmarkCOBS(std::size_t size);
+
+    /// \brief Compare per-frame and batched SLIP encoding, and measure
+    /// SLIPStreamDecoder.
+    /// \param frameCount The number of frames.
+    /// \param frameSize The decoded size of each frame in bytes.
+    void benchmarkSLIPFrames(std::size_t frameCount, std::size_t frameSize);
+
+    /// \brief Compare Poco::URI and URIEncoding on short query parameter
+    /// values.
+    /// \param count The number of values.
+    void benchmarkURI(std::size_t count);
+
+    /// \brief Compare encoding through two codecs one after the other with a
+    /// CodecPipeline.
+    /// \param size The payload size in bytes.
+    void benchmarkPipeline(std::size_t size);
+
+    /// \brief Compare the Poco deflating streams and Compression on JSON
+    /// text and image pixels.
+    /// \param size The approximate size of each corpus in bytes.
+    void benchmarkZlib(std::size_t size);
+
+    /// \brief Measure LZ4 frames on slowly changing sensor samples.
+    /// \param size The payload size in bytes.
+    void benchmarkLZ4(std::size_t size);
+
+    /// \brief Compare LZ4HC levels, LZ4 accelerations and brotli qualities on
+    /// JSON text.
+    /// \param size The approximate payload size in bytes.
+    void benchmarkCompressionLevels(std::size_t size);
+
+    /// \brief Compare a new Compressor per message with a reused one on many
+    /// small JSON messages.
+    /// \param count The number of messages.
+    /// \param size The approximate size of each message in bytes.
+    void benchmarkCompressors(std::size_t count, std::size_t size);
+
+    /// \brief Compare the ratio and speed of small JSON messages with and
+    /// without a trained CompressionDictionary.
+    /// \param count The number of messages.
+    void benchmarkDictionaries(std::size_t count);
+
+    /// \brief Compare ParallelCompression on 1, 2, 4 and 8 threads.
+    /// \param size The number of bytes to compress.
+    void benchmarkParallelCompression(std::size_t size);
+
+    /// \brief Run a function repeatedly and report the throughput.
+    /// \param name The name of the benchmark.
+    /// \param bytes The number of bytes processed per iteration.
+    /// \param function The function to run.
+    static void run(const std::string& name,
+                    std::size_t bytes,
+                    std::function<void()> function);
+
+    /// \brief The approximate number of bytes processed by each benchmark.
+    static const std::size_t BYTES_PER_BENCHMARK;
+
+};
@@ -52,9 +52,10 @@ public:
             // Save the pixels to a buffer using PNG compression.
             ofSaveImage(pixelsToReceive, compressedPixels, OF_IMAGE_FORMAT_PNG);
 
-            // Encode the compressed pixels in base64.
+            // Encode the compressed pixels in base64. The ByteBufferView
+            // lets the encoder read the ofBuffer's bytes without a copy.
             ofxIO::ByteBuffer base64CompressedPixelsIn;
-            base64Encoder.encode(ofxIO::ByteBuffer(compressedPixels.getData(), compressedPixels.size()),
+            base64Encoder.encode(ofxIO::ByteBufferView(compressedPixels.getData(), compressedPixels.size()),
                                  base64CompressedPixelsIn);
 
 
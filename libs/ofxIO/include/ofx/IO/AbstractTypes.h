@@ -8,6 +8,7 @@
 #pragma once
 
 
+#include <memory>
 #include <stdint.h>
 #include <vector>
 #include <string>
@@ -21,6 +22,7 @@ namespace IO {
 class AbstractByteSink;
 class AbstractBufferedByteSource;
 class ByteBuffer;
+class ByteBufferView;
 
 
 /// \brief Represents the abstract notion of a byte source.
@@ -155,6 +157,41 @@ public:
 };
 
 
+/// \brief Represents the abstract notion of an incremental byte transform.
+///
+/// A transform receives its input in pieces of any size and appends its output
+/// as it goes, keeping only a small, bounded amount of state between calls.
+/// Stream encoders and decoders are transforms, so arbitrarily large inputs can
+/// be encoded or decoded without holding them in memory.
+class AbstractByteTransform
+{
+public:
+    /// \brief Destroys the byte transform.
+    virtual ~AbstractByteTransform()
+    {
+    }
+
+    /// \brief Transform the next piece of the input.
+    /// \param buffer is the next bytes of the input.
+    /// \param outputBuffer the buffer to append the transformed bytes to.
+    /// \returns the number of bytes appended to the output buffer.
+    virtual std::size_t update(const ByteBufferView& buffer,
+                               ByteBuffer& outputBuffer) = 0;
+
+    /// \brief Flush any remaining state at the end of the input.
+    ///
+    /// The transform is reset afterwards and can be used for a new input.
+    ///
+    /// \param outputBuffer the buffer to append the transformed bytes to.
+    /// \returns the number of bytes appended to the output buffer.
+    virtual std::size_t finish(ByteBuffer& outputBuffer) = 0;
+
+    /// \brief Discard any state and begin a new input.
+    virtual void reset() = 0;
+
+};
+
+
 /// \brief Represents the abstract notion of a byte encoder.
 ///
 /// Subclasses implementing this interface can a collection of bytes and return
@@ -174,6 +211,27 @@ public:
     virtual std::size_t encode(const ByteBuffer& buffer,
                                ByteBuffer& encodedBuffer) = 0;
 
+    /// \brief Encode the contents of a non-owning view.
+    ///
+    /// The default implementation copies the view into a ByteBuffer before
+    /// encoding. Subclasses should override this to encode in place.
+    ///
+    /// \param buffer is the view of the bytes to be encoded.
+    /// \param encodedBuffer the target buffer.
+    /// \returns the number of encoded bytes or 0 if error.
+    virtual std::size_t encode(const ByteBufferView& buffer,
+                               ByteBuffer& encodedBuffer);
+
+    /// \brief Create an incremental encoder with the current settings.
+    ///
+    /// The default implementation collects the whole input and encodes it in
+    /// AbstractByteTransform::finish(), so it needs as much memory as
+    /// encode(). Subclasses should override this to encode incrementally. The
+    /// default encoder refers to this encoder, which must outlive it.
+    ///
+    /// \returns a new stream encoder.
+    virtual std::unique_ptr<AbstractByteTransform> createStreamEncoder();
+
 };
 
 
@@ -195,7 +253,28 @@ public:
     /// \returns the number of decoded bytes or 0 if error.
     virtual std::size_t decode(const ByteBuffer& buffer,
                                ByteBuffer& decodedBuffer) = 0;
-                        
+
+    /// \brief Decode the contents of a non-owning view.
+    ///
+    /// The default implementation copies the view into a ByteBuffer before
+    /// decoding. Subclasses should override this to decode in place.
+    ///
+    /// \param buffer is the view of the bytes to be decoded.
+    /// \param decodedBuffer the target buffer.
+    /// \returns the number of decoded bytes or 0 if error.
+    virtual std::size_t decode(const ByteBufferView& buffer,
+                               ByteBuffer& decodedBuffer);
+
+    /// \brief Create an incremental decoder with the current settings.
+    ///
+    /// The default implementation collects the whole input and decodes it in
+    /// AbstractByteTransform::finish(), so it needs as much memory as
+    /// decode(). Subclasses should override this to decode incrementally. The
+    /// default decoder refers to this decoder, which must outlive it.
+    ///
+    /// \returns a new stream decoder.
+    virtual std::unique_ptr<AbstractByteTransform> createStreamDecoder();
+
 };
 
 
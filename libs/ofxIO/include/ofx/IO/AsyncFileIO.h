@@ -0,0 +1,186 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ofx/IO/ByteBuffer.h"
+#include "ofx/IO/ByteBufferUtils.h"
+#include "ofx/IO/ThreadChannel.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+/// \brief A single file read or write request for AsyncFileIO.
+struct AsyncFileRequest
+{
+    /// \brief The kind of file operation.
+    enum class Type
+    {
+        /// \brief Load the whole file into a ByteBuffer.
+        READ,
+        /// \brief Save a ByteBuffer as the file.
+        WRITE
+    };
+
+    /// \brief Create a read request.
+    /// \param path The path of the file to load.
+    /// \param flags A combination of ByteBufferUtils::FileFlags.
+    /// \returns the request.
+    static AsyncFileRequest read(const std::string& path,
+                                 int flags = ByteBufferUtils::FILE_DEFAULT);
+
+    /// \brief Create a write request.
+    /// \param path The path of the file to save.
+    /// \param buffer The bytes to save.
+    /// \param flags A combination of ByteBufferUtils::FileFlags.
+    /// \returns the request.
+    static AsyncFileRequest write(const std::string& path,
+                                  ByteBuffer buffer,
+                                  int flags = ByteBufferUtils::FILE_DEFAULT);
+
+    /// \brief The kind of file operation.
+    Type type = Type::READ;
+
+    /// \brief The path of the file.
+    std::string path;
+
+    /// \brief The bytes to write, unused for reads.
+    ByteBuffer buffer;
+
+    /// \brief A combination of ByteBufferUtils::FileFlags.
+    int flags = ByteBufferUtils::FILE_DEFAULT;
+
+};
+
+
+/// \brief The outcome of a single AsyncFileRequest.
+struct AsyncFileResult
+{
+    /// \returns true if the operation succeeded.
+    bool ok() const;
+
+    /// \brief The kind of file operation.
+    AsyncFileRequest::Type type = AsyncFileRequest::Type::READ;
+
+    /// \brief The path of the file.
+    std::string path;
+
+    /// \brief The loaded bytes for reads, the written bytes for writes.
+    ByteBuffer buffer;
+
+    /// \brief The errno value of the failure, or 0 on success.
+    int error = 0;
+
+    /// \brief A description of the failure, or empty on success.
+    std::string message;
+
+};
+
+
+/// \brief Load and save batches of files without blocking the caller.
+///
+/// Requests are completed in the background and their results delivered
+/// through std::future or a ThreadChannel. On Linux, requests are submitted
+/// through io_uring, so a single thread keeps many open, read, write and
+/// close operations in flight. Elsewhere, or if io_uring is unavailable, a
+/// pool of worker threads calls ByteBufferUtils::loadFromFileDescriptor() and
+/// ByteBufferUtils::saveToFileDescriptor().
+///
+/// The io_uring backend ignores ByteBufferUtils::FILE_DIRECT. If the ring
+/// stops accepting submissions, the requests in flight and all later ones
+/// fail with its errno and an empty buffer.
+///
+/// Pending requests are completed before the AsyncFileIO is destroyed.
+class AsyncFileIO
+{
+public:
+    /// \brief The implementation used to complete requests.
+    enum class Backend
+    {
+        /// \brief Use io_uring if available, otherwise a thread pool.
+        AUTO,
+        /// \brief Use io_uring.
+        IO_URING,
+        /// \brief Use a pool of worker threads with blocking I/O.
+        THREAD_POOL
+    };
+
+    /// \brief Create an AsyncFileIO.
+    ///
+    /// If the requested backend is not available, the thread pool is used.
+    ///
+    /// \param backend The requested backend.
+    /// \param concurrency The io_uring queue depth or the number of worker
+    ///        threads. 0 selects a default for the backend.
+    AsyncFileIO(Backend backend = Backend::AUTO,
+                std::size_t concurrency = 0);
+
+    /// \brief Destroy the AsyncFileIO after completing pending requests.
+    ~AsyncFileIO();
+
+    AsyncFileIO(const AsyncFileIO&) = delete;
+    AsyncFileIO& operator = (const AsyncFileIO&) = delete;
+
+    /// \returns the backend in use.
+    Backend backend() const;
+
+    /// \brief Load a file.
+    /// \param path The path of the file to load.
+    /// \param flags A combination of ByteBufferUtils::FileFlags.
+    /// \returns a future for the result.
+    std::future<AsyncFileResult> read(const std::string& path,
+                                      int flags = ByteBufferUtils::FILE_DEFAULT);
+
+    /// \brief Save a file.
+    /// \param path The path of the file to save.
+    /// \param buffer The bytes to save.
+    /// \param flags A combination of ByteBufferUtils::FileFlags.
+    /// \returns a future for the result.
+    std::future<AsyncFileResult> write(const std::string& path,
+                                       ByteBuffer buffer,
+                                       int flags = ByteBufferUtils::FILE_DEFAULT);
+
+    /// \brief Submit a batch of requests.
+    /// \param requests The requests to submit.
+    /// \returns one future per request, in the same order.
+    std::vector<std::future<AsyncFileResult>> submit(std::vector<AsyncFileRequest> requests);
+
+    /// \brief Submit a batch of requests and send each result to a channel.
+    ///
+    /// Results are sent in completion order, not in submission order.
+    ///
+    /// \param requests The requests to submit.
+    /// \param channel The channel that receives the results. It must outlive
+    ///        the requests.
+    void submit(std::vector<AsyncFileRequest> requests,
+                ThreadChannel<AsyncFileResult>& channel);
+
+    enum
+    {
+        /// \brief The default number of requests in flight with io_uring.
+        DEFAULT_QUEUE_DEPTH = 256
+    };
+
+private:
+    class Job;
+    class Engine;
+    class ThreadPoolEngine;
+    class IOUringEngine;
+
+    std::unique_ptr<Engine> _engine;
+
+};
+
+
+} } // ofx::IO
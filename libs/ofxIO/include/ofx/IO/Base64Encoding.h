@@ -8,7 +8,9 @@
 #pragma once
 
 
+#include <stdint.h>
 #include "ofx/IO/AbstractTypes.h"
+#include "ofx/IO/ByteBufferView.h"
 
 
 namespace ofx {
@@ -16,6 +18,14 @@ namespace IO {
 
 
 /// \brief Encodes and decodes bytes using Base64 encoding.
+///
+/// Encoding and decoding are done natively in a single pass, using AVX2 or
+/// NEON where the CPU supports it and a table driven scalar codec otherwise.
+/// Chunked output breaks lines with `\r\n` after every 72 characters.
+///
+/// The decoder accepts both the standard and the URL safe alphabets, with or
+/// without padding, and skips whitespace and line breaks.
+///
 /// \sa http://en.wikipedia.org/wiki/Base64
 class Base64Encoding: public AbstractByteEncoderDecoder
 {
@@ -37,6 +47,16 @@ public:
     std::size_t decode(const ByteBuffer& buffer,
                        ByteBuffer& decodedBuffer) override;
 
+    std::size_t encode(const ByteBufferView& buffer,
+                       ByteBuffer& encodedBuffer) override;
+
+    std::size_t decode(const ByteBufferView& buffer,
+                       ByteBuffer& decodedBuffer) override;
+
+    std::unique_ptr<AbstractByteTransform> createStreamEncoder() override;
+
+    std::unique_ptr<AbstractByteTransform> createStreamDecoder() override;
+
     /// \brief A base64 encoder for strings.
     /// \param buffer The UTF8 encoded string to be encoded.
     /// \param isUrlSafe Make URL safe by replacing `+` with `-` and `/` with `_`.
@@ -54,22 +74,68 @@ public:
     /// \param isChunked Will wrap encoded output by adding line breaks.
     /// \param isPadded Pad the output with = to align to byte boundaries.
     /// \returns a base64 encoded UTF-8 std::string.
-    static std::string encode(const ByteBuffer& buffer,
+    static std::string encode(const ByteBufferView& buffer,
                               bool isUrlSafe = false,
                               bool isChunked = false,
                               bool isPadded = false);
 
     /// \brief A base64 decoder for strings.
     ///
-    /// Will pad with `=` if needed and remove chunking.
+    /// Padding is optional and chunking is removed.
     ///
     /// \param buffer The string to decoded.
-    /// \param isUrlSafe Decode URL safe by replacing `-` with `+` and `_` with `/`.
+    /// \param isUrlSafe Unused, both alphabets are always accepted.
     /// \returns a base64 decoded UTF-8 std::string.
     static std::string decode(const std::string& buffer,
                               bool isUrlSafe = false);
 
 
+    /// \brief Encode a byte buffer with the Base64 encoder.
+    /// \param buffer The buffer to encode.
+    /// \param size The size of the buffer to encode.
+    /// \param encodedBuffer The target buffer for the encoded bytes.
+    /// \param isUrlSafe Use `-` and `_` in place of `+` and `/`.
+    /// \param isChunked Break lines with `\r\n` every 72 characters.
+    /// \param isPadded Pad the output with = to align to byte boundaries.
+    /// \returns The number of bytes in the encoded buffer.
+    /// \warning encodedBuffer must have a minimum capacity of
+    ///     encodedSize(size, isChunked, isPadded).
+    static std::size_t encode(const uint8_t* buffer,
+                              std::size_t size,
+                              uint8_t* encodedBuffer,
+                              bool isUrlSafe = false,
+                              bool isChunked = false,
+                              bool isPadded = false);
+
+    /// \brief Decode a Base64-encoded buffer.
+    ///
+    /// Decoding stops at the first `=` or at the first character that is not
+    /// part of either Base64 alphabet or whitespace.
+    ///
+    /// \param buffer The Base64-encoded buffer to decode.
+    /// \param size The size of the Base64-encoded buffer.
+    /// \param decodedBuffer The target buffer for the decoded bytes.
+    /// \returns The number of bytes in the decoded buffer.
+    /// \warning decodedBuffer must have a minimum capacity of
+    ///     maximumDecodedSize(size).
+    static std::size_t decode(const uint8_t* buffer,
+                              std::size_t size,
+                              uint8_t* decodedBuffer);
+
+    /// \brief Calculate the exact size of an encoded buffer.
+    /// \param size The number of bytes to encode.
+    /// \param isChunked True if the output is chunked.
+    /// \param isPadded True if the output is padded.
+    /// \returns the number of encoded bytes.
+    static std::size_t encodedSize(std::size_t size,
+                                   bool isChunked = false,
+                                   bool isPadded = false);
+
+    /// \brief Calculate the largest possible size of a decoded buffer.
+    /// \param size The number of encoded bytes.
+    /// \returns the maximum number of decoded bytes.
+    static std::size_t maximumDecodedSize(std::size_t size);
+
     /// \returns true if the en/decoding is URL safe.
     bool isUrlSafe() const;
 
@@ -8,6 +8,7 @@
 #pragma once
 
 
+#include <array>
 #include <vector>
 #include <string>
 #include <sstream>
@@ -16,6 +17,7 @@
 #include "ofConstants.h"
 #include "ofx/IO/AbstractTypes.h"
 #include "ofx/IO/ByteBufferUtils.h"
+#include "ofx/IO/ByteSet.h"
 
 
 namespace ofx {
@@ -58,6 +60,13 @@ public:
     /// \param buffer is a vector of bytes.
     explicit ByteBuffer(const std::vector<uint8_t>& buffer);
 
+    /// \brief Construct a ByteBuffer by adopting a byte vector's storage.
+    ///
+    /// No bytes are copied.
+    ///
+    /// \param buffer is a vector of bytes to be moved into the ByteBuffer.
+    explicit ByteBuffer(std::vector<uint8_t>&& buffer);
+
     /// \brief Construct a ByteBuffer from a string.
     /// \param buffer will be interpreted as raw bytes.
     explicit ByteBuffer(const std::string& buffer);
@@ -72,9 +81,27 @@ public:
     explicit ByteBuffer(std::istream& istr,
                         std::size_t bufferSize = ByteBufferUtils::DEFAULT_BUFFER_SIZE);
 
+    /// \brief Copy a ByteBuffer.
+    /// \param buffer The ByteBuffer to copy.
+    ByteBuffer(const ByteBuffer& buffer) = default;
+
+    /// \brief Move a ByteBuffer, taking its storage without copying.
+    /// \param buffer The ByteBuffer to move.
+    ByteBuffer(ByteBuffer&& buffer) = default;
+
     /// \brief Destroy the ByteBuffer.
     virtual ~ByteBuffer() override;
 
+    /// \brief Copy assign a ByteBuffer.
+    /// \param buffer The ByteBuffer to copy.
+    /// \returns a reference to this ByteBuffer.
+    ByteBuffer& operator = (const ByteBuffer& buffer) = default;
+
+    /// \brief Move assign a ByteBuffer, taking its storage without copying.
+    /// \param buffer The ByteBuffer to move.
+    /// \returns a reference to this ByteBuffer.
+    ByteBuffer& operator = (ByteBuffer&& buffer) = default;
+
     virtual std::size_t readBytes(uint8_t* buffer, std::size_t size) const override;
     virtual std::size_t readBytes(std::vector<uint8_t>& buffer) const override;
     virtual std::size_t readBytes(std::string& buffer) const override;
@@ -144,6 +171,21 @@ public:
     /// \returns a const reference to the backing data vector.
     const std::vector<uint8_t>& getBuffer() const;
 
+    /// \brief Release the backing data vector without copying.
+    ///
+    /// The ByteBuffer is empty after the call.
+    ///
+    /// \returns the backing data vector.
+    std::vector<uint8_t> release();
+
+    /// \brief Exchange the contents of two ByteBuffers without copying.
+    /// \param buffer The ByteBuffer to swap with.
+    void swap(ByteBuffer& buffer);
+
+    /// \brief Exchange the backing data vector with a byte vector without copying.
+    /// \param buffer The byte vector to swap with.
+    void swap(std::vector<uint8_t>& buffer);
+
     /// \brief Get a const pointer to the backing unsigned char data vector.
     /// \returns a const pointer to the backing data vector.
     const uint8_t* getPtr() const;
@@ -201,11 +243,48 @@ public:
     /// \param data The byte to remove.
     void remove(uint8_t data);
 
+    /// \brief Remove all instances of any of the given bytes in one pass.
+    /// \param bytes The bytes to remove.
+    void remove(const ByteSet& bytes);
+
     /// \brief Replace all instances of the given byte \p data with \p replacement.
     /// \param data The byte to replace.
     /// \param replacement The byte to use during replacement.
     void replace(uint8_t data, uint8_t replacement);
 
+    /// \brief Map every byte through a translation table in one pass.
+    ///
+    /// Tables that change only a few byte values, e.g. an alphabet swap, are
+    /// applied with SIMD compares and blends.
+    ///
+    /// \param table The replacement for each byte value.
+    void translate(const std::array<uint8_t, 256>& table);
+
+    /// \brief Find the first instance of a byte.
+    /// \param data The byte to find.
+    /// \param offset The index to start searching from.
+    /// \returns the index of the byte or std::string::npos if not found.
+    std::size_t find(uint8_t data, std::size_t offset = 0) const;
+
+    /// \brief Find the first instance of any of the given bytes.
+    /// \param bytes The bytes to find.
+    /// \param offset The index to start searching from.
+    /// \returns the index of the byte or std::string::npos if not found.
+    std::size_t find(const ByteSet& bytes, std::size_t offset = 0) const;
+
+    /// \brief Count the instances of a byte.
+    /// \param data The byte to count.
+    /// \returns the number of instances.
+    std::size_t count(uint8_t data) const;
+
+    /// \brief Count the instances of any of the given bytes.
+    /// \param bytes The bytes to count.
+    /// \returns the number of instances.
+    std::size_t count(const ByteSet& bytes) const;
+
+    /// \returns a translation table that maps each byte to itself.
+    static std::array<uint8_t, 256> identityTable();
+
     /// \brief Write the buffer to an output stream.
     /// \param ostr The std::ostream to write to.
     /// \param byteBuffer the ByteBuffer to write.
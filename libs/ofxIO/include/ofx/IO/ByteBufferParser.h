@@ -8,91 +8,344 @@
 #pragma once
 
 
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
 #include <type_traits>
-#include "ofx/IO/ByteBuffer.h"
+#include <vector>
+#include "ofx/IO/ByteBufferView.h"
+#include "ofx/IO/ByteOrder.h"
 
 
 namespace ofx {
 namespace IO {
 
 
-/// \brief A utility for reading variable types from a raw byte buffer.
-class ByteBufferReader
+/// \brief Describes a single field of a fixed size binary record.
+///
+/// ~~~~{.cpp}
+/// typedef RecordField<uint32_t, 0, ByteOrder::BIG> Timestamp;
+/// typedef RecordField<float, 4, ByteOrder::LITTLE> Temperature;
+/// ~~~~
+///
+/// \tparam Type An arithmetic or enum type of 1, 2, 4 or 8 bytes.
+/// \tparam Offset The byte offset of the field within the record.
+/// \tparam Order The byte order of the stored field.
+template <typename Type, std::size_t Offset, ByteOrder Order = ByteOrder::NATIVE>
+struct RecordField
 {
-public:
-    /// \brief Create a ByteBufferReader from a byte buffer.
-    /// \param buffer The ByteBuffer to read from.
-    /// \param The byte offset.
-    ByteBufferReader(const ByteBuffer& buffer, std::size_t offset = 0);
-
-    /// \brief Read a value from the ByteBuffer.
-    /// \tparam Type the type to read from the ByteBuffer.
-    /// \param value A reference to the value to read.
-    /// \returns std::size_t the number of bytes read.
-    template <typename Type>
-    std::size_t read(Type& value) const;
-
-    /// \brief Read an array of values from the ByteBuffer.
-    /// \tparam Type the type to read from the ByteBuffer.
-    /// \param value A reference to the values to read.
-    /// \param size The number of bytes to read into the array.
-    /// \returns std::size_t the number of bytes read.
-    template <typename Type>
-    std::size_t read(Type* destination, std::size_t size) const;
-
-    /// \brief Set the offset in the ByteBuffer.
-    /// \param offset The byte offset.
-    void setOffset(std::size_t offset);
-
-    /// \brief Set the number of bytes to skip.
-    /// \param offset The number of bytes to skip.
-    void skip(std::size_t offset);
-
-    /// \brief Get the current offset.
-    /// \returns the current offset.
-    std::size_t getOffset() const;
-
-    /// \brief Get the size of the ByteBuffer.
-    /// \returns the size of the ByteBuffer.
-    std::size_t size() const;
-
-    /// \brief Get the number of bytes remaining to read in the ByteBuffer.
-    /// \returns the number of bytes remaining to read in the ByteBuffer.
-    std::size_t remaining() const;
+    static_assert(std::is_arithmetic<Type>::value || std::is_enum<Type>::value,
+                  "Type must be arithmetic or an enum.");
 
-private:
-    ByteBufferReader(const ByteBufferReader& that);
-    ByteBufferReader& operator = (const ByteBufferReader& that);
+    /// \brief The type of the field value.
+    typedef Type ValueType;
+
+    /// \brief The byte offset of the field within the record.
+    static constexpr std::size_t OFFSET = Offset;
+
+    /// \brief The size of the field in bytes.
+    static constexpr std::size_t SIZE = sizeof(Type);
 
-    /// \brief An Internal function for reading bytes.
-    /// \param destination The destination to be filled.
-    /// \param size the number of bytes to read.
-    /// \returns the number of bytes read.
-    std::size_t _read(void* destination, std::size_t size) const;
+    /// \brief The byte order of the stored field.
+    static constexpr ByteOrder ORDER = Order;
 
-    /// \brief A reference to the ByteBuffer being read.
-    const ByteBuffer& _buffer;
+    /// \brief Read the field from a record.
+    /// \param record A pointer to the first byte of the record.
+    /// \returns the field value in native byte order.
+    static Type read(const uint8_t* record)
+    {
+        Type value;
+        std::memcpy(&value, record + Offset, sizeof(Type));
+        return ByteOrderUtils::convert(value, Order);
+    }
 
-    /// \brief The current offset.
-    mutable std::size_t _offset;
+    /// \brief Write the field into a record.
+    /// \param record A pointer to the first byte of the record.
+    /// \param value The field value in native byte order.
+    static void write(uint8_t* record, Type value)
+    {
+        value = ByteOrderUtils::convert(value, Order);
+        std::memcpy(record + Offset, &value, sizeof(Type));
+    }
 
 };
 
 
-template <typename Type>
-std::size_t ByteBufferReader::read(Type& value) const
+/// \brief Describes the layout of a fixed size binary record.
+///
+/// ~~~~{.cpp}
+/// typedef RecordLayout<16, Timestamp, Temperature> SensorRecord;
+/// ~~~~
+///
+/// \tparam Size The size of one record in bytes, including any padding.
+/// \tparam Fields The RecordField types of the record.
+template <std::size_t Size, typename... Fields>
+struct RecordLayout
 {
-    static_assert(std::is_pod<Type>::value, "Type must be POD.");
-    return _read(&value, sizeof(Type));
-}
+    /// \brief The size of one record in bytes.
+    static constexpr std::size_t SIZE = Size;
+
+    /// \returns the end of the furthest field from the record start.
+    static constexpr std::size_t fieldsEnd()
+    {
+        std::size_t ends[] = { 0, (Fields::OFFSET + Fields::SIZE)... };
+        std::size_t end = 0;
+
+        for (std::size_t e: ends)
+        {
+            if (e > end) end = e;
+        }
+
+        return end;
+    }
+
+    static_assert(Size > 0, "Record size must be greater than zero.");
+    static_assert(fieldsEnd() <= Size, "A field extends past the end of the record.");
 
+    /// \brief Test whether a field belongs to this layout.
+    template <typename Field>
+    static constexpr bool contains()
+    {
+        bool matches[] = { false, std::is_same<Field, Fields>::value... };
 
-template <typename Type>
-std::size_t ByteBufferReader::read(Type* destination, std::size_t size) const
+        for (bool match: matches)
+        {
+            if (match) return true;
+        }
+
+        return false;
+    }
+
+};
+
+
+/// \brief A read-only view of a single record in a buffer.
+///
+/// Fields are decoded lazily, straight from the underlying bytes, when they
+/// are accessed.
+///
+/// \tparam Layout The RecordLayout of the record.
+template <typename Layout>
+class RecordView
 {
-    static_assert(std::is_pod<Type>::value, "Type must be POD.");
-    return _read(destination, sizeof(Type) * size);
-}
+public:
+    /// \brief Create a RecordView.
+    /// \param data A pointer to the first byte of the record.
+    explicit RecordView(const uint8_t* data): _data(data)
+    {
+    }
+
+    /// \brief Read a field.
+    /// \tparam Field A RecordField of the Layout.
+    /// \returns the field value in native byte order.
+    template <typename Field>
+    typename Field::ValueType get() const
+    {
+        static_assert(Layout::template contains<Field>(), "Field is not part of the record layout.");
+        return Field::read(_data);
+    }
+
+    /// \returns the raw bytes of the record.
+    ByteBufferView view() const
+    {
+        return ByteBufferView(_data, Layout::SIZE);
+    }
+
+    /// \returns a pointer to the first byte of the record.
+    const uint8_t* data() const
+    {
+        return _data;
+    }
+
+    /// \returns the size of the record in bytes.
+    static constexpr std::size_t size()
+    {
+        return Layout::SIZE;
+    }
+
+private:
+    /// \brief A pointer to the first byte of the record.
+    const uint8_t* _data = nullptr;
+
+};
+
+
+/// \brief A zero-copy parser for arrays of fixed size binary records.
+///
+/// The parser does not copy or decode the buffer up front. Records are
+/// addressed by index or iterated, and each field is decoded only when it is
+/// read. The buffer must outlive the parser.
+///
+/// ~~~~{.cpp}
+/// ByteBufferParser<SensorRecord> records(buffer);
+///
+/// for (auto record: records)
+/// {
+///     uint32_t timestamp = record.get<Timestamp>();
+/// }
+/// ~~~~
+///
+/// \tparam Layout The RecordLayout of each record.
+template <typename Layout>
+class ByteBufferParser
+{
+public:
+    /// \brief The record type.
+    typedef RecordView<Layout> Record;
+
+    /// \brief A random access iterator over the records.
+    class Iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef Record value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Record* pointer;
+        typedef Record reference;
+
+        Iterator()
+        {
+        }
+
+        explicit Iterator(const uint8_t* data): _data(data)
+        {
+        }
+
+        Record operator * () const { return Record(_data); }
+        Record operator [] (difference_type n) const { return Record(_data + n * difference_type(Layout::SIZE)); }
+
+        Iterator& operator ++ () { _data += Layout::SIZE; return *this; }
+        Iterator operator ++ (int) { Iterator i(*this); ++*this; return i; }
+        Iterator& operator -- () { _data -= Layout::SIZE; return *this; }
+        Iterator operator -- (int) { Iterator i(*this); --*this; return i; }
+
+        Iterator& operator += (difference_type n) { _data += n * difference_type(Layout::SIZE); return *this; }
+        Iterator& operator -= (difference_type n) { _data -= n * difference_type(Layout::SIZE); return *this; }
+        Iterator operator + (difference_type n) const { Iterator i(*this); return i += n; }
+        Iterator operator - (difference_type n) const { Iterator i(*this); return i -= n; }
+        difference_type operator - (const Iterator& other) const { return (_data - other._data) / difference_type(Layout::SIZE); }
+
+        bool operator == (const Iterator& other) const { return _data == other._data; }
+        bool operator != (const Iterator& other) const { return _data != other._data; }
+        bool operator < (const Iterator& other) const { return _data < other._data; }
+        bool operator > (const Iterator& other) const { return _data > other._data; }
+        bool operator <= (const Iterator& other) const { return _data <= other._data; }
+        bool operator >= (const Iterator& other) const { return _data >= other._data; }
+
+    private:
+        const uint8_t* _data = nullptr;
+
+    };
+
+    /// \brief Create a ByteBufferParser.
+    ///
+    /// Trailing bytes that do not form a whole record are ignored, see
+    /// remainder().
+    ///
+    /// \param buffer The records to parse.
+    explicit ByteBufferParser(const ByteBufferView& buffer):
+        _buffer(buffer),
+        _size(buffer.size() / Layout::SIZE)
+    {
+    }
+
+    /// \returns the number of whole records.
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    /// \returns true if there are no whole records.
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    /// \returns the number of trailing bytes that do not form a record.
+    std::size_t remainder() const
+    {
+        return _buffer.size() - _size * Layout::SIZE;
+    }
+
+    /// \brief Get a record without bounds checking.
+    /// \param index The record index.
+    /// \returns the record.
+    Record operator [] (std::size_t index) const
+    {
+        return Record(_buffer.getPtr() + index * Layout::SIZE);
+    }
+
+    /// \brief Get a record.
+    /// \param index The record index.
+    /// \returns the record.
+    /// \throws std::out_of_range if index >= size().
+    Record at(std::size_t index) const
+    {
+        if (index >= _size)
+        {
+            throw std::out_of_range("ByteBufferParser::at: index out of range.");
+        }
+
+        return (*this)[index];
+    }
+
+    /// \brief Decode one field of every record.
+    ///
+    /// This reads the field with a fixed stride and converts the byte order in
+    /// a single tight loop, which is faster than reading records one value at
+    /// a time.
+    ///
+    /// \tparam Field A RecordField of the Layout.
+    /// \param values The decoded values, one per record.
+    template <typename Field>
+    void column(std::vector<typename Field::ValueType>& values) const
+    {
+        static_assert(Layout::template contains<Field>(), "Field is not part of the record layout.");
+
+        values.resize(_size);
+
+        const uint8_t* data = _buffer.getPtr();
+        typename Field::ValueType* out = values.data();
+
+        for (std::size_t i = 0; i < _size; ++i, data += Layout::SIZE)
+        {
+            out[i] = Field::read(data);
+        }
+    }
+
+    /// \returns an iterator to the first record.
+    Iterator begin() const
+    {
+        return Iterator(_buffer.getPtr());
+    }
+
+    /// \returns an iterator past the last whole record.
+    Iterator end() const
+    {
+        return Iterator(_buffer.getPtr() + _size * Layout::SIZE);
+    }
+
+private:
+    /// \brief The records.
+    ByteBufferView _buffer;
+
+    /// \brief The number of whole records.
+    std::size_t _size = 0;
+
+};
+
+
+template <typename Type, std::size_t Offset, ByteOrder Order>
+constexpr std::size_t RecordField<Type, Offset, Order>::OFFSET;
+
+template <typename Type, std::size_t Offset, ByteOrder Order>
+constexpr std::size_t RecordField<Type, Offset, Order>::SIZE;
+
+template <typename Type, std::size_t Offset, ByteOrder Order>
+constexpr ByteOrder RecordField<Type, Offset, Order>::ORDER;
+
+template <std::size_t Size, typename... Fields>
+constexpr std::size_t RecordLayout<Size, Fields...>::SIZE;
 
 
 } } // namespace ofx::IO
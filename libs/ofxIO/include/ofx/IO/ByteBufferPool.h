@@ -0,0 +1,129 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ofx/IO/ByteBuffer.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+/// \brief A size-class pool of reusable ByteBuffer storage.
+///
+/// Acquired ByteBuffers are empty but keep the capacity of storage that was
+/// previously recycled, so short-lived buffers can be created and destroyed
+/// without going to the heap each time. Storage is grouped in power-of-two
+/// size classes.
+///
+/// The pool keeps at most maximumCapacity() bytes. Storage recycled beyond
+/// that is freed, so one large buffer does not stay pinned for the life of
+/// the pool or, for threadLocal(), of the thread.
+///
+/// A ByteBufferPool is not thread-safe. Use threadLocal() to get a pool
+/// owned by the calling thread.
+///
+/// ~~~~{.cpp}
+/// ofxIO::ByteBufferPool& pool = ofxIO::ByteBufferPool::threadLocal();
+///
+/// ofxIO::ByteBuffer scratch = pool.acquire(1024);
+/// // ... use scratch ...
+/// pool.recycle(std::move(scratch));
+///
+/// // Later, e.g. at the end of a frame, free all pooled storage.
+/// pool.reset();
+/// ~~~~
+class ByteBufferPool
+{
+public:
+    /// \brief Create a ByteBufferPool.
+    /// \param maximumBuffersPerSizeClass The maximum number of buffers kept
+    ///        in each size class. Extra recycled buffers are freed.
+    ByteBufferPool(std::size_t maximumBuffersPerSizeClass = DEFAULT_MAXIMUM_BUFFERS_PER_SIZE_CLASS);
+
+    /// \brief Create a ByteBufferPool.
+    /// \param maximumBuffersPerSizeClass The maximum number of buffers kept
+    ///        in each size class. Extra recycled buffers are freed.
+    /// \param maximumCapacity The maximum total capacity in bytes kept by
+    ///        the pool. Recycled buffers that do not fit are freed.
+    ByteBufferPool(std::size_t maximumBuffersPerSizeClass,
+                   std::size_t maximumCapacity);
+
+    /// \brief Destroy the ByteBufferPool, freeing all pooled storage.
+    ~ByteBufferPool();
+
+    /// \brief Acquire an empty ByteBuffer.
+    /// \param capacity The minimum capacity of the returned ByteBuffer.
+    /// \returns an empty ByteBuffer with at least the given capacity.
+    ByteBuffer acquire(std::size_t capacity = 0);
+
+    /// \brief Return a ByteBuffer's storage to the pool.
+    /// \param buffer The ByteBuffer to recycle. It is empty after the call.
+    void recycle(ByteBuffer&& buffer);
+
+    /// \brief Free all pooled storage.
+    void reset();
+
+    /// \returns the number of buffers currently held by the pool.
+    std::size_t size() const;
+
+    /// \returns the total capacity in bytes currently held by the pool.
+    std::size_t capacity() const;
+
+    /// \returns the maximum total capacity in bytes kept by the pool.
+    std::size_t maximumCapacity() const;
+
+    /// \returns a pool owned by the calling thread.
+    static ByteBufferPool& threadLocal();
+
+    enum
+    {
+        /// \brief The default maximum number of buffers per size class.
+        DEFAULT_MAXIMUM_BUFFERS_PER_SIZE_CLASS = 16,
+
+        /// \brief The default maximum total capacity kept by a pool.
+        DEFAULT_MAXIMUM_CAPACITY = 64 * 1024 * 1024,
+
+        /// \brief The log2 of the smallest size class in bytes.
+        MINIMUM_SIZE_CLASS = 6,
+
+        /// \brief The number of size classes (the largest is 2 GB).
+        NUM_SIZE_CLASSES = 26
+    };
+
+private:
+    ByteBufferPool(const ByteBufferPool&) = delete;
+    ByteBufferPool& operator = (const ByteBufferPool&) = delete;
+
+    /// \param capacity The capacity to classify.
+    /// \returns the smallest size class that can hold the capacity.
+    static std::size_t _sizeClassFor(std::size_t capacity);
+
+    /// \brief The maximum number of buffers kept per size class.
+    std::size_t _maximumBuffersPerSizeClass = DEFAULT_MAXIMUM_BUFFERS_PER_SIZE_CLASS;
+
+    /// \brief The maximum total capacity kept by the pool.
+    std::size_t _maximumCapacity = DEFAULT_MAXIMUM_CAPACITY;
+
+    /// \brief The total capacity currently held by the pool.
+    std::size_t _capacity = 0;
+
+    /// \brief The pooled storage, indexed by size class.
+    ///
+    /// Every vector in _buffers[i] has a capacity of at least
+    /// 2 ^ (i + MINIMUM_SIZE_CLASS) bytes.
+    std::vector<std::vector<uint8_t>> _buffers[NUM_SIZE_CLASSES];
+
+};
+
+
+} } // namespace ofx::IO
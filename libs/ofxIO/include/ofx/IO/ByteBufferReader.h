@@ -8,8 +8,10 @@
 #pragma once
 
 
+#include <cstring>
 #include <type_traits>
 #include "ofx/IO/ByteBuffer.h"
+#include "ofx/IO/ByteOrder.h"
 
 
 namespace ofx {
@@ -32,14 +34,58 @@ public:
     template <typename Type>
     std::size_t read(Type& value) const;
 
+    /// \brief Read a value stored in the given byte order.
+    /// \tparam Type An arithmetic or enum type of 1, 2, 4 or 8 bytes.
+    /// \param value A reference to the value to read.
+    /// \param order The byte order of the stored value.
+    /// \returns std::size_t the number of bytes read.
+    template <typename Type>
+    std::size_t read(Type& value, ByteOrder order) const;
+
     /// \brief Read an array of values from the ByteBuffer.
     /// \tparam Type the type to read from the ByteBuffer.
-    /// \param value A reference to the values to read.
-    /// \param size The number of bytes to read into the array.
+    /// \param destination The array to fill.
+    /// \param size The number of values to read into the array.
     /// \returns std::size_t the number of bytes read.
     template <typename Type>
     std::size_t read(Type* destination, std::size_t size) const;
 
+    /// \brief Read an array of values stored in the given byte order.
+    ///
+    /// The values are copied in bulk and converted in place.
+    ///
+    /// \tparam Type An arithmetic or enum type of 1, 2, 4 or 8 bytes.
+    /// \param destination The array to fill.
+    /// \param size The number of values to read into the array.
+    /// \param order The byte order of the stored values.
+    /// \returns std::size_t the number of bytes read.
+    template <typename Type>
+    std::size_t read(Type* destination, std::size_t size, ByteOrder order) const;
+
+    /// \brief Read an unsigned LEB128 variable length integer.
+    ///
+    /// Nothing is consumed if the encoding is truncated or does not fit.
+    ///
+    /// \tparam Type An unsigned integer type.
+    /// \param value A reference to the value to read.
+    /// \returns std::size_t the number of bytes read, or 0 on error.
+    template <typename Type>
+    std::size_t readVarint(Type& value) const;
+
+    /// \brief Read a zigzag encoded signed LEB128 variable length integer.
+    /// \tparam Type A signed integer type.
+    /// \param value A reference to the value to read.
+    /// \returns std::size_t the number of bytes read, or 0 on error.
+    template <typename Type>
+    std::size_t readZigZag(Type& value) const;
+
+    /// \brief Decode a zigzag encoded integer.
+    /// \tparam Type A signed integer type.
+    /// \param value The zigzag encoded value.
+    /// \returns the decoded value.
+    template <typename Type>
+    static Type zigZagDecode(typename std::make_unsigned<Type>::type value);
+
     /// \brief Set the offset in the ByteBuffer.
     /// \param offset The byte offset.
     void setOffset(std::size_t offset);
@@ -79,6 +125,21 @@ private:
 };
 
 
+inline std::size_t ByteBufferReader::_read(void* destination, std::size_t size) const
+{
+    if (_offset <= _buffer.size() && size <= _buffer.size() - _offset)
+    {
+        std::memcpy(destination, _buffer.getPtr() + _offset, size);
+        _offset += size;
+        return size;
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+
 template <typename Type>
 std::size_t ByteBufferReader::read(Type& value) const
 {
@@ -87,6 +148,15 @@ std::size_t ByteBufferReader::read(Type& value) const
 }
 
 
+template <typename Type>
+std::size_t ByteBufferReader::read(Type& value, ByteOrder order) const
+{
+    std::size_t n = _read(&value, sizeof(Type));
+    if (n > 0) value = ByteOrderUtils::convert(value, order);
+    return n;
+}
+
+
 template <typename Type>
 std::size_t ByteBufferReader::read(Type* destination, std::size_t size) const
 {   
@@ -95,4 +165,76 @@ std::size_t ByteBufferReader::read(Type* destination, std::size_t size) const
 }
 
 
+template <typename Type>
+std::size_t ByteBufferReader::read(Type* destination, std::size_t size, ByteOrder order) const
+{
+    std::size_t n = _read(destination, sizeof(Type) * size);
+    if (n > 0) ByteOrderUtils::convert(destination, size, order);
+    return n;
+}
+
+
+template <typename Type>
+std::size_t ByteBufferReader::readVarint(Type& value) const
+{
+    static_assert(std::is_unsigned<Type>::value, "Type must be unsigned.");
+
+    if (_offset >= _buffer.size())
+    {
+        return 0;
+    }
+
+    const std::size_t bits = sizeof(Type) * 8;
+    const uint8_t* data = _buffer.getPtr() + _offset;
+    const std::size_t available = _buffer.size() - _offset;
+
+    Type result = 0;
+    std::size_t shift = 0;
+
+    for (std::size_t n = 0; n < available; ++n)
+    {
+        uint8_t byte = data[n];
+
+        // Reject encodings with payload bits beyond the width of Type.
+        if (shift >= bits || (shift + 7 > bits && ((byte & 0x7F) >> (bits - shift)) != 0))
+        {
+            return 0;
+        }
+
+        result |= static_cast<Type>(static_cast<Type>(byte & 0x7F) << shift);
+
+        if ((byte & 0x80) == 0)
+        {
+            value = result;
+            _offset += n + 1;
+            return n + 1;
+        }
+
+        shift += 7;
+    }
+
+    return 0;
+}
+
+
+template <typename Type>
+std::size_t ByteBufferReader::readZigZag(Type& value) const
+{
+    static_assert(std::is_signed<Type>::value, "Type must be signed.");
+
+    typename std::make_unsigned<Type>::type encoded = 0;
+    std::size_t n = readVarint(encoded);
+    if (n > 0) value = zigZagDecode<Type>(encoded);
+    return n;
+}
+
+
+template <typename Type>
+Type ByteBufferReader::zigZagDecode(typename std::make_unsigned<Type>::type value)
+{
+    typedef typename std::make_unsigned<Type>::type Unsigned;
+    return static_cast<Type>(static_cast<Unsigned>(value >> 1) ^ static_cast<Unsigned>(0 - (value & 1)));
+}
+
+
 } } // namespace ofx::IO
@@ -8,30 +8,52 @@
 #pragma once
 
 
+#include <istream>
 #include <ostream>
-#include <cctype>
-#include "Poco/UnbufferedStreamBuf.h"
+#include <streambuf>
+#include "Poco/StreamUtil.h"
 #include "ofx/IO/ByteBuffer.h"
-#include "ofx/IO/ByteBufferReader.h"
-#include "ofx/IO/ByteBufferWriter.h"
+#include "ofx/IO/ByteBufferView.h"
 
 
 namespace ofx {
 namespace IO {
 
 
-class ByteBufferInputStreamBuf: public Poco::UnbufferedStreamBuf
+/// \brief A std::streambuf that reads directly from a ByteBuffer.
+///
+/// The ByteBuffer's storage is used as the get area, so reads are bulk
+/// copies rather than one virtual call per byte. Any ByteBufferView can be
+/// read the same way. The viewed bytes must not be modified while they are
+/// being read.
+class ByteBufferInputStreamBuf: public std::streambuf
 {
 public:
-    ByteBufferInputStreamBuf(const ByteBuffer& buffer, std::size_t offset = 0);
+    /// \brief Create a ByteBufferInputStreamBuf.
+    /// \param buffer The bytes to read from.
+    /// \param offset The byte offset to begin reading from.
+    ByteBufferInputStreamBuf(const ByteBufferView& buffer, std::size_t offset = 0);
 
+    /// \brief Destroy the ByteBufferInputStreamBuf.
     virtual ~ByteBufferInputStreamBuf() override;
 
 protected:
-    int readFromDevice() override;
+    int_type underflow() override;
+
+    std::streamsize showmanyc() override;
+
+    std::streamsize xsgetn(char_type* s, std::streamsize n) override;
+
+    pos_type seekoff(off_type off,
+                     std::ios_base::seekdir dir,
+                     std::ios_base::openmode which = std::ios_base::in) override;
+
+    pos_type seekpos(pos_type pos,
+                     std::ios_base::openmode which = std::ios_base::in) override;
 
 private:
-    ByteBufferReader _bufferReader;
+    ByteBufferInputStreamBuf(const ByteBufferInputStreamBuf&) = delete;
+    ByteBufferInputStreamBuf& operator = (const ByteBufferInputStreamBuf&) = delete;
 
 };
 
@@ -39,7 +61,7 @@ private:
 class ByteBufferInputIOS: public virtual std::ios
 {
 public:
-    ByteBufferInputIOS(const ByteBuffer& buffer, std::size_t offset = 0):
+    ByteBufferInputIOS(const ByteBufferView& buffer, std::size_t offset = 0):
         _buf(buffer, offset)
     {
         poco_ios_init(&_buf);
@@ -54,7 +76,7 @@ protected:
 class ByteBufferInputStream: public ByteBufferInputIOS, public std::istream
 {
 public:
-    ByteBufferInputStream(const ByteBuffer& buffer, std::size_t offset = 0):
+    ByteBufferInputStream(const ByteBufferView& buffer, std::size_t offset = 0):
         ByteBufferInputIOS(buffer, offset),
         std::istream(&_buf)
     {
@@ -62,17 +84,31 @@ public:
 };
 
 
-class ByteBufferOutputStreamBuf: public Poco::UnbufferedStreamBuf
+/// \brief A std::streambuf that writes directly into a ByteBuffer.
+///
+/// Bytes are appended to the ByteBuffer as they are written, so its size is
+/// always the number of bytes written. Multi-byte writes are appended with a
+/// single bulk copy, and the ByteBuffer's storage grows geometrically.
+class ByteBufferOutputStreamBuf: public std::streambuf
 {
 public:
+    /// \brief Create a ByteBufferOutputStreamBuf.
+    /// \param buffer The ByteBuffer to append to.
     ByteBufferOutputStreamBuf(ByteBuffer& buffer);
 
-    virtual ~ByteBufferOutputStreamBuf();
+    /// \brief Destroy the ByteBufferOutputStreamBuf.
+    virtual ~ByteBufferOutputStreamBuf() override;
 
 protected:
-    int writeToDevice(char byte) override;
+    int_type overflow(int_type c) override;
+
+    std::streamsize xsputn(const char_type* s, std::streamsize n) override;
 
 private:
+    ByteBufferOutputStreamBuf(const ByteBufferOutputStreamBuf&) = delete;
+    ByteBufferOutputStreamBuf& operator = (const ByteBufferOutputStreamBuf&) = delete;
+
+    /// \brief A reference to the target buffer.
     ByteBuffer& _buffer;
 
 };
@@ -17,6 +17,7 @@ namespace IO {
 
 
 class ByteBuffer;
+class ByteChain;
 
 
 /// \brief Utilities for use with ByteBuffer.
@@ -71,6 +72,10 @@ public:
                                  std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
 
     /// \brief Copy an input stream to a ByteBuffer.
+    ///
+    /// If the stream is seekable, the remaining length is measured first and
+    /// the ByteBuffer is reserved once before copying.
+    ///
     /// \param istr The std::istream input stream.
     /// \param byteBuffer the target ByteBuffer.
     /// \param bufferSize The size of the buffer used during copy.
@@ -105,8 +110,36 @@ public:
                                         bool appendBuffer = false,
                                         std::ios::openmode openMode = std::ios::in);
 
+    /// \brief Load a ByteBuffer from a file using file descriptor I/O.
+    ///
+    /// Regular files are measured with fstat(), the ByteBuffer is reserved
+    /// exactly once and the contents are read with large read() calls. Other
+    /// files (pipes, devices) are read in chunks until the end of the file.
+    ///
+    /// If FILE_DIRECT is set and the file system supports it, the file is
+    /// opened with O_DIRECT and read through an aligned bounce buffer, so the
+    /// page cache is not polluted by large one-off loads.
+    ///
+    /// On systems without POSIX file descriptors this falls back to the
+    /// stream based loadFromFile() and FILE_DIRECT is ignored.
+    ///
+    /// \param path The absolute path of the file to load.
+    /// \param buffer the target ByteBuffer to fill.
+    /// \param appendBuffer false if the ByteBuffer should be cleared.
+    /// \param flags A combination of FileFlags.
+    /// \returns The total number of bytes loaded.
+    /// \throws A Poco::FileNotFoundException (or a similar exception) if the
+    ///         file does not exist or is not accessible for other reasons.
+    static std::streamsize loadFromFileDescriptor(const std::string& path,
+                                                  ByteBuffer& buffer,
+                                                  bool appendBuffer = false,
+                                                  int flags = FILE_DEFAULT);
 
     /// \brief Save a ByteBuffer as a file.
+    ///
+    /// On POSIX systems the std::ios::out, std::ios::trunc and std::ios::app
+    /// modes are written with the same fast path as saveToFileDescriptor().
+    ///
     /// \param buffer the target ByteBuffer to save.
     /// \param path The absolute path of the file to save.
     /// \param mode The std::ios::out is always set, regardless of the
@@ -118,6 +151,50 @@ public:
                            const std::string& path,
                            std::ios::openmode mode = std::ios::out | std::ios::trunc);
 
+    /// \brief Save a ByteBuffer as a file using file descriptor I/O.
+    ///
+    /// The file is truncated, unless FILE_APPEND is set, and written with a
+    /// single write() loop. If FILE_SYNC is set, the data is flushed to the
+    /// device with fdatasync() before returning.
+    ///
+    /// \param buffer the target ByteBuffer to save.
+    /// \param path The absolute path of the file to save.
+    /// \param flags A combination of FileFlags.
+    /// \returns True iff the file was saved successfully.
+    /// \throws A Poco::FileNotFoundException (or a similar exception) if the
+    ///         file is not accessible.
+    static bool saveToFileDescriptor(const ByteBuffer& buffer,
+                                     const std::string& path,
+                                     int flags = FILE_DEFAULT);
+
+    /// \brief Save a ByteChain as a file without joining its segments.
+    ///
+    /// The segments are written with writev(), so the chain does not need to
+    /// be copied into a contiguous ByteBuffer first.
+    ///
+    /// \param chain the ByteChain to save.
+    /// \param path The absolute path of the file to save.
+    /// \param flags A combination of FileFlags.
+    /// \returns True iff the file was saved successfully.
+    /// \throws A Poco::FileNotFoundException (or a similar exception) if the
+    ///         file is not accessible.
+    static bool saveToFileDescriptor(const ByteChain& chain,
+                                     const std::string& path,
+                                     int flags = FILE_DEFAULT);
+
+    /// \brief Flags for the file descriptor based load and save functions.
+    enum FileFlags
+    {
+        /// \brief Use buffered I/O through the page cache.
+        FILE_DEFAULT = 0,
+        /// \brief Bypass the page cache with O_DIRECT, if supported.
+        FILE_DIRECT = 1 << 0,
+        /// \brief Call fdatasync() before a save returns.
+        FILE_SYNC = 1 << 1,
+        /// \brief Append to the file instead of truncating it when saving.
+        FILE_APPEND = 1 << 2
+    };
+
     enum
     {
         /// \brief The default buffer size for use during buffered copies.
@@ -0,0 +1,129 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <string>
+#include <vector>
+#include <iterator>
+#include "ofx/IO/AbstractTypes.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+/// \brief A non-owning, read-only view of a contiguous range of bytes.
+///
+/// A ByteBufferView can be used anywhere a const ByteBuffer& is accepted by
+/// the encoders, Compression and Hash, so that existing memory (e.g. an
+/// ofBuffer, a memory-mapped region or a slice of a larger packet) can be
+/// processed without first copying it into a ByteBuffer.
+///
+/// The viewed memory must outlive the ByteBufferView.
+class ByteBufferView: public AbstractByteSource
+{
+public:
+    typedef const uint8_t* const_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    /// \brief Construct an empty ByteBufferView.
+    ByteBufferView();
+
+    /// \brief Construct a ByteBufferView of a byte array.
+    /// \param buffer is an array of bytes.
+    /// \param size is the number of bytes in the buffer.
+    ByteBufferView(const uint8_t* buffer, std::size_t size);
+
+    /// \brief Construct a ByteBufferView of a char array.
+    /// \param buffer is an array of bytes.
+    /// \param size is the number of bytes in the buffer.
+    ByteBufferView(const char* buffer, std::size_t size);
+
+    /// \brief Construct a ByteBufferView of a ByteBuffer.
+    /// \param buffer is the ByteBuffer to view.
+    ByteBufferView(const ByteBuffer& buffer);
+
+    /// \brief Construct a ByteBufferView of a byte vector.
+    /// \param buffer is the vector of bytes to view.
+    explicit ByteBufferView(const std::vector<uint8_t>& buffer);
+
+    /// \brief Construct a ByteBufferView of a string.
+    /// \param buffer will be interpreted as raw bytes.
+    explicit ByteBufferView(const std::string& buffer);
+
+    /// \brief Destroy the ByteBufferView.
+    virtual ~ByteBufferView() override;
+
+    virtual std::size_t readBytes(uint8_t* buffer, std::size_t size) const override;
+    virtual std::size_t readBytes(std::vector<uint8_t>& buffer) const override;
+    virtual std::size_t readBytes(std::string& buffer) const override;
+    virtual std::size_t readBytes(AbstractByteSink& buffer) const override;
+    virtual std::vector<uint8_t> readBytes() const override;
+
+    /// \brief Query the number of bytes in the ByteBufferView.
+    /// \returns the number of bytes in the ByteBufferView.
+    std::size_t size() const override;
+
+    /// \brief Determine if the ByteBufferView is empty.
+    /// \returns true iff the number of bytes in the ByteBufferView is 0.
+    bool empty() const;
+
+    /// \brief Create a view of a sub-range of this view.
+    ///
+    /// The range is clamped to the bounds of this view.
+    ///
+    /// \param offset The offset of the first byte in the sub-range.
+    /// \param size The maximum number of bytes in the sub-range.
+    /// \returns a ByteBufferView of the sub-range.
+    ByteBufferView slice(std::size_t offset,
+                         std::size_t size = std::string::npos) const;
+
+    /// \param n is the element index in the ByteBufferView.
+    ///
+    /// The value of n should not exceed size() - 1.
+    ///
+    /// \returns a copy of the byte at position n in the ByteBufferView.
+    uint8_t operator [] (std::size_t n) const;
+
+    /// \returns a const pointer to the viewed bytes.
+    const uint8_t* getPtr() const;
+
+    /// \returns a const pointer to the viewed bytes.
+    const char* getCharPtr() const;
+
+    /// \returns a const pointer to the viewed bytes.
+    const char* getData() const;
+
+    /// \brief get the ByteBufferView as a std::string with UTF-8 encoding.
+    /// \returns a copy of the viewed bytes as a std::string.
+    std::string toString() const;
+
+    /// \returns a const iterator to the first viewed byte.
+    const_iterator begin() const;
+
+    /// \returns a const end iterator to the viewed bytes.
+    const_iterator end() const;
+
+    /// \returns a const reverse iterator to the viewed bytes.
+    const_reverse_iterator rbegin() const;
+
+    /// \returns a const reverse end iterator to the viewed bytes.
+    const_reverse_iterator rend() const;
+
+private:
+    /// \brief A pointer to the first viewed byte.
+    const uint8_t* _data = nullptr;
+
+    /// \brief The number of viewed bytes.
+    std::size_t _size = 0;
+
+};
+
+
+} }  // namespace ofx::IO
@@ -8,8 +8,11 @@
 #pragma once
 
 
+#include <cassert>
+#include <cstring>
 #include <type_traits>
 #include "ofx/IO/ByteBuffer.h"
+#include "ofx/IO/ByteOrder.h"
 
 
 namespace ofx {
@@ -54,6 +57,80 @@ public:
     template <typename Type>
     std::size_t write(const Type* data, std::size_t size);
 
+    /// \brief Write a single value in the given byte order.
+    ///
+    /// Will return 0 on write error (e.g. no room available in the ByteBuffer).
+    ///
+    /// \param data The data to write.
+    /// \param order The byte order to store the value in.
+    /// \returns The number of bytes written.
+    /// \tparam Type An arithmetic or enum type of 1, 2, 4 or 8 bytes.
+    template <typename Type>
+    std::size_t write(const Type& data, ByteOrder order);
+
+    /// \brief Write a data array in the given byte order.
+    ///
+    /// The values are copied in bulk and converted in place.
+    ///
+    /// \param data The data array to write.
+    /// \param size The length of the array.
+    /// \param order The byte order to store the values in.
+    /// \returns The number of bytes written.
+    /// \tparam Type An arithmetic or enum type of 1, 2, 4 or 8 bytes.
+    template <typename Type>
+    std::size_t write(const Type* data, std::size_t size, ByteOrder order);
+
+    /// \brief Write an unsigned LEB128 variable length integer.
+    /// \param data The data to write.
+    /// \returns The number of bytes written, or 0 on write error.
+    /// \tparam Type An unsigned integer type.
+    template <typename Type>
+    std::size_t writeVarint(Type data);
+
+    /// \brief Write a zigzag encoded signed LEB128 variable length integer.
+    /// \param data The data to write.
+    /// \returns The number of bytes written, or 0 on write error.
+    /// \tparam Type A signed integer type.
+    template <typename Type>
+    std::size_t writeZigZag(Type data);
+
+    /// \brief Write a value without checking the available room.
+    ///
+    /// Call reserve() first with the total size of the values to be written.
+    /// Writing past the end of the ByteBuffer is undefined behavior.
+    ///
+    /// \param data The data to write.
+    /// \param order The byte order to store the value in.
+    /// \tparam Type An arithmetic or enum type of 1, 2, 4 or 8 bytes.
+    template <typename Type>
+    void writeUnchecked(const Type& data, ByteOrder order = ByteOrder::NATIVE);
+
+    /// \brief Make room for a number of bytes after the current offset.
+    ///
+    /// The ByteBuffer is resized at most once, so a sequence of fields can be
+    /// written without growing the buffer for each one. Call truncate() after
+    /// writing to drop any unused room.
+    ///
+    /// \param size The number of bytes to make room for.
+    /// \returns The number of bytes remaining.
+    std::size_t reserve(std::size_t size);
+
+    /// \brief Resize the ByteBuffer to end at the current write offset.
+    void truncate();
+
+    /// \brief Encode a signed integer with zigzag encoding.
+    /// \param value The value to encode.
+    /// \returns the encoded value.
+    /// \tparam Type A signed integer type.
+    template <typename Type>
+    static typename std::make_unsigned<Type>::type zigZagEncode(Type value);
+
+    enum
+    {
+        /// \brief The maximum size of an encoded 64-bit varint.
+        MAX_VARINT_SIZE = 10
+    };
+
     /// \brief Set the write offset to a given byte.
     ///
     /// Will set the offset past the end of the buffer.
@@ -89,6 +166,21 @@ private:
 };
 
 
+inline std::size_t ByteBufferWriter::_write(const void* source, std::size_t size)
+{
+    if (_offset <= _buffer.size() && size <= _buffer.size() - _offset)
+    {
+        std::memcpy(_buffer.getPtr() + _offset, source, size);
+        _offset += size;
+        return size;
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+
 template <typename Type>
 std::size_t ByteBufferWriter::write(const Type& data)
 {
@@ -105,4 +197,76 @@ std::size_t ByteBufferWriter::write(const Type* data, std::size_t size)
 }
 
 
+template <typename Type>
+std::size_t ByteBufferWriter::write(const Type& data, ByteOrder order)
+{
+    Type value = ByteOrderUtils::convert(data, order);
+    return _write(&value, sizeof(Type));
+}
+
+
+template <typename Type>
+std::size_t ByteBufferWriter::write(const Type* data, std::size_t size, ByteOrder order)
+{
+    std::size_t n = _write(data, sizeof(Type) * size);
+
+    if (n > 0 && order != ByteOrder::NATIVE)
+    {
+        // Convert the bytes that were just copied, they may be unaligned.
+        ByteOrderUtils::swap(_buffer.getPtr() + _offset - n, size, sizeof(Type));
+    }
+
+    return n;
+}
+
+
+template <typename Type>
+std::size_t ByteBufferWriter::writeVarint(Type data)
+{
+    static_assert(std::is_unsigned<Type>::value, "Type must be unsigned.");
+    static_assert(sizeof(Type) <= 8, "Type must be 64 bits or less.");
+
+    uint8_t bytes[MAX_VARINT_SIZE];
+    std::size_t n = 0;
+
+    do
+    {
+        uint8_t byte = static_cast<uint8_t>(data & 0x7F);
+        data = static_cast<Type>(data >> 7);
+        bytes[n++] = data ? (byte | 0x80) : byte;
+    }
+    while (data);
+
+    return _write(bytes, n);
+}
+
+
+template <typename Type>
+std::size_t ByteBufferWriter::writeZigZag(Type data)
+{
+    static_assert(std::is_signed<Type>::value, "Type must be signed.");
+    return writeVarint(zigZagEncode(data));
+}
+
+
+template <typename Type>
+void ByteBufferWriter::writeUnchecked(const Type& data, ByteOrder order)
+{
+    assert(_offset + sizeof(Type) <= _buffer.size());
+    Type value = ByteOrderUtils::convert(data, order);
+    std::memcpy(_buffer.getPtr() + _offset, &value, sizeof(Type));
+    _offset += sizeof(Type);
+}
+
+
+template <typename Type>
+typename std::make_unsigned<Type>::type ByteBufferWriter::zigZagEncode(Type value)
+{
+    typedef typename std::make_unsigned<Type>::type Unsigned;
+    // Arithmetic right shift smears the sign bit across all bits.
+    return static_cast<Unsigned>(static_cast<Unsigned>(static_cast<Unsigned>(value) << 1)
+                               ^ static_cast<Unsigned>(value >> (sizeof(Type) * 8 - 1)));
+}
+
+
 } } // namespace ofx::IO
@@ -0,0 +1,150 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ofConstants.h"
+#include "ofx/IO/AbstractTypes.h"
+#include "ofx/IO/ByteBuffer.h"
+#include "ofx/IO/ByteBufferView.h"
+
+
+#if !defined(TARGET_WIN32)
+#include <sys/uio.h>
+#endif
+
+
+namespace ofx {
+namespace IO {
+
+
+/// \brief A chain of shared, immutable byte segments.
+///
+/// A ByteChain represents a logical sequence of bytes that is stored as a
+/// list of segments. Each segment refers to a range of a shared, immutable
+/// ByteBuffer. Appending or prepending a ByteBuffer or another ByteChain
+/// does not copy any bytes, and neither does slicing. This makes it cheap to
+/// assemble messages from headers, payloads and trailers, e.g. before
+/// framing them with COBSEncoding or SLIPEncoding.
+///
+/// The bytes can be exported without copying as a list of ByteBufferViews
+/// or, on POSIX systems, as iovecs for scatter-gather I/O (e.g. writev()).
+class ByteChain: public AbstractByteSource
+{
+public:
+    /// \brief A range of a shared, immutable ByteBuffer.
+    struct Segment
+    {
+        /// \brief The shared buffer that holds the bytes.
+        std::shared_ptr<const ByteBuffer> buffer;
+
+        /// \brief The offset of the first byte in the buffer.
+        std::size_t offset = 0;
+
+        /// \brief The number of bytes in the segment.
+        std::size_t size = 0;
+
+        /// \returns a view of the bytes in the segment.
+        ByteBufferView view() const;
+    };
+
+    /// \brief Create an empty ByteChain.
+    ByteChain();
+
+    /// \brief Create a ByteChain that takes ownership of a ByteBuffer.
+    /// \param buffer The ByteBuffer to take. No bytes are copied.
+    explicit ByteChain(ByteBuffer&& buffer);
+
+    /// \brief Destroy the ByteChain.
+    virtual ~ByteChain() override;
+
+    virtual std::size_t readBytes(uint8_t* buffer, std::size_t size) const override;
+    virtual std::size_t readBytes(std::vector<uint8_t>& buffer) const override;
+    virtual std::size_t readBytes(std::string& buffer) const override;
+    virtual std::size_t readBytes(AbstractByteSink& buffer) const override;
+    virtual std::vector<uint8_t> readBytes() const override;
+
+    /// \returns the total number of bytes in the ByteChain.
+    std::size_t size() const override;
+
+    /// \returns true iff the ByteChain has no bytes.
+    bool empty() const;
+
+    /// \brief Remove all segments.
+    void clear();
+
+    /// \brief Append a ByteBuffer, taking ownership without copying.
+    /// \param buffer The ByteBuffer to append.
+    void append(ByteBuffer&& buffer);
+
+    /// \brief Append a copy of the given bytes as a new segment.
+    /// \param buffer The bytes to append.
+    void append(const ByteBufferView& buffer);
+
+    /// \brief Append the segments of another ByteChain without copying.
+    /// \param chain The ByteChain to append.
+    void append(const ByteChain& chain);
+
+    /// \brief Prepend a ByteBuffer, taking ownership without copying.
+    /// \param buffer The ByteBuffer to prepend.
+    void prepend(ByteBuffer&& buffer);
+
+    /// \brief Prepend a copy of the given bytes as a new segment.
+    /// \param buffer The bytes to prepend.
+    void prepend(const ByteBufferView& buffer);
+
+    /// \brief Prepend the segments of another ByteChain without copying.
+    /// \param chain The ByteChain to prepend.
+    void prepend(const ByteChain& chain);
+
+    /// \brief Create a ByteChain that shares a range of this chain's bytes.
+    ///
+    /// The range is clamped to the bounds of this ByteChain. No bytes are
+    /// copied.
+    ///
+    /// \param offset The offset of the first byte in the range.
+    /// \param size The maximum number of bytes in the range.
+    /// \returns the sliced ByteChain.
+    ByteChain slice(std::size_t offset,
+                    std::size_t size = std::string::npos) const;
+
+    /// \returns the segments in order.
+    const std::deque<Segment>& segments() const;
+
+    /// \returns a view of each segment, in order.
+    std::vector<ByteBufferView> views() const;
+
+    /// \brief Copy all bytes into a single contiguous ByteBuffer.
+    /// \returns the contiguous ByteBuffer.
+    ByteBuffer toByteBuffer() const;
+
+#if !defined(TARGET_WIN32)
+    /// \brief Describe the segments for scatter-gather I/O.
+    ///
+    /// The iovecs point into the shared buffers and remain valid while this
+    /// ByteChain (or a copy of it) is alive.
+    ///
+    /// \returns an iovec for each segment, in order.
+    std::vector<struct iovec> toIOVecs() const;
+#endif
+
+private:
+    /// \brief The segments in order.
+    std::deque<Segment> _segments;
+
+    /// \brief The total number of bytes in all segments.
+    std::size_t _size = 0;
+
+};
+
+
+} } // namespace ofx::IO
@@ -0,0 +1,232 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <cstring>
+#include <stdint.h>
+#include <type_traits>
+#include "Poco/Platform.h"
+
+
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#endif
+
+
+namespace ofx {
+namespace IO {
+
+
+/// \brief The order of the bytes in a multi-byte value.
+enum class ByteOrder
+{
+    /// \brief Least significant byte first.
+    LITTLE,
+    /// \brief Most significant byte first, also known as network byte order.
+    BIG,
+#if defined(POCO_ARCH_BIG_ENDIAN)
+    /// \brief The byte order of the host.
+    NATIVE = BIG
+#else
+    /// \brief The byte order of the host.
+    NATIVE = LITTLE
+#endif
+};
+
+
+/// \brief Utilities for converting between byte orders.
+///
+/// Scalar conversions are inline and compile to a single byte swap
+/// instruction. Array conversions use SSE2 or NEON where available.
+class ByteOrderUtils
+{
+public:
+    /// \brief Reverse the bytes of a value.
+    /// \tparam Type An arithmetic or enum type of 1, 2, 4 or 8 bytes.
+    /// \param value The value to swap.
+    /// \returns the value with its bytes reversed.
+    template <typename Type>
+    static Type swap(Type value);
+
+    /// \brief Convert a value between the native and the given byte order.
+    ///
+    /// The conversion is symmetric, so the same call converts to and from
+    /// the given byte order.
+    ///
+    /// \tparam Type An arithmetic or enum type of 1, 2, 4 or 8 bytes.
+    /// \param value The value to convert.
+    /// \param order The foreign byte order.
+    /// \returns the converted value.
+    template <typename Type>
+    static Type convert(Type value, ByteOrder order);
+
+    /// \brief Reverse the bytes of each value in an array in place.
+    /// \tparam Type An arithmetic or enum type of 1, 2, 4 or 8 bytes.
+    /// \param values The values to swap.
+    /// \param count The number of values.
+    template <typename Type>
+    static void swap(Type* values, std::size_t count);
+
+    /// \brief Convert an array in place between the native and given order.
+    /// \tparam Type An arithmetic or enum type of 1, 2, 4 or 8 bytes.
+    /// \param values The values to convert.
+    /// \param count The number of values.
+    /// \param order The foreign byte order.
+    template <typename Type>
+    static void convert(Type* values, std::size_t count, ByteOrder order);
+
+    /// \brief Reverse the bytes of each value of the given width in place.
+    ///
+    /// The data does not need to be aligned.
+    ///
+    /// \param data The values to swap.
+    /// \param count The number of values.
+    /// \param width The size of each value, 1, 2, 4 or 8 bytes.
+    static void swap(void* data, std::size_t count, std::size_t width);
+
+    /// \brief Reverse the bytes of each 16-bit value in place.
+    /// \param data The values to swap.
+    /// \param count The number of 16-bit values.
+    static void swap16(void* data, std::size_t count);
+
+    /// \brief Reverse the bytes of each 32-bit value in place.
+    /// \param data The values to swap.
+    /// \param count The number of 32-bit values.
+    static void swap32(void* data, std::size_t count);
+
+    /// \brief Reverse the bytes of each 64-bit value in place.
+    /// \param data The values to swap.
+    /// \param count The number of 64-bit values.
+    static void swap64(void* data, std::size_t count);
+
+    /// \brief Swap a 16-bit unsigned integer.
+    static uint16_t swap16(uint16_t value);
+
+    /// \brief Swap a 32-bit unsigned integer.
+    static uint32_t swap32(uint32_t value);
+
+    /// \brief Swap a 64-bit unsigned integer.
+    static uint64_t swap64(uint64_t value);
+
+private:
+    template <std::size_t Size>
+    struct Swapper;
+
+};
+
+
+template <>
+struct ByteOrderUtils::Swapper<1>
+{
+    typedef uint8_t Type;
+    static Type swap(Type value) { return value; }
+    static void swap(void*, std::size_t) { }
+};
+
+
+template <>
+struct ByteOrderUtils::Swapper<2>
+{
+    typedef uint16_t Type;
+    static Type swap(Type value) { return ByteOrderUtils::swap16(value); }
+    static void swap(void* data, std::size_t count) { ByteOrderUtils::swap16(data, count); }
+};
+
+
+template <>
+struct ByteOrderUtils::Swapper<4>
+{
+    typedef uint32_t Type;
+    static Type swap(Type value) { return ByteOrderUtils::swap32(value); }
+    static void swap(void* data, std::size_t count) { ByteOrderUtils::swap32(data, count); }
+};
+
+
+template <>
+struct ByteOrderUtils::Swapper<8>
+{
+    typedef uint64_t Type;
+    static Type swap(Type value) { return ByteOrderUtils::swap64(value); }
+    static void swap(void* data, std::size_t count) { ByteOrderUtils::swap64(data, count); }
+};
+
+
+inline uint16_t ByteOrderUtils::swap16(uint16_t value)
+{
+#if defined(_MSC_VER)
+    return _byteswap_ushort(value);
+#else
+    return __builtin_bswap16(value);
+#endif
+}
+
+
+inline uint32_t ByteOrderUtils::swap32(uint32_t value)
+{
+#if defined(_MSC_VER)
+    return _byteswap_ulong(value);
+#else
+    return __builtin_bswap32(value);
+#endif
+}
+
+
+inline uint64_t ByteOrderUtils::swap64(uint64_t value)
+{
+#if defined(_MSC_VER)
+    return _byteswap_uint64(value);
+#else
+    return __builtin_bswap64(value);
+#endif
+}
+
+
+template <typename Type>
+inline Type ByteOrderUtils::swap(Type value)
+{
+    static_assert(std::is_arithmetic<Type>::value || std::is_enum<Type>::value,
+                  "Type must be arithmetic or an enum.");
+
+    typedef Swapper<sizeof(Type)> S;
+    typename S::Type bits;
+    std::memcpy(&bits, &value, sizeof(Type));
+    bits = S::swap(bits);
+    std::memcpy(&value, &bits, sizeof(Type));
+    return value;
+}
+
+
+template <typename Type>
+inline Type ByteOrderUtils::convert(Type value, ByteOrder order)
+{
+    return order == ByteOrder::NATIVE ? value : swap(value);
+}
+
+
+template <typename Type>
+inline void ByteOrderUtils::swap(Type* values, std::size_t count)
+{
+    static_assert(std::is_arithmetic<Type>::value || std::is_enum<Type>::value,
+                  "Type must be arithmetic or an enum.");
+
+    Swapper<sizeof(Type)>::swap(values, count);
+}
+
+
+template <typename Type>
+inline void ByteOrderUtils::convert(Type* values, std::size_t count, ByteOrder order)
+{
+    if (order != ByteOrder::NATIVE)
+    {
+        swap(values, count);
+    }
+}
+
+
+} } // namespace ofx::IO
@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <initializer_list>
+#include <stdint.h>
+#include <string>
+
+
+namespace ofx {
+namespace IO {
+
+
+/// \brief A set of byte values, stored as a 256-bit bitmap.
+///
+/// Used by the ByteBuffer search, count and remove functions that match any
+/// of several bytes in one pass.
+class ByteSet
+{
+public:
+    /// \brief Create an empty ByteSet.
+    ByteSet()
+    {
+    }
+
+    /// \brief Create a ByteSet from a list of bytes.
+    /// \param bytes The bytes in the set.
+    ByteSet(std::initializer_list<uint8_t> bytes)
+    {
+        for (uint8_t byte: bytes) insert(byte);
+    }
+
+    /// \brief Create a ByteSet from the characters of a string.
+    /// \param bytes The bytes in the set.
+    explicit ByteSet(const std::string& bytes)
+    {
+        for (char byte: bytes) insert(static_cast<uint8_t>(byte));
+    }
+
+    /// \brief Add a byte to the set.
+    /// \param byte The byte to add.
+    void insert(uint8_t byte)
+    {
+        _bits[byte >> 6] |= uint64_t(1) << (byte & 63);
+    }
+
+    /// \brief Remove a byte from the set.
+    /// \param byte The byte to remove.
+    void erase(uint8_t byte)
+    {
+        _bits[byte >> 6] &= ~(uint64_t(1) << (byte & 63));
+    }
+
+    /// \returns true if the byte is in the set.
+    bool contains(uint8_t byte) const
+    {
+        return (_bits[byte >> 6] >> (byte & 63)) & 1;
+    }
+
+    /// \returns the number of bytes in the set.
+    std::size_t size() const
+    {
+        std::size_t n = 0;
+
+        for (uint64_t bits: _bits)
+        {
+            for (; bits; bits &= bits - 1) ++n;
+        }
+
+        return n;
+    }
+
+    /// \returns true if the set is empty.
+    bool empty() const
+    {
+        return (_bits[0] | _bits[1] | _bits[2] | _bits[3]) == 0;
+    }
+
+private:
+    /// \brief One bit per byte value.
+    uint64_t _bits[4] = { 0, 0, 0, 0 };
+
+};
+
+
+} } // namespace ofx::IO
@@ -0,0 +1,230 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include "Poco/StreamUtil.h"
+#include "ofx/IO/AbstractTypes.h"
+#include "ofx/IO/ByteBuffer.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+/// \brief A std::streambuf that reads a source stream through a transform.
+///
+/// The source is read and transformed one chunk at a time, so the whole
+/// payload is never held in memory. The transform is finished when the
+/// source is exhausted.
+///
+/// ~~~~{.cpp}
+/// std::unique_ptr<AbstractByteTransform> decoder = Base64Encoding().createStreamDecoder();
+/// ByteTransformInputStream decoded(file, *decoder);
+/// ~~~~
+class ByteTransformInputStreamBuf: public std::streambuf
+{
+public:
+    /// \brief Create a ByteTransformInputStreamBuf.
+    /// \param source The stream to read untransformed bytes from.
+    /// \param transform The transform to apply. It must outlive the buffer.
+    /// \param chunkSize The number of bytes to read from the source at once.
+    ByteTransformInputStreamBuf(std::istream& source,
+                                AbstractByteTransform& transform,
+                                std::size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    /// \brief Destroy the ByteTransformInputStreamBuf.
+    virtual ~ByteTransformInputStreamBuf() override;
+
+    /// \brief The default number of bytes read from the source at once.
+    enum
+    {
+        DEFAULT_CHUNK_SIZE = 64 * 1024
+    };
+
+protected:
+    int_type underflow() override;
+
+private:
+    ByteTransformInputStreamBuf(const ByteTransformInputStreamBuf&) = delete;
+    ByteTransformInputStreamBuf& operator = (const ByteTransformInputStreamBuf&) = delete;
+
+    /// \brief The source stream.
+    std::istream& _source;
+
+    /// \brief The transform.
+    AbstractByteTransform& _transform;
+
+    /// \brief The last chunk read from the source.
+    ByteBuffer _input;
+
+    /// \brief The transformed bytes, used as the get area.
+    ByteBuffer _output;
+
+    /// \brief True once the transform has been finished.
+    bool _isFinished = false;
+
+};
+
+
+class ByteTransformInputIOS: public virtual std::ios
+{
+public:
+    ByteTransformInputIOS(std::istream& source,
+                          AbstractByteTransform& transform,
+                          std::size_t chunkSize = ByteTransformInputStreamBuf::DEFAULT_CHUNK_SIZE):
+        _buf(source, transform, chunkSize)
+    {
+        poco_ios_init(&_buf);
+    }
+
+protected:
+    ByteTransformInputStreamBuf _buf;
+
+};
+
+
+/// \brief A std::istream that reads a source stream through a transform.
+class ByteTransformInputStream: public ByteTransformInputIOS, public std::istream
+{
+public:
+    ByteTransformInputStream(std::istream& source,
+                             AbstractByteTransform& transform,
+                             std::size_t chunkSize = ByteTransformInputStreamBuf::DEFAULT_CHUNK_SIZE):
+        ByteTransformInputIOS(source, transform, chunkSize),
+        std::istream(&_buf)
+    {
+    }
+};
+
+
+/// \brief A std::streambuf that writes to a sink stream through a transform.
+///
+/// Written bytes are collected into chunks, transformed and written to the
+/// sink, so the whole payload is never held in memory. sync() (e.g.
+/// std::ostream::flush()) transforms and writes everything collected so far.
+/// close() also finishes the transform, and is called on destruction.
+///
+/// ~~~~{.cpp}
+/// std::unique_ptr<AbstractByteTransform> encoder = Base64Encoding().createStreamEncoder();
+/// ByteTransformOutputStream encoded(file, *encoder);
+/// encoded << payload;
+/// encoded.close();
+/// ~~~~
+class ByteTransformOutputStreamBuf: public std::streambuf
+{
+public:
+    /// \brief Create a ByteTransformOutputStreamBuf.
+    /// \param sink The stream to write transformed bytes to.
+    /// \param transform The transform to apply. It must outlive the buffer.
+    /// \param chunkSize The number of bytes collected before transforming.
+    ByteTransformOutputStreamBuf(std::ostream& sink,
+                                 AbstractByteTransform& transform,
+                                 std::size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    /// \brief Destroy the ByteTransformOutputStreamBuf, closing it.
+    virtual ~ByteTransformOutputStreamBuf() override;
+
+    /// \brief Finish the transform and flush the sink.
+    ///
+    /// Nothing more can be written afterwards.
+    ///
+    /// \returns 0 on success or -1 if the sink failed.
+    int close();
+
+    /// \brief The default number of bytes collected before transforming.
+    enum
+    {
+        DEFAULT_CHUNK_SIZE = 64 * 1024
+    };
+
+protected:
+    int_type overflow(int_type c) override;
+
+    std::streamsize xsputn(const char_type* s, std::streamsize n) override;
+
+    int sync() override;
+
+private:
+    ByteTransformOutputStreamBuf(const ByteTransformOutputStreamBuf&) = delete;
+    ByteTransformOutputStreamBuf& operator = (const ByteTransformOutputStreamBuf&) = delete;
+
+    /// \brief Transform the collected bytes and write them to the sink.
+    /// \returns true if the sink is still good.
+    bool _flushInput();
+
+    /// \brief Transform bytes and write them to the sink.
+    /// \returns true if the sink is still good.
+    bool _write(const char* data, std::size_t size);
+
+    /// \brief Write the transformed bytes to the sink.
+    /// \returns true if the sink is still good.
+    bool _writeOutput();
+
+    /// \brief The sink stream.
+    std::ostream& _sink;
+
+    /// \brief The transform.
+    AbstractByteTransform& _transform;
+
+    /// \brief The collected bytes, used as the put area.
+    ByteBuffer _input;
+
+    /// \brief The transformed bytes.
+    ByteBuffer _output;
+
+    /// \brief True once the transform has been finished.
+    bool _isClosed = false;
+
+};
+
+
+class ByteTransformOutputIOS: public virtual std::ios
+{
+public:
+    ByteTransformOutputIOS(std::ostream& sink,
+                           AbstractByteTransform& transform,
+                           std::size_t chunkSize = ByteTransformOutputStreamBuf::DEFAULT_CHUNK_SIZE):
+        _buf(sink, transform, chunkSize)
+    {
+        poco_ios_init(&_buf);
+    }
+
+protected:
+    ByteTransformOutputStreamBuf _buf;
+
+};
+
+
+/// \brief A std::ostream that writes to a sink stream through a transform.
+class ByteTransformOutputStream: public ByteTransformOutputIOS, public std::ostream
+{
+public:
+    ByteTransformOutputStream(std::ostream& sink,
+                              AbstractByteTransform& transform,
+                              std::size_t chunkSize = ByteTransformOutputStreamBuf::DEFAULT_CHUNK_SIZE):
+        ByteTransformOutputIOS(sink, transform, chunkSize),
+        std::ostream(&_buf)
+    {
+    }
+
+    /// \brief Finish the transform and flush the sink.
+    void close()
+    {
+        if (_buf.close() != 0)
+        {
+            setstate(std::ios::badbit);
+        }
+    }
+};
+
+
+} } // namespace ofx::IO
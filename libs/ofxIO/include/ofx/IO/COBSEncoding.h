@@ -15,6 +15,7 @@
 #include <stdint.h>
 #include "ofx/IO/AbstractTypes.h"
 #include "ofx/IO/ByteBuffer.h"
+#include "ofx/IO/ByteBufferView.h"
 
 
 namespace ofx {
@@ -34,7 +35,17 @@ namespace IO {
 ///
 /// (via http://www.jacquesf.com/2011/03/consistent-overhead-byte-stuffing/)
 ///
+/// Runs of up to 254 bytes between delimiters are found with memchr() and
+/// copied whole.
+///
+/// The reduced variant, COBS/R, saves the final code byte when the final
+/// data byte is larger than the code it would replace, so small messages
+/// often have no overhead at all. A delimiter other than 0 may be chosen.
+/// It is removed from the data in the same way, and every code byte is
+/// XORed with it. A delimiter of 0 gives standard COBS.
+///
 /// \sa http://conferences.sigcomm.org/sigcomm/1997/papers/p062.pdf
+/// \sa https://pythonhosted.org/cobs/cobsr-intro.html
 /// \sa http://en.wikipedia.org/wiki/Consistent_Overhead_Byte_Stuffing
 /// \sa https://github.com/jacquesf/COBS-Consistent-Overhead-Byte-Stuffing
 /// \sa http://www.jacquesf.com/2011/03/consistent-overhead-byte-stuffing/
@@ -42,7 +53,9 @@ class COBSEncoding: public AbstractByteEncoderDecoder
 {
 public:
     /// \brief Create a COBSEncoding.
-    COBSEncoding();
+    /// \param isReduced Use COBS/R.
+    /// \param delimiter The byte value removed from the data.
+    COBSEncoding(bool isReduced = false, uint8_t delimiter = 0);
 
     /// \brief Destroy a COBSEncoding.
     virtual ~COBSEncoding() override;
@@ -53,27 +66,59 @@ public:
     std::size_t decode(const ByteBuffer& buffer,
                        ByteBuffer& decodedBuffer) override;
 
+    std::size_t encode(const ByteBufferView& buffer,
+                       ByteBuffer& encodedBuffer) override;
+
+    std::size_t decode(const ByteBufferView& buffer,
+                       ByteBuffer& decodedBuffer) override;
+
+    std::unique_ptr<AbstractByteTransform> createStreamEncoder() override;
+
+    std::unique_ptr<AbstractByteTransform> createStreamDecoder() override;
+
     /// \brief Encode a byte buffer with the COBS encoder.
     /// \param buffer The buffer to encode.
     /// \param size The size of the buffer to encode.
     /// \param encodedBuffer The target buffer for the encoded bytes.
+    /// \param isReduced Use COBS/R.
+    /// \param delimiter The byte value removed from the data.
     /// \returns The number of bytes in the encoded buffer.
     /// \warning encodedBuffer must have a minimum capacity of
     ///     (size + size / 254 + 1).
     static std::size_t encode(const uint8_t* buffer,
                               std::size_t size,
-                              uint8_t* encodedBuffer);
+                              uint8_t* encodedBuffer,
+                              bool isReduced = false,
+                              uint8_t delimiter = 0);
 
     /// \brief Decode a COBS-encoded buffer.
     /// \param buffer The COBS-encoded buffer to decode.
     /// \param size The size of the COBS-encoded buffer.
     /// \param decodedBuffer The target buffer for the decoded bytes.
-    /// \returns The number of bytes in the decoded buffer.
+    /// \param isReduced Decode COBS/R.
+    /// \param delimiter The byte value removed from the data.
+    /// \returns The number of bytes in the decoded buffer, or 0 if a block
+    ///     is cut short.
     /// \warning decodedBuffer must have a minimum capacity of
     ///     size.
     static std::size_t decode(const uint8_t* buffer,
                               std::size_t size,
-                              uint8_t* decodedBuffer);
+                              uint8_t* decodedBuffer,
+                              bool isReduced = false,
+                              uint8_t delimiter = 0);
+
+    /// \returns true if the encoding is COBS/R.
+    bool isReduced() const;
+
+    /// \returns the delimiter value.
+    uint8_t delimiter() const;
+
+private:
+    /// \brief True if the encoding is COBS/R.
+    bool _isReduced = false;
+
+    /// \brief The byte value removed from the data.
+    uint8_t _delimiter = 0;
 
 };
 
@@ -0,0 +1,215 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ofx/IO/ByteBufferView.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+/// \brief Splits a continuous stream of COBS frames and decodes them.
+///
+/// Bytes may be passed in chunks of any size, such as the reads from a
+/// serial port or socket. Frames end with a delimiter, 0x00 by default,
+/// which is found with memchr(). COBS/R and other delimiters are decoded as
+/// by COBSEncoding. Each frame is decoded straight into one slot of a
+/// preallocated ring, so no memory is allocated after construction.
+///
+/// A frame with a truncated block, or one larger than the maximum frame
+/// size, is dropped and counted. Decoding resumes at the next delimiter, so
+/// errors never cost more than the frame they occur in. When the ring is
+/// full, newly completed frames are dropped and counted.
+///
+/// Bare delimiters, e.g. the leading 0x00 some senders use to flush the
+/// line, are ignored.
+///
+/// ~~~~{.cpp}
+/// ofxIO::COBSStreamDecoder decoder(512, 64);
+///
+/// decoder.update(serialBytes, serialByteCount);
+///
+/// while (!decoder.empty())
+/// {
+///     ofxIO::ByteBufferView frame = decoder.front();
+///     // ... use frame ...
+///     decoder.pop();
+/// }
+/// ~~~~
+///
+/// A COBSStreamDecoder is not thread-safe.
+class COBSStreamDecoder
+{
+public:
+    /// \brief The running totals of a COBSStreamDecoder.
+    struct Statistics
+    {
+        /// \brief The number of frames decoded into the ring.
+        uint64_t frames = 0;
+
+        /// \brief The number of frames dropped because a block was cut
+        /// short by a delimiter.
+        uint64_t invalidFrames = 0;
+
+        /// \brief The number of frames dropped because they exceeded the
+        /// maximum frame size.
+        uint64_t oversizedFrames = 0;
+
+        /// \brief The number of valid frames dropped because the ring was
+        /// full.
+        uint64_t droppedFrames = 0;
+    };
+
+    /// \brief Create a COBSStreamDecoder.
+    /// \param maximumFrameSize The largest decoded frame size in bytes.
+    /// \param frameCount The number of frames the ring can hold.
+    /// \param isReduced Decode COBS/R.
+    /// \param delimiter The frame delimiter.
+    COBSStreamDecoder(std::size_t maximumFrameSize = DEFAULT_MAXIMUM_FRAME_SIZE,
+                      std::size_t frameCount = DEFAULT_FRAME_COUNT,
+                      bool isReduced = false,
+                      uint8_t delimiter = 0);
+
+    /// \brief Destroy the COBSStreamDecoder.
+    ~COBSStreamDecoder();
+
+    /// \brief Decode a chunk of encoded bytes.
+    /// \param buffer The encoded bytes.
+    /// \param size The number of encoded bytes.
+    /// \returns the number of frames added to the ring.
+    std::size_t update(const uint8_t* buffer, std::size_t size);
+
+    /// \brief Decode a chunk of encoded bytes.
+    /// \param buffer The encoded bytes.
+    /// \returns the number of frames added to the ring.
+    std::size_t update(const ByteBufferView& buffer);
+
+    /// \returns true if no decoded frames are waiting.
+    bool empty() const;
+
+    /// \returns the number of decoded frames waiting.
+    std::size_t size() const;
+
+    /// \brief Get the oldest decoded frame.
+    ///
+    /// The view is valid until the frame is popped.
+    ///
+    /// \returns the oldest frame, or an empty view if there is none.
+    ByteBufferView front() const;
+
+    /// \brief Remove the oldest decoded frame, if any.
+    void pop();
+
+    /// \brief Drop all decoded frames and any partial frame.
+    ///
+    /// The next frame begins at the next delimiter. Statistics are kept.
+    void reset();
+
+    /// \returns the running totals.
+    const Statistics& statistics() const;
+
+    /// \returns the largest decoded frame size in bytes.
+    std::size_t maximumFrameSize() const;
+
+    /// \returns the number of frames the ring can hold.
+    std::size_t frameCount() const;
+
+    /// \returns true if COBS/R is decoded.
+    bool isReduced() const;
+
+    /// \returns the frame delimiter.
+    uint8_t delimiter() const;
+
+    enum
+    {
+        /// \brief The default largest decoded frame size in bytes.
+        DEFAULT_MAXIMUM_FRAME_SIZE = 1024,
+
+        /// \brief The default number of frames in the ring.
+        DEFAULT_FRAME_COUNT = 64
+    };
+
+private:
+    COBSStreamDecoder(const COBSStreamDecoder&) = delete;
+    COBSStreamDecoder& operator = (const COBSStreamDecoder&) = delete;
+
+    /// \brief Handle a delimiter, completing or dropping the current frame.
+    /// \returns true if a frame was added to the ring.
+    bool _endFrame();
+
+    /// \brief Append bytes to the current frame.
+    ///
+    /// If the frame would exceed the maximum frame size, it is dropped
+    /// instead and decoding skips to the next delimiter.
+    ///
+    /// \returns true if the bytes were appended.
+    bool _append(const uint8_t* buffer, std::size_t size);
+
+    /// \brief Start a new frame in the next free slot.
+    void _beginFrame();
+
+    /// \brief The largest decoded frame size in bytes.
+    std::size_t _maximumFrameSize = DEFAULT_MAXIMUM_FRAME_SIZE;
+
+    /// \brief The number of frames the ring can hold.
+    std::size_t _frameCount = DEFAULT_FRAME_COUNT;
+
+    /// \brief True if COBS/R is decoded.
+    bool _isReduced = false;
+
+    /// \brief The frame delimiter.
+    uint8_t _delimiter = 0;
+
+    /// \brief The frame slots, _maximumFrameSize bytes each.
+    ///
+    /// There is one more slot than _frameCount, so the frame being decoded
+    /// always has a slot of its own.
+    std::vector<uint8_t> _storage;
+
+    /// \brief The decoded size of each slot.
+    std::vector<std::size_t> _sizes;
+
+    /// \brief The slot of the oldest frame.
+    std::size_t _head = 0;
+
+    /// \brief The number of frames in the ring.
+    std::size_t _size = 0;
+
+    /// \brief The slot of the frame being decoded.
+    uint8_t* _frame = nullptr;
+
+    /// \brief The number of bytes decoded into the current frame.
+    std::size_t _frameSize = 0;
+
+    /// \brief The code of the current block.
+    uint8_t _code = 0;
+
+    /// \brief The number of data bytes left in the current block.
+    std::size_t _remaining = 0;
+
+    /// \brief True if the current block ends with an implied delimiter.
+    bool _hasPendingDelimiter = false;
+
+    /// \brief True once the current frame has a code byte.
+    bool _hasCode = false;
+
+    /// \brief True while skipping to the next delimiter.
+    bool _isDiscarding = false;
+
+    /// \brief The running totals.
+    Statistics _statistics;
+
+};
+
+
+} } // namespace ofx::IO
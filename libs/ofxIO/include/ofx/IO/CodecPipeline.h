@@ -0,0 +1,137 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "ofx/IO/AbstractTypes.h"
+#include "ofx/IO/CodecRegistry.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+/// \brief Chains encoders / decoders into a single encoder / decoder.
+///
+/// Encoding runs the stages in order, and decoding runs them in reverse
+/// order, so a pipeline decodes what it encodes.
+///
+/// The stages are connected by their stream transforms. The input is fed to
+/// the first stage one chunk at a time, and the output of each stage is
+/// passed on in chunks, so each intermediate buffer holds at most what one
+/// stage makes from one chunk. No stage sees the whole payload unless it
+/// needs it, as a compression stage does.
+///
+/// ~~~~{.cpp}
+/// CodecPipeline pipeline("GZIP|BASE64");
+///
+/// ByteBuffer encoded;
+/// pipeline.encode(payload, encoded);
+///
+/// FilteredOutputStream output(file);
+/// output.push(pipeline.createOutputStreamFilter());
+/// output.stream() << payload;
+/// ~~~~
+class CodecPipeline: public AbstractByteEncoderDecoder
+{
+public:
+    /// \brief Create an empty CodecPipeline, which copies its input.
+    /// \param chunkSize The largest number of bytes passed to a stage at once.
+    CodecPipeline(std::size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    /// \brief Create a CodecPipeline from codec names.
+    /// \param stages The codec names in encoding order, separated by '|'.
+    /// \param registry The registry that creates the codecs.
+    /// \param chunkSize The largest number of bytes passed to a stage at once.
+    /// \throws Poco::NotFoundException if a codec is not registered.
+    CodecPipeline(const std::string& stages,
+                  const CodecRegistry& registry = CodecRegistry::defaultRegistry(),
+                  std::size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    /// \brief Destroy the CodecPipeline.
+    virtual ~CodecPipeline() override;
+
+    /// \brief Add a stage to the end of the pipeline.
+    /// \param codec The codec of the stage.
+    /// \returns this pipeline.
+    CodecPipeline& add(std::shared_ptr<AbstractByteEncoderDecoder> codec);
+
+    /// \brief Add a stage to the end of the pipeline.
+    /// \param name The name of the codec.
+    /// \param registry The registry that creates the codec.
+    /// \returns this pipeline.
+    /// \throws Poco::NotFoundException if the codec is not registered.
+    CodecPipeline& add(const std::string& name,
+                       const CodecRegistry& registry = CodecRegistry::defaultRegistry());
+
+    std::size_t encode(const ByteBuffer& buffer,
+                       ByteBuffer& encodedBuffer) override;
+
+    std::size_t decode(const ByteBuffer& buffer,
+                       ByteBuffer& decodedBuffer) override;
+
+    std::size_t encode(const ByteBufferView& buffer,
+                       ByteBuffer& encodedBuffer) override;
+
+    std::size_t decode(const ByteBufferView& buffer,
+                       ByteBuffer& decodedBuffer) override;
+
+    /// \brief Create an incremental encoder through every stage.
+    ///
+    /// The encoder shares the stages, so it may outlive the pipeline.
+    ///
+    /// \returns a new stream encoder.
+    std::unique_ptr<AbstractByteTransform> createStreamEncoder() override;
+
+    /// \brief Create an incremental decoder through every stage.
+    ///
+    /// The decoder shares the stages, so it may outlive the pipeline.
+    ///
+    /// \returns a new stream decoder.
+    std::unique_ptr<AbstractByteTransform> createStreamDecoder() override;
+
+    /// \returns an output filter that encodes what is written to it.
+    std::unique_ptr<AbstractOutputStreamFilter> createOutputStreamFilter();
+
+    /// \returns an input filter that decodes what is read from it.
+    std::unique_ptr<AbstractInputStreamFilter> createInputStreamFilter();
+
+    /// \returns the number of stages.
+    std::size_t size() const;
+
+    /// \returns true if the pipeline has no stages.
+    bool empty() const;
+
+    /// \returns the largest number of bytes passed to a stage at once.
+    std::size_t chunkSize() const;
+
+    /// \brief The default largest number of bytes passed to a stage at once.
+    enum
+    {
+        DEFAULT_CHUNK_SIZE = 64 * 1024
+    };
+
+private:
+    /// \brief Transform a buffer through a new stream transform.
+    std::size_t _transform(std::unique_ptr<AbstractByteTransform> transform,
+                           const ByteBufferView& buffer,
+                           ByteBuffer& outputBuffer) const;
+
+    /// \brief The largest number of bytes passed to a stage at once.
+    std::size_t _chunkSize = DEFAULT_CHUNK_SIZE;
+
+    /// \brief The stages in encoding order.
+    std::vector<std::shared_ptr<AbstractByteEncoderDecoder>> _stages;
+
+};
+
+
+} } // namespace ofx::IO
@@ -0,0 +1,107 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ofx/IO/AbstractTypes.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+/// \brief A collection of encoders / decoders that can be created by name.
+///
+/// Names are case insensitive. The default registry knows every built in
+/// codec:
+///
+/// | Name        | Codec                                     |
+/// |-------------|-------------------------------------------|
+/// | `ZLIB`      | CompressionEncoding(Compression::ZLIB)    |
+/// | `GZIP`      | CompressionEncoding(Compression::GZIP)    |
+/// | `SNAPPY`    | CompressionEncoding(Compression::SNAPPY)  |
+/// | `LZ4`       | CompressionEncoding(Compression::LZ4)     |
+/// | `BR`        | CompressionEncoding(Compression::BR)      |
+/// | `BASE64`    | Base64Encoding()                          |
+/// | `BASE64URL` | Base64Encoding(true)                      |
+/// | `HEX`       | HexBinaryEncoding()                       |
+/// | `COBS`      | COBSEncoding()                            |
+/// | `COBSR`     | COBSEncoding(true)                        |
+/// | `SLIP`      | SLIPEncoding()                            |
+/// | `URI`       | URIEncoding()                             |
+///
+/// Applications may add their own codecs, or replace the built in ones.
+///
+/// ~~~~{.cpp}
+/// CodecRegistry::defaultRegistry().add("BASE64LINES", []() {
+///     return std::make_shared<Base64Encoding>(false, true, true);
+/// });
+/// ~~~~
+///
+/// A CodecRegistry is safe to use from many threads.
+class CodecRegistry
+{
+public:
+    /// \brief A function that creates a new codec.
+    typedef std::function<std::shared_ptr<AbstractByteEncoderDecoder>()> Factory;
+
+    /// \brief Create an empty CodecRegistry.
+    CodecRegistry();
+
+    /// \brief Destroy the CodecRegistry.
+    ~CodecRegistry();
+
+    /// \brief Add a codec, replacing any codec with the same name.
+    /// \param name The name of the codec.
+    /// \param factory A function that creates the codec.
+    void add(const std::string& name, Factory factory);
+
+    /// \brief Remove a codec.
+    /// \param name The name of the codec.
+    /// \returns true if the codec was removed.
+    bool remove(const std::string& name);
+
+    /// \param name The name of the codec.
+    /// \returns true if the codec is registered.
+    bool has(const std::string& name) const;
+
+    /// \brief Create a new codec.
+    /// \param name The name of the codec.
+    /// \returns the new codec.
+    /// \throws Poco::NotFoundException if the codec is not registered.
+    std::shared_ptr<AbstractByteEncoderDecoder> create(const std::string& name) const;
+
+    /// \returns the names of the registered codecs, in order.
+    std::vector<std::string> names() const;
+
+    /// \returns the shared registry of built in codecs.
+    static CodecRegistry& defaultRegistry();
+
+private:
+    CodecRegistry(const CodecRegistry&) = delete;
+    CodecRegistry& operator = (const CodecRegistry&) = delete;
+
+    /// \returns the name used as the key of a codec.
+    static std::string _key(const std::string& name);
+
+    /// \brief The factories by name.
+    std::map<std::string, Factory> _factories;
+
+    /// \brief Guards the factories.
+    mutable std::mutex _mutex;
+
+};
+
+
+} } // namespace ofx::IO
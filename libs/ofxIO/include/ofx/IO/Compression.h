@@ -10,6 +10,8 @@
 
 #include <stdint.h>
 #include "ofx/IO/ByteBuffer.h"
+#include "ofx/IO/ByteBufferView.h"
+#include "ofx/IO/CompressionDictionary.h"
 
 
 namespace ofx {
@@ -17,6 +19,21 @@ namespace IO {
 
 
 /// \brief A class for compressing and uncompressing ByteBuffers.
+///
+/// Input may be any ByteBufferView, so ByteBuffers and other memory can be
+/// compressed in place without being copied first.
+///
+/// ZLIB and GZIP call zlib directly on the ByteBuffer storage. Compressed
+/// output is sized with deflateBound(), and gzip output with the size in
+/// its trailer.
+///
+/// Each thread keeps a Compressor and Decompressor per type between calls,
+/// so zlib windows and hash tables are not allocated again, and brotli
+/// reuses its memory. Use a Compressor or Decompressor directly to compress
+/// in pieces.
+///
+/// Small messages of similar content compress far better with a
+/// CompressionDictionary trained from typical messages.
 class Compression
 {
 public:
@@ -41,18 +58,31 @@ public:
     /// \param uncompressedBuffer The buffer to fill with uncompressed bytes.
     /// \param type The compression Type.
     /// \returns the number of bytes uncompressed or 0 if error.
-    static std::size_t uncompress(const ByteBuffer& compressedBuffer,
+    static std::size_t uncompress(const ByteBufferView& compressedBuffer,
                                   ByteBuffer& uncompressedBuffer,
                                   Type type);
 
+    /// \brief Uncompress a ByteBuffer compressed with a dictionary.
+    /// \param compressedBuffer The buffer compressed with `type` compression.
+    /// \param uncompressedBuffer The buffer to fill with uncompressed bytes.
+    /// \param type The compression Type.
+    /// \param dictionary The dictionary the buffer was compressed with.
+    /// \returns the number of bytes uncompressed or 0 if error.
+    static std::size_t uncompress(const ByteBufferView& compressedBuffer,
+                                  ByteBuffer& uncompressedBuffer,
+                                  Type type,
+                                  const CompressionDictionary& dictionary);
+
     /// \brief Uncomress a ByteBuffer using Type::ZLIB.
     /// \param compressedBuffer The compressed buffer.
     /// \param uncompressedBuffer The empty buffer to decompress with `zlib`.
-    /// \param windowBits See deflateInit2() for more informtion.
-    ///                   Must be in range (8 - 15) inclusive.
+    /// \param windowBits See inflateInit2() for more informtion.
+    ///                   Must be in range (8 - 15) inclusive. Add 16 to
+    ///                   expect a gzip header, or 32 to detect either.
+    ///                   Concatenated gzip members are decoded as one.
     /// \returns the number of bytes uncompressed or 0 if error.
     /// \sa http://www.zlib.net/manual.html
-    static std::size_t uncompress(const ByteBuffer& compressedBuffer,
+    static std::size_t uncompress(const ByteBufferView& compressedBuffer,
                                   ByteBuffer& uncompressedBuffer,
                                   int windowBits);
 
@@ -61,7 +91,7 @@ public:
     /// \param compressedBuffer The buffer to fill with compressed bytes.
     /// \param type The compression Type.
     /// \returns the number of compressed bytes or 0 if error.
-    static std::size_t compress(const ByteBuffer& uncompressedBuffer,
+    static std::size_t compress(const ByteBufferView& uncompressedBuffer,
                                 ByteBuffer& compressedBuffer,
                                 Type type);
 
@@ -69,15 +99,50 @@ public:
     /// \param uncompressedBuffer The buffer to compress with `type` compression.
     /// \param compressedBuffer The buffer to fill with compressed bytes.
     /// \param type The compression Type.
-    /// \param level The compression level (1 - 8) inclusive.
-    ///        Only valid for Type::ZLIB and Type::GZIP.
+    /// \param level The compression level, which trades speed for ratio:
+    ///        - Type::ZLIB and Type::GZIP: the zlib level (0 - 9) inclusive,
+    ///          or Z_DEFAULT_COMPRESSION.
+    ///        - Type::LZ4: a negative level is the LZ4 acceleration, so -8
+    ///          is faster than -1. Levels 0 - 2 use acceleration 1. Levels
+    ///          3 - 12 use LZ4HC, which is slower to compress but compresses
+    ///          more, and uncompresses as fast.
+    ///        - Type::BR: the brotli quality (0 - 11) inclusive. The window
+    ///          is sized to fit the input, up to the default 4 MB.
+    ///        - Other types ignore the level.
     /// \returns the number of compressed bytes or 0 if error.
     /// \sa http://www.zlib.net/manual.html
-    static std::size_t compress(const ByteBuffer& uncompressedBuffer,
+    static std::size_t compress(const ByteBufferView& uncompressedBuffer,
                                 ByteBuffer& compressedBuffer,
                                 Type type,
                                 int level);
 
+    /// \brief Compress a ByteBuffer with a dictionary.
+    /// \param uncompressedBuffer The buffer to compress with `type` compression.
+    /// \param compressedBuffer The buffer to fill with compressed bytes.
+    /// \param type The compression Type, one of Type::ZLIB, Type::LZ4 or
+    ///        Type::BR.
+    /// \param dictionary The dictionary.
+    /// \returns the number of compressed bytes or 0 if error.
+    static std::size_t compress(const ByteBufferView& uncompressedBuffer,
+                                ByteBuffer& compressedBuffer,
+                                Type type,
+                                const CompressionDictionary& dictionary);
+
+    /// \brief Compress a ByteBuffer with a dictionary.
+    /// \param uncompressedBuffer The buffer to compress with `type` compression.
+    /// \param compressedBuffer The buffer to fill with compressed bytes.
+    /// \param type The compression Type, one of Type::ZLIB, Type::LZ4 or
+    ///        Type::BR.
+    /// \param level The compression level, as for compress(uncompressedBuffer,
+    ///        compressedBuffer, type, level).
+    /// \param dictionary The dictionary.
+    /// \returns the number of compressed bytes or 0 if error.
+    static std::size_t compress(const ByteBufferView& uncompressedBuffer,
+                                ByteBuffer& compressedBuffer,
+                                Type type,
+                                int level,
+                                const CompressionDictionary& dictionary);
+
     /// \brief Compress a ByteBuffer using Type::ZLIB.
     /// \param uncompressedBuffer The buffer to compress with `zlib` compression.
     /// \param compressedBuffer The buffer to fill with compressed bytes.
@@ -86,7 +151,7 @@ public:
     /// \param level The compression level (1 - 8) inclusive.
     /// \returns the number of compressed bytes or 0 if error.
     /// \sa http://www.zlib.net/manual.html
-    static std::size_t compress(const ByteBuffer& uncompressedBuffer,
+    static std::size_t compress(const ByteBufferView& uncompressedBuffer,
                                 ByteBuffer& compressedBuffer,
                                 int windowBits,
                                 int level);
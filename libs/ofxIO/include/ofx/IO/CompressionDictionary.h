@@ -0,0 +1,129 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ofx/IO/ByteBuffer.h"
+#include "ofx/IO/ByteBufferView.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+/// \brief Content that primes a compressor before each message.
+///
+/// Small messages compress poorly because each one starts with an empty
+/// window. A dictionary of content common to the messages fills the window
+/// first, so even the first bytes of a message can refer back to it. The
+/// same dictionary must be given to the Decompressor.
+///
+/// The ID of a dictionary is the Adler-32 of its content. It is recorded in
+/// the header where the format has a place for it:
+///
+/// - Type::ZLIB records it in the zlib header, as zlib always does for a
+///   preset dictionary. Raw deflate streams have no header.
+/// - Type::LZ4 records it in the frame descriptor.
+/// - Type::BR has no place for it, so a brotli stream uncompressed with the
+///   wrong dictionary is not detected.
+///
+/// Each format uses the end of a dictionary that is larger than its window:
+/// 32 KB for zlib, 64 KB for LZ4 and the window size for brotli.
+///
+/// ~~~~{.cpp}
+/// auto dictionary = ofxIO::CompressionDictionary::train(samples);
+///
+/// ofxIO::Compression::compress(message, compressed, ofxIO::Compression::ZLIB, dictionary);
+/// ofxIO::Compression::uncompress(compressed, message, ofxIO::Compression::ZLIB, dictionary);
+/// ~~~~
+class CompressionDictionary
+{
+public:
+    enum
+    {
+        /// \brief The default size of a trained dictionary.
+        DEFAULT_SIZE = 32 * 1024,
+
+        /// \brief The magic number at the start of a serialized dictionary.
+        MAGIC_NUMBER = 0x4478666F
+    };
+
+    /// \brief Create an empty dictionary, which compresses as none.
+    CompressionDictionary();
+
+    /// \brief Create a dictionary.
+    /// \param content The dictionary content, with the most common content
+    ///        at the end.
+    explicit CompressionDictionary(const ByteBufferView& content);
+
+    /// \returns the dictionary content.
+    const ByteBuffer& content() const;
+
+    /// \returns the Adler-32 of the content, or 0 if empty.
+    uint32_t id() const;
+
+    /// \returns the size of the content in bytes.
+    std::size_t size() const;
+
+    /// \returns true if the dictionary has no content.
+    bool empty() const;
+
+    /// \returns true if the dictionaries have the same content.
+    bool operator == (const CompressionDictionary& other) const;
+
+    /// \returns true if the dictionaries have different content.
+    bool operator != (const CompressionDictionary& other) const;
+
+    /// \brief Serialize the dictionary.
+    ///
+    /// The magic number and ID, little endian, are followed by the content.
+    ///
+    /// \returns the serialized dictionary.
+    ByteBuffer toByteBuffer() const;
+
+    /// \brief Read a dictionary serialized with toByteBuffer().
+    /// \param buffer The serialized dictionary.
+    /// \param dictionary Set to the dictionary if it is valid.
+    /// \returns true if the buffer held a valid dictionary.
+    static bool fromByteBuffer(const ByteBufferView& buffer,
+                               CompressionDictionary& dictionary);
+
+    /// \brief Train a dictionary of the default size.
+    /// \param samples Typical messages.
+    /// \returns the dictionary, which is empty if the samples share nothing.
+    static CompressionDictionary train(const std::vector<ByteBuffer>& samples);
+
+    /// \brief Train a dictionary from typical messages.
+    ///
+    /// The samples are split into equal epochs, and the segment of each
+    /// epoch that covers the most substrings shared between samples is
+    /// kept. Segments are ordered by score, so the most useful content is
+    /// nearest the message. Samples should be at least as large as the
+    /// dictionary in total, and ideally ten times larger.
+    ///
+    /// \param samples Typical messages.
+    /// \param maximumSize The largest dictionary size in bytes.
+    /// \returns the dictionary, which is empty if the samples share nothing.
+    /// \sa https://github.com/facebook/zstd/blob/dev/lib/dictBuilder/cover.c
+    static CompressionDictionary train(const std::vector<ByteBuffer>& samples,
+                                       std::size_t maximumSize);
+
+private:
+    /// \brief The dictionary content.
+    ByteBuffer _content;
+
+    /// \brief The Adler-32 of the content.
+    uint32_t _id = 0;
+
+};
+
+
+} } // namespace ofx::IO
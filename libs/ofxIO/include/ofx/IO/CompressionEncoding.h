@@ -0,0 +1,61 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include "ofx/IO/AbstractTypes.h"
+#include "ofx/IO/Compression.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+/// \brief Adapts a Compression::Type to the encoder / decoder interface.
+///
+/// Encoding compresses and decoding uncompresses, so compression can be
+/// registered with a CodecRegistry and used as a CodecPipeline stage.
+class CompressionEncoding: public AbstractByteEncoderDecoder
+{
+public:
+    /// \brief Create a CompressionEncoding.
+    /// \param type The compression type.
+    CompressionEncoding(Compression::Type type);
+
+    /// \brief Destroy the CompressionEncoding.
+    virtual ~CompressionEncoding() override;
+
+    std::size_t encode(const ByteBuffer& buffer,
+                       ByteBuffer& encodedBuffer) override;
+
+    std::size_t decode(const ByteBuffer& buffer,
+                       ByteBuffer& decodedBuffer) override;
+
+    std::size_t encode(const ByteBufferView& buffer,
+                       ByteBuffer& encodedBuffer) override;
+
+    std::size_t decode(const ByteBufferView& buffer,
+                       ByteBuffer& decodedBuffer) override;
+
+    /// \returns a new Compressor of the type.
+    std::unique_ptr<AbstractByteTransform> createStreamEncoder() override;
+
+    /// \returns a new Decompressor of the type.
+    std::unique_ptr<AbstractByteTransform> createStreamDecoder() override;
+
+    /// \returns the compression type.
+    Compression::Type type() const;
+
+private:
+    /// \brief The compression type.
+    Compression::Type _type = Compression::NONE;
+
+};
+
+
+} } // namespace ofx::IO
@@ -0,0 +1,171 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <memory>
+#include "ofx/IO/AbstractTypes.h"
+#include "ofx/IO/ByteBuffer.h"
+#include "ofx/IO/ByteBufferView.h"
+#include "ofx/IO/Compression.h"
+#include "ofx/IO/CompressionDictionary.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+/// \brief Compresses many messages, keeping its codec state between them.
+///
+/// Setting up a codec often costs more than compressing a small message. A
+/// Compressor sets up once and is reset for each message, so zlib keeps its
+/// window and hash tables, and brotli reuses the memory of the last message.
+///
+/// A message may be compressed whole with compress(), or in pieces with
+/// update() and finish(). Each message is a complete stream of its type.
+///
+/// - Type::ZLIB and Type::GZIP compress incrementally.
+/// - Type::LZ4 writes LZ4 frames, see LZ4Frame. A frame records its content
+///   size if it is known before the first block is written.
+/// - Type::SNAPPY is not a streaming format, so its input is collected until
+///   finish().
+/// - Type::BR compresses incrementally. compress() fits the window to the
+///   message.
+///
+/// A CompressionDictionary primes Type::ZLIB, Type::LZ4 and Type::BR before
+/// each message, see CompressionDictionary. Brotli ignores a dictionary at
+/// qualities 0 and 1, so those use quality 2 with one.
+///
+/// A Compressor is not thread-safe. Errors in update() and finish() are
+/// thrown as Poco::Exception.
+///
+/// ~~~~{.cpp}
+/// ofxIO::Compressor compressor(ofxIO::Compression::ZLIB);
+///
+/// for (const auto& message: messages)
+/// {
+///     compressor.compress(message, compressed);
+///     // ... send compressed ...
+/// }
+/// ~~~~
+class Compressor: public AbstractByteTransform
+{
+public:
+    /// \brief Create a Compressor with the default level of the type.
+    /// \param type The compression type.
+    Compressor(Compression::Type type);
+
+    /// \brief Create a Compressor.
+    /// \param type The compression type.
+    /// \param level The compression level, as for Compression::compress().
+    Compressor(Compression::Type type, int level);
+
+    /// \brief Create a Compressor.
+    /// \param type The compression type.
+    /// \param level The compression level, as for Compression::compress().
+    /// \param windowBits For Type::ZLIB, the deflateInit2() window bits,
+    ///        which may select a gzip or raw stream. For Type::GZIP, the
+    ///        window bits without the gzip flag. For Type::BR, the log2 of
+    ///        the window size (10 - 24). Ignored otherwise.
+    Compressor(Compression::Type type, int level, int windowBits);
+
+    /// \brief Create a Compressor with a dictionary and the default level.
+    /// \param type The compression type.
+    /// \param dictionary The dictionary, or an empty one for none.
+    /// \throws Poco::InvalidArgumentException if the type does not support
+    ///         dictionaries.
+    Compressor(Compression::Type type,
+               const CompressionDictionary& dictionary);
+
+    /// \brief Create a Compressor with a dictionary.
+    /// \param type The compression type.
+    /// \param level The compression level, as for Compression::compress().
+    /// \param dictionary The dictionary, or an empty one for none.
+    /// \throws Poco::InvalidArgumentException if the type does not support
+    ///         dictionaries.
+    Compressor(Compression::Type type,
+               int level,
+               const CompressionDictionary& dictionary);
+
+    /// \brief Create a Compressor with a dictionary.
+    /// \param type The compression type.
+    /// \param level The compression level, as for Compression::compress().
+    /// \param windowBits The window bits, as for Compressor(type, level, windowBits).
+    /// \param dictionary The dictionary, or an empty one for none. Type::GZIP,
+    ///        gzip Type::ZLIB window bits and Type::SNAPPY do not support
+    ///        dictionaries. Type::NONE ignores it.
+    /// \throws Poco::InvalidArgumentException if the type does not support
+    ///         dictionaries.
+    Compressor(Compression::Type type,
+               int level,
+               int windowBits,
+               const CompressionDictionary& dictionary);
+
+    /// \brief Destroy the Compressor.
+    virtual ~Compressor() override;
+
+    std::size_t update(const ByteBufferView& buffer,
+                       ByteBuffer& outputBuffer) override;
+
+    std::size_t finish(ByteBuffer& outputBuffer) override;
+
+    void reset() override;
+
+    /// \brief Compress a whole message.
+    /// \param uncompressedBuffer The message to compress.
+    /// \param compressedBuffer The buffer to fill with compressed bytes.
+    /// \returns the number of compressed bytes or 0 if error.
+    std::size_t compress(const ByteBufferView& uncompressedBuffer,
+                         ByteBuffer& compressedBuffer);
+
+    /// \returns the compression type.
+    Compression::Type type() const;
+
+    /// \returns the compression level.
+    int level() const;
+
+    /// \returns the window bits.
+    int windowBits() const;
+
+    /// \returns the dictionary, which is empty if there is none.
+    const CompressionDictionary& dictionary() const;
+
+    /// \param type The compression type.
+    /// \returns the level used when none is given.
+    static int defaultLevel(Compression::Type type);
+
+    /// \param type The compression type.
+    /// \returns the window bits used when none are given.
+    static int defaultWindowBits(Compression::Type type);
+
+    /// \brief The state of one codec, defined with the codecs.
+    class Context;
+
+private:
+    Compressor(const Compressor&) = delete;
+    Compressor& operator = (const Compressor&) = delete;
+
+    /// \brief The compression type.
+    Compression::Type _type = Compression::NONE;
+
+    /// \brief The compression level.
+    int _level = 0;
+
+    /// \brief The window bits.
+    int _windowBits = 0;
+
+    /// \brief The dictionary, which the codec state refers to.
+    CompressionDictionary _dictionary;
+
+    /// \brief The codec state.
+    std::unique_ptr<Context> _context;
+
+};
+
+
+} } // namespace ofx::IO
@@ -0,0 +1,127 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <memory>
+#include "ofx/IO/AbstractTypes.h"
+#include "ofx/IO/ByteBuffer.h"
+#include "ofx/IO/ByteBufferView.h"
+#include "ofx/IO/Compression.h"
+#include "ofx/IO/CompressionDictionary.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+/// \brief Uncompresses many messages, keeping its codec state between them.
+///
+/// The counterpart of Compressor. A message may be uncompressed whole with
+/// uncompress(), or in pieces with update() and finish().
+///
+/// - Type::ZLIB and Type::GZIP uncompress incrementally, and keep their
+///   window between messages. Concatenated gzip members are uncompressed as
+///   one.
+/// - Type::LZ4 uncompresses LZ4 frames incrementally, see LZ4Frame. Raw LZ4
+///   blocks, which do not record their size, are collected until finish().
+/// - Type::SNAPPY is not a streaming format, so its input is collected until
+///   finish().
+/// - Type::BR uncompresses incrementally.
+///
+/// A Decompressor given a CompressionDictionary uncompresses what a
+/// Compressor with the same dictionary compressed. Type::ZLIB and Type::LZ4
+/// check the dictionary ID in the header, see CompressionDictionary.
+///
+/// A Decompressor is not thread-safe. Corrupt or truncated input in update()
+/// and finish() is thrown as Poco::DataFormatException, after which reset()
+/// begins the next message.
+class Decompressor: public AbstractByteTransform
+{
+public:
+    /// \brief Create a Decompressor.
+    /// \param type The compression type.
+    Decompressor(Compression::Type type);
+
+    /// \brief Create a Decompressor.
+    /// \param type The compression type.
+    /// \param windowBits For Type::ZLIB, the inflateInit2() window bits,
+    ///        which may select a gzip or raw stream, or detect either. For
+    ///        Type::GZIP, the window bits without the gzip flag. Ignored
+    ///        otherwise.
+    Decompressor(Compression::Type type, int windowBits);
+
+    /// \brief Create a Decompressor with a dictionary.
+    /// \param type The compression type.
+    /// \param dictionary The dictionary, or an empty one for none.
+    /// \throws Poco::InvalidArgumentException if the type does not support
+    ///         dictionaries.
+    Decompressor(Compression::Type type,
+                 const CompressionDictionary& dictionary);
+
+    /// \brief Create a Decompressor with a dictionary.
+    /// \param type The compression type.
+    /// \param windowBits The window bits, as for Decompressor(type, windowBits).
+    /// \param dictionary The dictionary, or an empty one for none. Type::GZIP
+    ///        and Type::SNAPPY do not support dictionaries. Type::NONE
+    ///        ignores it.
+    /// \throws Poco::InvalidArgumentException if the type does not support
+    ///         dictionaries.
+    Decompressor(Compression::Type type,
+                 int windowBits,
+                 const CompressionDictionary& dictionary);
+
+    /// \brief Destroy the Decompressor.
+    virtual ~Decompressor() override;
+
+    std::size_t update(const ByteBufferView& buffer,
+                       ByteBuffer& outputBuffer) override;
+
+    std::size_t finish(ByteBuffer& outputBuffer) override;
+
+    void reset() override;
+
+    /// \brief Uncompress a whole message.
+    /// \param compressedBuffer The message to uncompress.
+    /// \param uncompressedBuffer The buffer to fill with uncompressed bytes.
+    /// \returns the number of uncompressed bytes or 0 if error.
+    std::size_t uncompress(const ByteBufferView& compressedBuffer,
+                           ByteBuffer& uncompressedBuffer);
+
+    /// \returns the compression type.
+    Compression::Type type() const;
+
+    /// \returns the window bits.
+    int windowBits() const;
+
+    /// \returns the dictionary, which is empty if there is none.
+    const CompressionDictionary& dictionary() const;
+
+    /// \brief The state of one codec, defined with the codecs.
+    class Context;
+
+private:
+    Decompressor(const Decompressor&) = delete;
+    Decompressor& operator = (const Decompressor&) = delete;
+
+    /// \brief The compression type.
+    Compression::Type _type = Compression::NONE;
+
+    /// \brief The window bits.
+    int _windowBits = 0;
+
+    /// \brief The dictionary, which the codec state refers to.
+    CompressionDictionary _dictionary;
+
+    /// \brief The codec state.
+    std::unique_ptr<Context> _context;
+
+};
+
+
+} } // namespace ofx::IO
@@ -56,6 +56,11 @@ public:
 
     void push(std::unique_ptr<AbstractOutputStreamFilter> filter);
 
+    /// \brief Get the filtered stream.
+    ///
+    /// Filters keep the stream they built, so each call returns the same
+    /// stream until another filter is pushed.
+    ///
     /// \returns the original stream with all filters applied.
     std::ostream& stream();
 
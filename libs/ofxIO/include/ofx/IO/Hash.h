@@ -20,6 +20,7 @@
 #include "ofFileUtils.h"
 
 #include "ofx/IO/ByteBuffer.h"
+#include "ofx/IO/ByteBufferView.h"
 
 namespace ofx {
 namespace IO {
@@ -46,6 +47,11 @@ public:
 };
 
 
+/// \brief Hash functions for byte buffers.
+///
+/// The BufferType may be any type with getData() and size(), such as a
+/// ByteBuffer, a ByteBufferView or an ofBuffer. A ByteBufferView allows
+/// existing memory to be hashed without copying.
 class Hash
 {
 public:
@@ -8,7 +8,10 @@
 #pragma once
 
 
+#include <stdint.h>
+#include <string>
 #include "ofx/IO/AbstractTypes.h"
+#include "ofx/IO/ByteBufferView.h"
 
 
 namespace ofx {
@@ -16,12 +19,30 @@ namespace IO {
 
 
 /// \brief Encodes and decodes bytes using Hexadecimal Binary encoding.
+///
+/// Encoding and decoding are done natively in a single pass, using AVX2
+/// where the CPU supports it and lookup tables otherwise.
+///
+/// Each byte is written as two hex digits. Bytes on the same line may be
+/// separated by a separator string, and lines may be broken with `\n` after
+/// a number of bytes. By default the output matches Poco::HexBinaryEncoder,
+/// lower case with a line break every 36 bytes (72 characters).
+///
+/// The decoder accepts upper and lower case digits and skips whitespace and
+/// the characters of the separator.
+///
 /// \sa http://en.wikipedia.org/wiki/Hexadecimal
 class HexBinaryEncoding: public AbstractByteEncoderDecoder
 {
 public:
     /// \brief Create a HexBinary Encoding.
-    HexBinaryEncoding();
+    /// \param isUpperCase When encoding, use upper case digits.
+    /// \param separator When encoding, the separator between bytes on a line.
+    /// \param bytesPerLine When encoding, the number of bytes per line, or 0
+    ///     for a single line.
+    HexBinaryEncoding(bool isUpperCase = false,
+                      const std::string& separator = std::string(),
+                      std::size_t bytesPerLine = DEFAULT_BYTES_PER_LINE);
 
     /// \brief Destroy a HexBinary Encoding.
     virtual ~HexBinaryEncoding();
@@ -31,7 +52,91 @@ public:
 
     std::size_t decode(const ByteBuffer& buffer,
                        ByteBuffer& decodedBuffer) override;
-    
+
+    std::size_t encode(const ByteBufferView& buffer,
+                       ByteBuffer& encodedBuffer) override;
+
+    std::size_t decode(const ByteBufferView& buffer,
+                       ByteBuffer& decodedBuffer) override;
+
+    std::unique_ptr<AbstractByteTransform> createStreamEncoder() override;
+
+    std::unique_ptr<AbstractByteTransform> createStreamDecoder() override;
+
+    /// \brief Encode a byte buffer with the hex encoder.
+    /// \param buffer The buffer to encode.
+    /// \param size The size of the buffer to encode.
+    /// \param encodedBuffer The target buffer for the encoded bytes.
+    /// \param isUpperCase Use upper case digits.
+    /// \param separator The separator between bytes on a line.
+    /// \param bytesPerLine The number of bytes per line, or 0 for one line.
+    /// \returns The number of bytes in the encoded buffer.
+    /// \warning encodedBuffer must have a minimum capacity of
+    ///     encodedSize(size, separator.size(), bytesPerLine).
+    static std::size_t encode(const uint8_t* buffer,
+                              std::size_t size,
+                              uint8_t* encodedBuffer,
+                              bool isUpperCase = false,
+                              const std::string& separator = std::string(),
+                              std::size_t bytesPerLine = 0);
+
+    /// \brief Decode a hex encoded buffer.
+    ///
+    /// Whitespace and the characters of the separator are skipped. Decoding
+    /// stops at the first other character that is not a hex digit, and a
+    /// trailing half byte is dropped.
+    ///
+    /// \param buffer The hex encoded buffer to decode.
+    /// \param size The size of the hex encoded buffer.
+    /// \param decodedBuffer The target buffer for the decoded bytes.
+    /// \param separator The separator between encoded bytes.
+    /// \returns The number of bytes in the decoded buffer.
+    /// \warning decodedBuffer must have a minimum capacity of
+    ///     maximumDecodedSize(size).
+    static std::size_t decode(const uint8_t* buffer,
+                              std::size_t size,
+                              uint8_t* decodedBuffer,
+                              const std::string& separator = std::string());
+
+    /// \brief Calculate the exact size of an encoded buffer.
+    /// \param size The number of bytes to encode.
+    /// \param separatorSize The size of the separator.
+    /// \param bytesPerLine The number of bytes per line, or 0 for one line.
+    /// \returns the number of encoded bytes.
+    static std::size_t encodedSize(std::size_t size,
+                                   std::size_t separatorSize = 0,
+                                   std::size_t bytesPerLine = 0);
+
+    /// \brief Calculate the largest possible size of a decoded buffer.
+    /// \param size The number of encoded bytes.
+    /// \returns the maximum number of decoded bytes.
+    static std::size_t maximumDecodedSize(std::size_t size);
+
+    /// \returns true if the output uses upper case digits.
+    bool isUpperCase() const;
+
+    /// \returns the separator between bytes on a line.
+    std::string separator() const;
+
+    /// \returns the number of bytes per line, or 0 for a single line.
+    std::size_t bytesPerLine() const;
+
+    enum
+    {
+        /// \brief The default number of bytes per line, as Poco::HexBinaryEncoder.
+        DEFAULT_BYTES_PER_LINE = 36
+    };
+
+private:
+    /// \brief When encoding, use upper case digits.
+    bool _isUpperCase = false;
+
+    /// \brief When encoding, the separator between bytes on a line.
+    std::string _separator;
+
+    /// \brief When encoding, the number of bytes per line or 0.
+    std::size_t _bytesPerLine = DEFAULT_BYTES_PER_LINE;
+
 };
 
 
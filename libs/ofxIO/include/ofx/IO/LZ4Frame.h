@@ -0,0 +1,226 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "ofx/IO/AbstractTypes.h"
+#include "ofx/IO/ByteBuffer.h"
+#include "ofx/IO/ByteBufferView.h"
+#include "ofx/IO/CompressionDictionary.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+/// \brief Compresses and uncompresses the LZ4 frame format.
+///
+/// A frame starts with a magic number and a descriptor, which records the
+/// uncompressed content size, followed by LZ4 blocks and an optional
+/// checksum of the content. Knowing the content size, uncompress() sizes
+/// its output once. Blocks that do not compress are stored as is.
+///
+/// Frames are compatible with the `lz4` command line tool and liblz4's
+/// lz4frame. Concatenated frames are uncompressed as one, and skippable
+/// frames are skipped.
+///
+/// Stream encoders and decoders work on frames in pieces. The whole-buffer
+/// functions use the same code, with whole blocks read straight from the
+/// input.
+///
+/// A frame compressed with a CompressionDictionary records the dictionary
+/// ID in its descriptor, and uncompressing it without the same dictionary
+/// is an error. Frames without an ID, such as those of `lz4 -D`, are
+/// uncompressed with whatever dictionary is given.
+///
+/// \sa https://github.com/lz4/lz4/blob/dev/doc/lz4_Frame_format.md
+class LZ4Frame
+{
+public:
+    /// \brief The largest uncompressed size of a block.
+    enum BlockSize
+    {
+        BLOCK_SIZE_64KB = 4,
+        BLOCK_SIZE_256KB = 5,
+        BLOCK_SIZE_1MB = 6,
+        BLOCK_SIZE_4MB = 7
+    };
+
+    /// \brief Options for compressing a frame.
+    struct Settings
+    {
+        /// \brief The largest uncompressed size of a block.
+        BlockSize blockSize = BLOCK_SIZE_4MB;
+
+        /// \brief True if blocks are compressed without referring to the
+        /// blocks before them. Dependent blocks compress small block sizes
+        /// better.
+        bool isBlockIndependent = true;
+
+        /// \brief True if each block is followed by its XXH32 checksum.
+        bool hasBlockChecksum = false;
+
+        /// \brief True if the frame ends with the XXH32 checksum of the
+        /// uncompressed content.
+        bool hasContentChecksum = true;
+
+        /// \brief True if the descriptor records the uncompressed size.
+        bool hasContentSize = true;
+
+        /// \brief The LZ4 acceleration. Higher is faster, with less
+        /// compression. Ignored at LZ4HC levels.
+        int acceleration = 1;
+
+        /// \brief The LZ4HC level (3 - 12), or a lower level for the fast
+        /// compressor. Higher levels compress more slowly, for a better
+        /// ratio, and uncompress just as fast.
+        int level = 0;
+    };
+
+    /// \brief The magic number at the start of each frame.
+    enum
+    {
+        MAGIC_NUMBER = 0x184D2204
+    };
+
+    /// \brief Compress a buffer into a single frame with the default
+    /// Settings.
+    /// \param uncompressedBuffer The bytes to compress.
+    /// \param compressedBuffer The buffer to fill with the frame.
+    /// \returns the size of the frame or 0 if error.
+    static std::size_t compress(const ByteBufferView& uncompressedBuffer,
+                                ByteBuffer& compressedBuffer);
+
+    /// \brief Compress a buffer into a single frame.
+    /// \param uncompressedBuffer The bytes to compress.
+    /// \param compressedBuffer The buffer to fill with the frame.
+    /// \param settings The frame options.
+    /// \returns the size of the frame or 0 if error.
+    static std::size_t compress(const ByteBufferView& uncompressedBuffer,
+                                ByteBuffer& compressedBuffer,
+                                const Settings& settings);
+
+    /// \brief Compress a buffer into a single frame with a dictionary.
+    /// \param uncompressedBuffer The bytes to compress.
+    /// \param compressedBuffer The buffer to fill with the frame.
+    /// \param settings The frame options.
+    /// \param dictionary The dictionary, or an empty one for none.
+    /// \returns the size of the frame or 0 if error.
+    static std::size_t compress(const ByteBufferView& uncompressedBuffer,
+                                ByteBuffer& compressedBuffer,
+                                const Settings& settings,
+                                const CompressionDictionary& dictionary);
+
+    /// \brief Uncompress one or more frames.
+    /// \param compressedBuffer The frames to uncompress.
+    /// \param uncompressedBuffer The buffer to fill with the content.
+    /// \returns the size of the content or 0 if error.
+    static std::size_t uncompress(const ByteBufferView& compressedBuffer,
+                                  ByteBuffer& uncompressedBuffer);
+
+    /// \brief Uncompress one or more frames with a dictionary.
+    /// \param compressedBuffer The frames to uncompress.
+    /// \param uncompressedBuffer The buffer to fill with the content.
+    /// \param dictionary The dictionary the frames were compressed with.
+    /// \returns the size of the content or 0 if error.
+    static std::size_t uncompress(const ByteBufferView& compressedBuffer,
+                                  ByteBuffer& uncompressedBuffer,
+                                  const CompressionDictionary& dictionary);
+
+    /// \brief Create an incremental frame compressor with the default
+    /// Settings.
+    /// \returns a new stream encoder.
+    static std::unique_ptr<AbstractByteTransform> createStreamEncoder();
+
+    /// \brief Create an incremental frame compressor.
+    ///
+    /// The descriptor is written with the first block. A frame records its
+    /// content size only if all of it is given before then, which is the
+    /// case for content that fits in one block.
+    ///
+    /// \param settings The frame options.
+    /// \returns a new stream encoder.
+    static std::unique_ptr<AbstractByteTransform> createStreamEncoder(const Settings& settings);
+
+    /// \brief Create an incremental frame compressor with a dictionary.
+    ///
+    /// The dictionary is loaded once and reused for each frame.
+    ///
+    /// \param settings The frame options.
+    /// \param dictionary The dictionary, or an empty one for none.
+    /// \returns a new stream encoder.
+    static std::unique_ptr<AbstractByteTransform> createStreamEncoder(const Settings& settings,
+                                                                      const CompressionDictionary& dictionary);
+
+    /// \brief Create an incremental frame uncompressor.
+    ///
+    /// Errors in the frames are thrown as Poco::DataFormatException.
+    ///
+    /// \returns a new stream decoder.
+    static std::unique_ptr<AbstractByteTransform> createStreamDecoder();
+
+    /// \brief Create an incremental frame uncompressor with a dictionary.
+    ///
+    /// Errors in the frames, including a dictionary ID that does not match,
+    /// are thrown as Poco::DataFormatException.
+    ///
+    /// \param dictionary The dictionary the frames were compressed with.
+    /// \returns a new stream decoder.
+    static std::unique_ptr<AbstractByteTransform> createStreamDecoder(const CompressionDictionary& dictionary);
+
+    /// \param size The number of bytes to compress.
+    /// \param settings The frame options.
+    /// \returns the largest size of a frame holding size bytes.
+    static std::size_t compressBound(std::size_t size,
+                                     const Settings& settings);
+
+    /// \param buffer The bytes to check.
+    /// \returns true if the buffer starts with the frame magic number.
+    static bool isFrame(const ByteBufferView& buffer);
+
+    /// \brief Read the content size from a frame descriptor.
+    /// \param buffer The frame.
+    /// \param contentSize Set to the content size, if the frame has one.
+    /// \returns true if the frame records its content size.
+    static bool getContentSize(const ByteBufferView& buffer,
+                               uint64_t& contentSize);
+
+    /// \brief Read the dictionary ID from a frame descriptor.
+    /// \param buffer The frame.
+    /// \param dictionaryId Set to the dictionary ID, if the frame has one.
+    /// \returns true if the frame records a dictionary ID.
+    static bool getDictionaryId(const ByteBufferView& buffer,
+                                uint32_t& dictionaryId);
+
+    /// \brief Find the size of the frame at the start of a buffer.
+    ///
+    /// The frame is walked by its block headers without uncompressing it,
+    /// so the frames of a buffer can be found before any is uncompressed.
+    ///
+    /// \param buffer The frame, which may be followed by other bytes.
+    /// \param frameSize Set to the size of the frame in bytes.
+    /// \returns true if the buffer starts with a complete LZ4 frame.
+    static bool getFrameSize(const ByteBufferView& buffer,
+                             std::size_t& frameSize);
+
+    /// \brief Calculate the XXH32 hash used by the frame checksums.
+    /// \param buffer The bytes to hash.
+    /// \param size The number of bytes to hash.
+    /// \param seed The hash seed.
+    /// \returns the hash.
+    static uint32_t xxh32(const uint8_t* buffer,
+                          std::size_t size,
+                          uint32_t seed = 0);
+
+};
+
+
+} } // namespace ofx::IO
@@ -0,0 +1,155 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Poco/SharedMemory.h"
+#include "ofx/IO/AbstractTypes.h"
+#include "ofx/IO/ByteBufferView.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+/// \brief A memory-mapped file that can be used as a byte source.
+///
+/// The file's contents are mapped into memory rather than copied into a
+/// ByteBuffer, so even very large files can be read without doubling the
+/// resident memory. A MappedFileBuffer converts to a ByteBufferView, so it
+/// can be passed directly to Compression, Hash and the encoders.
+///
+/// ~~~~{.cpp}
+/// ofxIO::MappedFileBuffer file("large.bin");
+/// ofxIO::ByteBuffer compressed;
+/// ofxIO::Compression::compress(file, compressed, ofxIO::Compression::LZ4);
+/// ~~~~
+class MappedFileBuffer: public AbstractByteSource
+{
+public:
+    /// \brief The mapping access mode.
+    enum class Mode
+    {
+        /// \brief Map the file for reading only.
+        READ_ONLY,
+        /// \brief Map the file for reading and writing.
+        ///
+        /// Writes go directly to the file. The file size is fixed.
+        READ_WRITE
+    };
+
+    /// \brief The expected access pattern, passed to the OS as a hint.
+    ///
+    /// Hints are ignored on platforms that do not support posix_madvise().
+    enum class Advice
+    {
+        /// \brief No special treatment.
+        NORMAL,
+        /// \brief Pages will be accessed in order. Enables read-ahead.
+        SEQUENTIAL,
+        /// \brief Pages will be accessed in random order.
+        RANDOM,
+        /// \brief Pages will be needed soon. Starts reading them in.
+        WILL_NEED
+    };
+
+    /// \brief Create an unmapped MappedFileBuffer.
+    MappedFileBuffer();
+
+    /// \brief Create a MappedFileBuffer by mapping a file.
+    /// \param path The path of the file to map.
+    /// \param mode The mapping access mode.
+    /// \param advice The expected access pattern.
+    /// \throws a Poco::FileException (or similar) if the file cannot be mapped.
+    MappedFileBuffer(const std::string& path,
+                     Mode mode = Mode::READ_ONLY,
+                     Advice advice = Advice::SEQUENTIAL);
+
+    /// \brief Destroy the MappedFileBuffer, unmapping the file.
+    virtual ~MappedFileBuffer() override;
+
+    /// \brief Map a file, unmapping any currently mapped file.
+    /// \param path The path of the file to map.
+    /// \param mode The mapping access mode.
+    /// \param advice The expected access pattern.
+    /// \throws a Poco::FileException (or similar) if the file cannot be mapped.
+    void open(const std::string& path,
+              Mode mode = Mode::READ_ONLY,
+              Advice advice = Advice::SEQUENTIAL);
+
+    /// \brief Unmap the file.
+    void close();
+
+    /// \returns true if a file is mapped.
+    bool isOpen() const;
+
+    /// \returns the mapping access mode.
+    Mode mode() const;
+
+    /// \brief Give the OS a hint about how the mapped bytes will be accessed.
+    /// \param advice The expected access pattern.
+    void advise(Advice advice);
+
+    /// \brief Flush modified pages to the file.
+    ///
+    /// Only meaningful in Mode::READ_WRITE.
+    ///
+    /// \returns true if successful.
+    bool flush();
+
+    virtual std::size_t readBytes(uint8_t* buffer, std::size_t size) const override;
+    virtual std::size_t readBytes(std::vector<uint8_t>& buffer) const override;
+    virtual std::size_t readBytes(std::string& buffer) const override;
+    virtual std::size_t readBytes(AbstractByteSink& buffer) const override;
+    virtual std::vector<uint8_t> readBytes() const override;
+
+    /// \returns the number of mapped bytes.
+    std::size_t size() const override;
+
+    /// \returns true iff the no bytes are mapped.
+    bool empty() const;
+
+    /// \returns a const pointer to the mapped bytes.
+    const uint8_t* getPtr() const;
+
+    /// \returns a writable pointer to the mapped bytes, or nullptr if the file
+    ///          is not mapped in Mode::READ_WRITE.
+    uint8_t* getWritePtr();
+
+    /// \returns a const pointer to the mapped bytes.
+    const char* getCharPtr() const;
+
+    /// \returns a const pointer to the mapped bytes.
+    const char* getData() const;
+
+    /// \returns a view of the mapped bytes.
+    ByteBufferView view() const;
+
+    /// \returns a view of the mapped bytes.
+    operator ByteBufferView() const;
+
+private:
+    MappedFileBuffer(const MappedFileBuffer&) = delete;
+    MappedFileBuffer& operator = (const MappedFileBuffer&) = delete;
+
+    /// \brief The mapping, or nullptr if nothing is mapped.
+    std::unique_ptr<Poco::SharedMemory> _memory;
+
+    /// \brief The number of mapped bytes.
+    std::size_t _size = 0;
+
+    /// \brief The mapping access mode.
+    Mode _mode = Mode::READ_ONLY;
+
+};
+
+
+} } // namespace ofx::IO
@@ -0,0 +1,141 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include "ofx/IO/ByteBuffer.h"
+#include "ofx/IO/ByteBufferView.h"
+#include "ofx/IO/Compression.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+/// \brief Compresses and uncompresses large buffers on several threads.
+///
+/// The input is split into blocks that are compressed independently, each
+/// by the next free thread, and written in order. Each block records its
+/// sizes, so uncompress() can size its output once and uncompress the
+/// blocks in parallel, each into its place.
+///
+/// - Type::GZIP writes a gzip member per block, as `pigz --independent`
+///   does. Each member records its compressed size in an `IO` extra field
+///   and its uncompressed size in its trailer. `gunzip` and
+///   Compression::uncompress() read the members as one stream.
+/// - Type::LZ4 writes an LZ4 frame per block, each recording its content
+///   size. The `lz4` tool and LZ4Frame read the frames as one stream.
+/// - Type::SNAPPY and Type::BR streams cannot be concatenated, so the blocks
+///   are written to a container: MAGIC_NUMBER, then for each block its
+///   compressed and uncompressed sizes and its stream. The sizes are 32 bit
+///   and little endian. Only ParallelCompression reads the container.
+/// - Type::ZLIB writes a single zlib stream, as `pigz --zlib --independent`
+///   does. Each block is raw deflate that ends with a sync flush, the last
+///   block finishes the stream, and the Adler-32 checksums of the blocks
+///   are combined for the trailer. Any zlib reader reads the stream.
+/// - Type::NONE is copied on the calling thread.
+///
+/// Input that does not record its block sizes, such as gzip from other
+/// tools or any zlib stream, is uncompressed on the calling thread.
+///
+/// Blocks do not refer to each other, so smaller blocks spread over more
+/// threads but compress a little less.
+///
+/// ~~~~{.cpp}
+/// ofxIO::ParallelCompression::compress(archive, compressed, ofxIO::Compression::GZIP);
+/// ofxIO::ParallelCompression::uncompress(compressed, archive, ofxIO::Compression::GZIP);
+/// ~~~~
+class ParallelCompression
+{
+public:
+    enum
+    {
+        /// \brief The default uncompressed size of a block.
+        DEFAULT_BLOCK_SIZE = 1024 * 1024,
+
+        /// \brief The smallest uncompressed size of a block.
+        MINIMUM_BLOCK_SIZE = 64 * 1024,
+
+        /// \brief The largest uncompressed size of a block.
+        MAXIMUM_BLOCK_SIZE = 1024 * 1024 * 1024,
+
+        /// \brief The magic number at the start of a container, "ofxP"
+        /// little endian.
+        MAGIC_NUMBER = 0x5078666F
+    };
+
+    /// \brief Options for compressing and uncompressing in parallel.
+    struct Settings
+    {
+        /// \brief The uncompressed size of each block, limited to
+        /// MINIMUM_BLOCK_SIZE - MAXIMUM_BLOCK_SIZE. Ignored by uncompress().
+        std::size_t blockSize = DEFAULT_BLOCK_SIZE;
+
+        /// \brief The number of threads, including the calling thread, or 0
+        /// for one per core.
+        std::size_t numThreads = 0;
+    };
+
+    /// \brief Compress a buffer with the default level and Settings.
+    /// \param uncompressedBuffer The bytes to compress.
+    /// \param compressedBuffer The buffer to fill with compressed bytes.
+    /// \param type The compression Type.
+    /// \returns the number of compressed bytes or 0 if error.
+    static std::size_t compress(const ByteBufferView& uncompressedBuffer,
+                                ByteBuffer& compressedBuffer,
+                                Compression::Type type);
+
+    /// \brief Compress a buffer with the default Settings.
+    /// \param uncompressedBuffer The bytes to compress.
+    /// \param compressedBuffer The buffer to fill with compressed bytes.
+    /// \param type The compression Type.
+    /// \param level The compression level, as for Compression::compress().
+    /// \returns the number of compressed bytes or 0 if error.
+    static std::size_t compress(const ByteBufferView& uncompressedBuffer,
+                                ByteBuffer& compressedBuffer,
+                                Compression::Type type,
+                                int level);
+
+    /// \brief Compress a buffer in blocks on several threads.
+    /// \param uncompressedBuffer The bytes to compress.
+    /// \param compressedBuffer The buffer to fill with compressed bytes.
+    /// \param type The compression Type.
+    /// \param level The compression level, as for Compression::compress().
+    /// \param settings The block size and number of threads.
+    /// \returns the number of compressed bytes or 0 if error.
+    static std::size_t compress(const ByteBufferView& uncompressedBuffer,
+                                ByteBuffer& compressedBuffer,
+                                Compression::Type type,
+                                int level,
+                                const Settings& settings);
+
+    /// \brief Uncompress a buffer with the default Settings.
+    /// \param compressedBuffer The buffer compressed with `type` compression.
+    /// \param uncompressedBuffer The buffer to fill with uncompressed bytes.
+    /// \param type The compression Type.
+    /// \returns the number of uncompressed bytes or 0 if error.
+    static std::size_t uncompress(const ByteBufferView& compressedBuffer,
+                                  ByteBuffer& uncompressedBuffer,
+                                  Compression::Type type);
+
+    /// \brief Uncompress a buffer on several threads.
+    /// \param compressedBuffer The buffer compressed with `type` compression.
+    /// \param uncompressedBuffer The buffer to fill with uncompressed bytes.
+    /// \param type The compression Type.
+    /// \param settings The number of threads.
+    /// \returns the number of uncompressed bytes or 0 if error.
+    static std::size_t uncompress(const ByteBufferView& compressedBuffer,
+                                  ByteBuffer& uncompressedBuffer,
+                                  Compression::Type type,
+                                  const Settings& settings);
+
+};
+
+
+} } // namespace ofx::IO
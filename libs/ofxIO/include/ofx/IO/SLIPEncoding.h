@@ -13,6 +13,7 @@
 #include <stdint.h>
 #include "ofx/IO/AbstractTypes.h"
 #include "ofx/IO/ByteBuffer.h"
+#include "ofx/IO/ByteBufferView.h"
 
 
 namespace ofx {
@@ -44,6 +45,16 @@ public:
     std::size_t decode(const ByteBuffer& buffer,
                 ByteBuffer& decodedBuffer) override;
 
+    std::size_t encode(const ByteBufferView& buffer,
+                       ByteBuffer& encodedBuffer) override;
+
+    std::size_t decode(const ByteBufferView& buffer,
+                       ByteBuffer& decodedBuffer) override;
+
+    std::unique_ptr<AbstractByteTransform> createStreamEncoder() override;
+
+    std::unique_ptr<AbstractByteTransform> createStreamDecoder() override;
+
     /// \brief Encode a byte buffer with the SLIP encoder.
     /// \param buffer The buffer to encode.
     /// \param size The size of the buffer to encode.
@@ -65,6 +76,12 @@ public:
                               std::size_t size,
                               uint8_t* decodedBuffer);
 
+    /// \brief Find the first END or ESC byte, using SIMD where available.
+    /// \param buffer The buffer to search.
+    /// \param size The size of the buffer to search.
+    /// \returns the index of the first END or ESC byte, or size if none.
+    static std::size_t findSpecial(const uint8_t* buffer, std::size_t size);
+
     /// \brief A collection of key values for SLIP encoding.
     enum
     {
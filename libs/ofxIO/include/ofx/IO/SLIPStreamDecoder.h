@@ -0,0 +1,146 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ofx/IO/ByteBuffer.h"
+#include "ofx/IO/ByteBufferView.h"
+#include "ofx/IO/ThreadChannel.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+/// \brief Splits a continuous stream of SLIP frames and decodes them.
+///
+/// Bytes may be passed in chunks of any size, such as the reads from a
+/// serial port. The escape state is kept between chunks, so an ESC at the
+/// end of one chunk is applied to the first byte of the next. Runs of
+/// ordinary bytes between END and ESC bytes are found with
+/// SLIPEncoding::findSpecial() and copied whole.
+///
+/// The frames completed by each call are returned as one batch, either in
+/// a vector or as a single message on a ThreadChannel, so the per-frame cost
+/// is a copy and not a call, lock or notification.
+///
+/// A frame longer than the maximum frame size is dropped and counted, and
+/// decoding resumes after the next END. An ESC followed by anything other
+/// than ESC_END or ESC_ESC keeps the byte as is, as RFC 1055 suggests, and
+/// is counted. Empty frames, e.g. from the leading END of each packet, are
+/// ignored.
+///
+/// ~~~~{.cpp}
+/// ofxIO::SLIPStreamDecoder decoder;
+/// std::vector<ofxIO::ByteBuffer> frames;
+///
+/// decoder.update(ofxIO::ByteBufferView(serialBytes, serialByteCount), frames);
+///
+/// for (auto& frame: frames)
+/// {
+///     // ... use frame ...
+/// }
+/// ~~~~
+///
+/// A SLIPStreamDecoder is not thread-safe.
+class SLIPStreamDecoder
+{
+public:
+    /// \brief The running totals of a SLIPStreamDecoder.
+    struct Statistics
+    {
+        /// \brief The number of frames decoded.
+        uint64_t frames = 0;
+
+        /// \brief The number of frames dropped because they exceeded the
+        /// maximum frame size.
+        uint64_t oversizedFrames = 0;
+
+        /// \brief The number of ESC bytes followed by an unexpected byte.
+        uint64_t invalidEscapes = 0;
+    };
+
+    /// \brief Create a SLIPStreamDecoder.
+    /// \param maximumFrameSize The largest decoded frame size in bytes.
+    SLIPStreamDecoder(std::size_t maximumFrameSize = DEFAULT_MAXIMUM_FRAME_SIZE);
+
+    /// \brief Destroy the SLIPStreamDecoder.
+    ~SLIPStreamDecoder();
+
+    /// \brief Decode a chunk of encoded bytes.
+    ///
+    /// The frames completed in this chunk replace the contents of frames.
+    /// The ByteBuffers already in frames are reused, so passing the same
+    /// vector to each call stops allocating once its buffers have grown.
+    ///
+    /// \param buffer The encoded bytes.
+    /// \param frames The completed frames.
+    /// \returns the number of completed frames.
+    std::size_t update(const ByteBufferView& buffer,
+                       std::vector<ByteBuffer>& frames);
+
+    /// \brief Decode a chunk of encoded bytes.
+    ///
+    /// The frames completed in this chunk, if any, are sent as one batch.
+    ///
+    /// \param buffer The encoded bytes.
+    /// \param channel The channel that receives each batch of frames.
+    /// \returns the number of completed frames.
+    std::size_t update(const ByteBufferView& buffer,
+                       ThreadChannel<std::vector<ByteBuffer>>& channel);
+
+    /// \brief Drop any partial frame and escape state.
+    ///
+    /// The next frame begins at the next END. Statistics are kept.
+    void reset();
+
+    /// \returns the running totals.
+    const Statistics& statistics() const;
+
+    /// \returns the largest decoded frame size in bytes.
+    std::size_t maximumFrameSize() const;
+
+    enum
+    {
+        /// \brief The default largest decoded frame size in bytes, the
+        /// datagram size suggested by RFC 1055.
+        DEFAULT_MAXIMUM_FRAME_SIZE = 1006
+    };
+
+private:
+    SLIPStreamDecoder(const SLIPStreamDecoder&) = delete;
+    SLIPStreamDecoder& operator = (const SLIPStreamDecoder&) = delete;
+
+    /// \brief Append bytes to the current frame, checking its size.
+    void _append(const uint8_t* buffer, std::size_t size);
+
+    /// \brief The largest decoded frame size in bytes.
+    std::size_t _maximumFrameSize = DEFAULT_MAXIMUM_FRAME_SIZE;
+
+    /// \brief The frame being decoded.
+    ByteBuffer _frame;
+
+    /// \brief True if the last byte was an ESC.
+    bool _isEscaped = false;
+
+    /// \brief True while skipping to the next END.
+    bool _isDiscarding = false;
+
+    /// \brief The frames of the batch sent to a ThreadChannel.
+    std::vector<ByteBuffer> _batch;
+
+    /// \brief The running totals.
+    Statistics _statistics;
+
+};
+
+
+} } // namespace ofx::IO
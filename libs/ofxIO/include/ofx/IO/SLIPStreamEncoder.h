@@ -0,0 +1,81 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include "ofx/IO/ByteBuffer.h"
+#include "ofx/IO/ByteBufferView.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+/// \brief Encodes a batch of SLIP frames into one contiguous buffer.
+///
+/// Frames are appended to the same buffer, which can then be sent with a
+/// single write() call. The batch starts with an END to flush any line
+/// noise at the receiver, and each frame is followed by an END, so
+/// neighbouring frames share a delimiter.
+///
+/// ~~~~{.cpp}
+/// ofxIO::SLIPStreamEncoder encoder;
+///
+/// for (auto& message: messages)
+/// {
+///     encoder.write(message);
+/// }
+///
+/// serialDevice.writeBytes(encoder.buffer());
+/// encoder.clear();
+/// ~~~~
+///
+/// The output is decoded by SLIPStreamDecoder and, one frame at a time, by
+/// SLIPEncoding::decode().
+class SLIPStreamEncoder
+{
+public:
+    /// \brief Create a SLIPStreamEncoder.
+    SLIPStreamEncoder();
+
+    /// \brief Destroy the SLIPStreamEncoder.
+    ~SLIPStreamEncoder();
+
+    /// \brief Encode one frame and append it to the batch.
+    /// \param buffer The frame to encode.
+    /// \param size The size of the frame.
+    /// \returns the number of bytes appended to the batch.
+    std::size_t write(const uint8_t* buffer, std::size_t size);
+
+    /// \brief Encode one frame and append it to the batch.
+    /// \param buffer The frame to encode.
+    /// \returns the number of bytes appended to the batch.
+    std::size_t write(const ByteBufferView& buffer);
+
+    /// \returns the encoded batch.
+    const ByteBuffer& buffer() const;
+
+    /// \returns the number of frames in the batch.
+    std::size_t frames() const;
+
+    /// \brief Start a new batch, keeping the storage of the buffer.
+    void clear();
+
+private:
+    /// \brief The encoded batch.
+    ByteBuffer _buffer;
+
+    /// \brief The number of frames in the batch.
+    std::size_t _frames = 0;
+
+};
+
+
+} } // namespace ofx::IO
@@ -12,6 +12,7 @@
 #include <memory>
 #include "Poco/InflatingStream.h"
 #include "ofx/IO/AbstractTypes.h"
+#include "ofx/IO/ByteTransformStream.h"
 
 
 namespace ofx {
@@ -30,6 +31,55 @@ public:
 private:
     Poco::InflatingStreamBuf::StreamType _type;
     std::unique_ptr<Poco::InflatingInputStream> _stream;
+    std::istream* _source = nullptr;
+
+};
+
+
+/// \brief An input filter that reads through an AbstractByteTransform.
+///
+/// Filtering the same stream again returns the same filtered stream.
+///
+/// ~~~~{.cpp}
+/// Base64Encoding base64;
+/// FilteredInputStream input(file);
+/// input.push(std::make_unique<ByteTransformInputStreamFilter>(base64.createStreamDecoder()));
+/// ~~~~
+class ByteTransformInputStreamFilter: public AbstractInputStreamFilter
+{
+public:
+    ByteTransformInputStreamFilter(std::unique_ptr<AbstractByteTransform> transform);
+
+    virtual ~ByteTransformInputStreamFilter();
+
+    std::istream& filter(std::istream& stream);
+
+private:
+    std::unique_ptr<AbstractByteTransform> _transform;
+    std::unique_ptr<ByteTransformInputStream> _stream;
+    std::istream* _source = nullptr;
+
+};
+
+
+/// \brief An output filter that writes through an AbstractByteTransform.
+///
+/// Filtering the same stream again returns the same filtered stream, so
+/// FilteredOutputStream::stream() may be called more than once. The
+/// transform is finished when the filter is destroyed.
+class ByteTransformOutputStreamFilter: public AbstractOutputStreamFilter
+{
+public:
+    ByteTransformOutputStreamFilter(std::unique_ptr<AbstractByteTransform> transform);
+
+    virtual ~ByteTransformOutputStreamFilter();
+
+    std::ostream& filter(std::ostream& stream);
+
+private:
+    std::unique_ptr<AbstractByteTransform> _transform;
+    std::unique_ptr<ByteTransformOutputStream> _stream;
+    std::ostream* _source = nullptr;
 
 };
 
@@ -8,7 +8,11 @@
 #pragma once
 
 
+#include <cstddef>
+#include <cstdint>
 #include "ofx/IO/AbstractTypes.h"
+#include "ofx/IO/ByteBufferView.h"
+#include "ofx/IO/ByteSet.h"
 
 
 namespace ofx {
@@ -19,12 +23,40 @@ namespace IO {
 ///
 /// URI encoding is also known as URL encoding or "percent" encoding.
 ///
+/// The bytes that are escaped are chosen by a Profile. Each profile has a
+/// precomputed set of escaped bytes, so encoding looks up one bit per byte
+/// and copies the runs between escapes whole. Decoding never grows the
+/// data, so it can be done in place.
+///
 /// \sa http://www.w3schools.com/tags/ref_urlencode.asp
+/// \sa https://tools.ietf.org/html/rfc3986
 class URIEncoding: public AbstractByteEncoderDecoder
 {
 public:
+    /// \brief The sets of bytes that are escaped.
+    enum class Profile
+    {
+        /// \brief The bytes escaped by Poco::URI::encode() with no reserved
+        /// bytes: controls, space, non-ASCII and "%<>{}|\\\"^`!*'()$,[]".
+        DEFAULT,
+        /// \brief Everything but the RFC 3986 path characters: the unreserved
+        /// bytes and "!$&'()*+,;=:@/".
+        PATH,
+        /// \brief Everything but the unreserved bytes and "!$'()*,;:@/?", so
+        /// the result is safe as a query parameter name or value.
+        QUERY,
+        /// \brief application/x-www-form-urlencoded. Everything but ALPHA,
+        /// DIGIT and "*-._" is escaped, and a space is encoded as '+'.
+        FORM,
+        /// \brief Everything but the RFC 3986 unreserved bytes, ALPHA, DIGIT
+        /// and "-._~".
+        UNRESERVED
+    };
+
     /// \brief Create a URI Encoding.
-    URIEncoding();
+    /// \param profile The set of bytes to escape. A FORM encoding also
+    ///        decodes '+' as a space.
+    URIEncoding(Profile profile = Profile::DEFAULT);
 
     /// \brief Destroy the URI Encoding.
     virtual ~URIEncoding();
@@ -35,7 +67,76 @@ public:
     std::size_t decode(const ByteBuffer& buffer,
                        ByteBuffer& decodedBuffer) override;
 
+    std::size_t encode(const ByteBufferView& buffer,
+                       ByteBuffer& encodedBuffer) override;
+
+    std::size_t decode(const ByteBufferView& buffer,
+                       ByteBuffer& decodedBuffer) override;
+
+    std::unique_ptr<AbstractByteTransform> createStreamEncoder() override;
+
+    std::unique_ptr<AbstractByteTransform> createStreamDecoder() override;
+
+    /// \returns the profile of the encoding.
+    Profile profile() const;
+
+    /// \returns the set of bytes escaped by a profile.
+    /// \param profile The profile to query.
+    static const ByteSet& escapedBytes(Profile profile);
+
+    /// \brief Calculate the exact size of an encoded buffer.
+    /// \param buffer The buffer to encode.
+    /// \param size The size of the buffer to encode.
+    /// \param profile The set of bytes to escape.
+    /// \returns the number of bytes encode() will write.
+    static std::size_t encodedSize(const uint8_t* buffer,
+                                   std::size_t size,
+                                   Profile profile = Profile::DEFAULT);
+
+    /// \brief Percent encode a byte buffer.
+    /// \param buffer The buffer to encode.
+    /// \param size The size of the buffer to encode.
+    /// \param encodedBuffer The target buffer for the encoded bytes.
+    /// \param profile The set of bytes to escape.
+    /// \returns The number of bytes in the encoded buffer.
+    /// \warning encodedBuffer must have a minimum capacity of
+    ///     encodedSize(buffer, size, profile), or 3 * size.
+    static std::size_t encode(const uint8_t* buffer,
+                              std::size_t size,
+                              uint8_t* encodedBuffer,
+                              Profile profile = Profile::DEFAULT);
+
+    /// \brief Decode a percent encoded buffer.
+    ///
+    /// The decoded bytes are never more than the encoded bytes, so
+    /// decodedBuffer may be the same as buffer.
+    ///
+    /// \param buffer The buffer to decode.
+    /// \param size The size of the buffer to decode.
+    /// \param decodedBuffer The target buffer for the decoded bytes.
+    /// \param plusAsSpace When true, every non-encoded plus sign is decoded
+    ///        as a space.
+    /// \returns The number of bytes in the decoded buffer.
+    /// \throws Poco::URISyntaxException if an escape is invalid.
+    /// \warning decodedBuffer must have a minimum capacity of size.
+    static std::size_t decode(const uint8_t* buffer,
+                              std::size_t size,
+                              uint8_t* decodedBuffer,
+                              bool plusAsSpace = false);
+
+    /// \brief Decode a percent encoded buffer in place.
+    /// \param buffer The buffer to decode.
+    /// \param plusAsSpace When true, every non-encoded plus sign is decoded
+    ///        as a space.
+    /// \returns The number of bytes in the decoded buffer.
+    /// \throws Poco::URISyntaxException if an escape is invalid.
+    static std::size_t decodeInPlace(ByteBuffer& buffer,
+                                     bool plusAsSpace = false);
+
     /// \brief A URI encoder for strings.
+    ///
+    /// The output is the same as Poco::URI::encode().
+    ///
     /// \param buffer The string to encoded.
     /// \param reserved Reserved charachters that will also be encoded.
     /// \returns a URI encoded std::string.
@@ -43,6 +144,9 @@ public:
                               const std::string& reserved = "");
 
     /// \brief A URI decoder for strings.
+    ///
+    /// The output is the same as Poco::URI::decode().
+    ///
     /// \param buffer The string to decoded.
     /// \param plusAsSpace When true, non-encoded plus signs in the query are
     ///        decoded as spaces.
@@ -51,6 +155,10 @@ public:
     static std::string decode(const std::string& buffer,
                               bool plusAsSpace = false);
 
+private:
+    /// \brief The set of bytes to escape.
+    Profile _profile = Profile::DEFAULT;
+
 };
 
 
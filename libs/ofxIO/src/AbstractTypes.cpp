@@ -0,0 +1,117 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/IO/AbstractTypes.h"
+#include "ofx/IO/ByteBuffer.h"
+#include "ofx/IO/ByteBufferView.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+namespace {
+
+
+/// \brief A transform that collects its input and encodes it when finished.
+class BufferedEncoder: public AbstractByteTransform
+{
+public:
+    BufferedEncoder(AbstractByteEncoder& encoder): _encoder(encoder)
+    {
+    }
+
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer&) override
+    {
+        _input.writeBytes(buffer.getPtr(), buffer.size());
+        return 0;
+    }
+
+    std::size_t finish(ByteBuffer& outputBuffer) override
+    {
+        ByteBuffer encoded;
+        _encoder.encode(_input, encoded);
+        reset();
+        return outputBuffer.writeBytes(encoded.getPtr(), encoded.size());
+    }
+
+    void reset() override
+    {
+        _input.clear();
+    }
+
+private:
+    AbstractByteEncoder& _encoder;
+    ByteBuffer _input;
+
+};
+
+
+/// \brief A transform that collects its input and decodes it when finished.
+class BufferedDecoder: public AbstractByteTransform
+{
+public:
+    BufferedDecoder(AbstractByteDecoder& decoder): _decoder(decoder)
+    {
+    }
+
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer&) override
+    {
+        _input.writeBytes(buffer.getPtr(), buffer.size());
+        return 0;
+    }
+
+    std::size_t finish(ByteBuffer& outputBuffer) override
+    {
+        ByteBuffer decoded;
+        _decoder.decode(_input, decoded);
+        reset();
+        return outputBuffer.writeBytes(decoded.getPtr(), decoded.size());
+    }
+
+    void reset() override
+    {
+        _input.clear();
+    }
+
+private:
+    AbstractByteDecoder& _decoder;
+    ByteBuffer _input;
+
+};
+
+
+} // namespace
+
+
+std::size_t AbstractByteEncoder::encode(const ByteBufferView& buffer,
+                                        ByteBuffer& encodedBuffer)
+{
+    return encode(ByteBuffer(buffer.getPtr(), buffer.size()), encodedBuffer);
+}
+
+
+std::unique_ptr<AbstractByteTransform> AbstractByteEncoder::createStreamEncoder()
+{
+    return std::make_unique<BufferedEncoder>(*this);
+}
+
+
+std::size_t AbstractByteDecoder::decode(const ByteBufferView& buffer,
+                                        ByteBuffer& decodedBuffer)
+{
+    return decode(ByteBuffer(buffer.getPtr(), buffer.size()), decodedBuffer);
+}
+
+
+std::unique_ptr<AbstractByteTransform> AbstractByteDecoder::createStreamDecoder()
+{
+    return std::make_unique<BufferedDecoder>(*this);
+}
+
+
+} }  // namespace ofx::IO
@@ -0,0 +1,984 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/IO/AsyncFileIO.h"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include "Poco/Exception.h"
+#include "ofConstants.h"
+#include "ofLog.h"
+#include "ofUtils.h"
+
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+// IORING_FEAT_RW_CUR_POS arrived with the OPENAT, READ, WRITE and CLOSE ops.
+#if defined(IORING_FEAT_RW_CUR_POS)
+#define OFX_IO_HAVE_IO_URING 1
+#endif
+#endif
+#endif
+
+
+#if defined(OFX_IO_HAVE_IO_URING)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+namespace ofx {
+namespace IO {
+
+
+AsyncFileRequest AsyncFileRequest::read(const std::string& path, int flags)
+{
+    AsyncFileRequest request;
+    request.type = Type::READ;
+    request.path = path;
+    request.flags = flags;
+    return request;
+}
+
+
+AsyncFileRequest AsyncFileRequest::write(const std::string& path,
+                                         ByteBuffer buffer,
+                                         int flags)
+{
+    AsyncFileRequest request;
+    request.type = Type::WRITE;
+    request.path = path;
+    request.buffer = std::move(buffer);
+    request.flags = flags;
+    return request;
+}
+
+
+bool AsyncFileResult::ok() const
+{
+    return error == 0;
+}
+
+
+/// \brief A submitted request and the destination of its result.
+class AsyncFileIO::Job
+{
+public:
+    Job(AsyncFileRequest&& request,
+        ThreadChannel<AsyncFileResult>* channel):
+        request(std::move(request)),
+        channel(channel)
+    {
+        this->request.path = ofToDataPath(this->request.path, true);
+    }
+
+    /// \brief Deliver the result to the future or the channel.
+    void complete(ByteBuffer&& buffer, int error, const std::string& message)
+    {
+        AsyncFileResult result;
+        result.type = request.type;
+        result.path = std::move(request.path);
+        result.buffer = std::move(buffer);
+        result.error = error;
+        result.message = message;
+
+        if (channel)
+        {
+            channel->send(std::move(result));
+        }
+        else
+        {
+            promise.set_value(std::move(result));
+        }
+    }
+
+    AsyncFileRequest request;
+    ThreadChannel<AsyncFileResult>* channel = nullptr;
+    std::promise<AsyncFileResult> promise;
+
+};
+
+
+/// \brief The interface shared by the backends.
+class AsyncFileIO::Engine
+{
+public:
+    virtual ~Engine()
+    {
+    }
+
+    /// \brief Queue jobs for completion.
+    virtual void submit(std::vector<std::unique_ptr<Job>>& jobs) = 0;
+
+    /// \returns the backend type.
+    virtual Backend backend() const = 0;
+
+};
+
+
+/// \brief Completes jobs with blocking I/O on a pool of worker threads.
+class AsyncFileIO::ThreadPoolEngine: public AsyncFileIO::Engine
+{
+public:
+    ThreadPoolEngine(std::size_t numThreads)
+    {
+        if (numThreads == 0)
+        {
+            numThreads = std::max(4u, std::thread::hardware_concurrency());
+        }
+
+        for (std::size_t i = 0; i < numThreads; ++i)
+        {
+            _threads.emplace_back([this]() { _run(); });
+        }
+    }
+
+    ~ThreadPoolEngine() override
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+
+        _condition.notify_all();
+
+        for (auto& thread: _threads)
+        {
+            thread.join();
+        }
+    }
+
+    void submit(std::vector<std::unique_ptr<Job>>& jobs) override
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            for (auto& job: jobs)
+            {
+                _jobs.push_back(std::move(job));
+            }
+        }
+
+        _condition.notify_all();
+    }
+
+    Backend backend() const override
+    {
+        return Backend::THREAD_POOL;
+    }
+
+private:
+    void _run()
+    {
+        while (true)
+        {
+            std::unique_ptr<Job> job;
+
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _condition.wait(lock, [this]() { return _stopping || !_jobs.empty(); });
+
+                if (_jobs.empty())
+                {
+                    return;
+                }
+
+                job = std::move(_jobs.front());
+                _jobs.pop_front();
+            }
+
+            _execute(*job);
+        }
+    }
+
+    static void _execute(Job& job)
+    {
+        ByteBuffer buffer;
+        int error = 0;
+        std::string message;
+
+        try
+        {
+            if (job.request.type == AsyncFileRequest::Type::READ)
+            {
+                ByteBufferUtils::loadFromFileDescriptor(job.request.path, buffer, false, job.request.flags);
+            }
+            else
+            {
+                ByteBufferUtils::saveToFileDescriptor(job.request.buffer, job.request.path, job.request.flags);
+                buffer = std::move(job.request.buffer);
+            }
+        }
+        catch (const Poco::FileNotFoundException& exc)
+        {
+            error = ENOENT;
+            message = exc.displayText();
+        }
+        catch (const Poco::FileAccessDeniedException& exc)
+        {
+            error = EACCES;
+            message = exc.displayText();
+        }
+        catch (const Poco::Exception& exc)
+        {
+            error = EIO;
+            message = exc.displayText();
+        }
+        catch (const std::exception& exc)
+        {
+            error = EIO;
+            message = exc.what();
+        }
+
+        job.complete(std::move(buffer), error, message);
+    }
+
+    std::vector<std::thread> _threads;
+    std::deque<std::unique_ptr<Job>> _jobs;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stopping = false;
+
+};
+
+
+#if defined(OFX_IO_HAVE_IO_URING)
+
+
+/// \brief Completes jobs through a single io_uring instance.
+///
+/// One thread owns the ring. Each job is a small state machine that has at
+/// most one operation in flight: open, then read or write until done, an
+/// optional fdatasync and finally close. Up to the queue depth of jobs are in
+/// flight at once.
+class AsyncFileIO::IOUringEngine: public AsyncFileIO::Engine
+{
+public:
+    /// \brief Set up the ring.
+    /// \throws Poco::IOException if io_uring or a required op is unavailable.
+    IOUringEngine(std::size_t queueDepth)
+    {
+        if (queueDepth == 0)
+        {
+            queueDepth = DEFAULT_QUEUE_DEPTH;
+        }
+
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+
+        _ring = static_cast<int>(::syscall(__NR_io_uring_setup, static_cast<unsigned>(queueDepth), &params));
+
+        if (_ring < 0)
+        {
+            throw Poco::IOException("io_uring_setup failed", std::strerror(errno));
+        }
+
+        try
+        {
+            _map(params);
+            _probe();
+        }
+        catch (...)
+        {
+            _unmap();
+            throw;
+        }
+
+        _capacity = params.sq_entries;
+        _thread = std::thread([this]() { _run(); });
+    }
+
+    ~IOUringEngine() override
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+
+        _condition.notify_all();
+        _thread.join();
+        _unmap();
+
+        // Left by a failed ring, and only released once the ring is closed.
+        for (Operation* operation: _operations)
+        {
+            delete operation;
+        }
+    }
+
+    void submit(std::vector<std::unique_ptr<Job>>& jobs) override
+    {
+        int failure = 0;
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            failure = _failure;
+
+            if (failure == 0)
+            {
+                for (auto& job: jobs)
+                {
+                    _jobs.push_back(std::move(job));
+                }
+            }
+        }
+
+        if (failure != 0)
+        {
+            for (auto& job: jobs)
+            {
+                _failJob(*job, failure);
+            }
+
+            return;
+        }
+
+        _condition.notify_all();
+    }
+
+    Backend backend() const override
+    {
+        return Backend::IO_URING;
+    }
+
+private:
+    enum class Stage
+    {
+        OPEN,
+        READ,
+        WRITE,
+        SYNC,
+        CLOSE
+    };
+
+    /// \brief The state of one job in the ring.
+    struct Operation
+    {
+        std::unique_ptr<Job> job;
+        Stage stage = Stage::OPEN;
+        int fd = -1;
+        std::size_t offset = 0;
+        bool sized = false;
+        int error = 0;
+        ByteBuffer buffer;
+    };
+
+    /// \brief The size of the chunks used for files of unknown size.
+    static const std::size_t CHUNK_SIZE = 1 << 16;
+
+    void _map(const io_uring_params& params)
+    {
+        _sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        _cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+        {
+            _sqRingSize = _cqRingSize = std::max(_sqRingSize, _cqRingSize);
+        }
+
+        _sqRing = ::mmap(nullptr, _sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQ_RING);
+
+        if (_sqRing == MAP_FAILED)
+        {
+            _sqRing = nullptr;
+            throw Poco::IOException("io_uring mmap failed", std::strerror(errno));
+        }
+
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+        {
+            _cqRing = _sqRing;
+        }
+        else
+        {
+            _cqRing = ::mmap(nullptr, _cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_CQ_RING);
+
+            if (_cqRing == MAP_FAILED)
+            {
+                _cqRing = nullptr;
+                throw Poco::IOException("io_uring mmap failed", std::strerror(errno));
+            }
+        }
+
+        _sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQES);
+
+        if (sqes == MAP_FAILED)
+        {
+            throw Poco::IOException("io_uring mmap failed", std::strerror(errno));
+        }
+
+        _sqes = static_cast<io_uring_sqe*>(sqes);
+
+        uint8_t* sq = static_cast<uint8_t*>(_sqRing);
+        _sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        _sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        _sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        uint8_t* cq = static_cast<uint8_t*>(_cqRing);
+        _cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        _cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        _cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        _cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    }
+
+    void _unmap()
+    {
+        if (_sqes) ::munmap(_sqes, _sqesSize);
+        if (_cqRing && _cqRing != _sqRing) ::munmap(_cqRing, _cqRingSize);
+        if (_sqRing) ::munmap(_sqRing, _sqRingSize);
+        if (_ring >= 0) ::close(_ring);
+
+        _sqes = nullptr;
+        _cqRing = nullptr;
+        _sqRing = nullptr;
+        _ring = -1;
+    }
+
+    /// \brief Make sure the kernel supports every op used by the engine.
+    void _probe()
+    {
+        const std::size_t numOps = 256;
+        std::vector<uint8_t> storage(sizeof(io_uring_probe) + numOps * sizeof(io_uring_probe_op), 0);
+        io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+
+        if (::syscall(__NR_io_uring_register, _ring, IORING_REGISTER_PROBE, probe, numOps) < 0)
+        {
+            throw Poco::IOException("io_uring probe failed", std::strerror(errno));
+        }
+
+        for (int op: { IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_WRITE, IORING_OP_FSYNC, IORING_OP_CLOSE })
+        {
+            if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED))
+            {
+                throw Poco::IOException("io_uring op not supported", std::to_string(op));
+            }
+        }
+    }
+
+    /// \brief Fill the next submission queue entry for an operation.
+    void _prepare(Operation* operation)
+    {
+        unsigned index = _sqTailLocal & _sqMask;
+        io_uring_sqe* sqe = &_sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->user_data = reinterpret_cast<uint64_t>(operation);
+
+        const AsyncFileRequest& request = operation->job->request;
+
+        switch (operation->stage)
+        {
+            case Stage::OPEN:
+            {
+                int flags = O_CLOEXEC;
+
+                if (request.type == AsyncFileRequest::Type::READ)
+                {
+                    flags |= O_RDONLY;
+                }
+                else
+                {
+                    flags |= O_WRONLY | O_CREAT;
+                    flags |= (request.flags & ByteBufferUtils::FILE_APPEND) ? O_APPEND : O_TRUNC;
+                }
+
+                sqe->opcode = IORING_OP_OPENAT;
+                sqe->fd = AT_FDCWD;
+                sqe->addr = reinterpret_cast<uint64_t>(request.path.c_str());
+                sqe->len = 0666;
+                sqe->open_flags = flags;
+                break;
+            }
+            case Stage::READ:
+                sqe->opcode = IORING_OP_READ;
+                sqe->fd = operation->fd;
+                sqe->addr = reinterpret_cast<uint64_t>(operation->buffer.getPtr() + operation->offset);
+                sqe->len = static_cast<uint32_t>(std::min<std::size_t>(operation->buffer.size() - operation->offset, 1 << 30));
+                sqe->off = operation->offset;
+                break;
+            case Stage::WRITE:
+                sqe->opcode = IORING_OP_WRITE;
+                sqe->fd = operation->fd;
+                sqe->addr = reinterpret_cast<uint64_t>(request.buffer.getPtr() + operation->offset);
+                sqe->len = static_cast<uint32_t>(std::min<std::size_t>(request.buffer.size() - operation->offset, 1 << 30));
+                sqe->off = operation->offset;
+                break;
+            case Stage::SYNC:
+                sqe->opcode = IORING_OP_FSYNC;
+                sqe->fd = operation->fd;
+                sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+                break;
+            case Stage::CLOSE:
+                sqe->opcode = IORING_OP_CLOSE;
+                sqe->fd = operation->fd;
+                break;
+        }
+
+        _sqArray[index] = index;
+        ++_sqTailLocal;
+        ++_toSubmit;
+    }
+
+    /// \brief Move to the stage after a successful open or transfer.
+    void _nextAfterTransfer(Operation* operation)
+    {
+        const AsyncFileRequest& request = operation->job->request;
+
+        if (request.type == AsyncFileRequest::Type::WRITE
+        && (request.flags & ByteBufferUtils::FILE_SYNC))
+        {
+            operation->stage = Stage::SYNC;
+        }
+        else
+        {
+            operation->stage = Stage::CLOSE;
+        }
+
+        _prepare(operation);
+    }
+
+    /// \brief Advance an operation after its current stage completed.
+    void _advance(Operation* operation, int result)
+    {
+        const AsyncFileRequest& request = operation->job->request;
+
+        if (result == -EINTR || result == -EAGAIN)
+        {
+            _prepare(operation);
+            return;
+        }
+
+        switch (operation->stage)
+        {
+            case Stage::OPEN:
+            {
+                if (result < 0)
+                {
+                    operation->error = -result;
+                    _finish(operation);
+                    return;
+                }
+
+                operation->fd = result;
+
+                if (request.type == AsyncFileRequest::Type::WRITE)
+                {
+                    if (request.buffer.empty())
+                    {
+                        _nextAfterTransfer(operation);
+                    }
+                    else
+                    {
+                        operation->stage = Stage::WRITE;
+                        _prepare(operation);
+                    }
+
+                    return;
+                }
+
+                struct stat info;
+
+                if (::fstat(operation->fd, &info) == 0
+                && S_ISREG(info.st_mode)
+                && info.st_size > 0)
+                {
+                    operation->sized = true;
+                    operation->buffer.resize(static_cast<std::size_t>(info.st_size));
+                }
+                else
+                {
+                    operation->buffer.resize(CHUNK_SIZE);
+                }
+
+                operation->stage = Stage::READ;
+                _prepare(operation);
+                return;
+            }
+            case Stage::READ:
+            {
+                if (result < 0)
+                {
+                    operation->error = -result;
+                    operation->buffer.clear();
+                    operation->stage = Stage::CLOSE;
+                    _prepare(operation);
+                    return;
+                }
+
+                operation->offset += static_cast<std::size_t>(result);
+
+                if (result == 0 || (operation->sized && operation->offset == operation->buffer.size()))
+                {
+                    operation->buffer.resize(operation->offset);
+                    operation->stage = Stage::CLOSE;
+                }
+                else if (operation->offset == operation->buffer.size())
+                {
+                    operation->buffer.resize(operation->buffer.size() * 2);
+                }
+
+                _prepare(operation);
+                return;
+            }
+            case Stage::WRITE:
+            {
+                if (result <= 0)
+                {
+                    operation->error = result < 0 ? -result : EIO;
+                    operation->stage = Stage::CLOSE;
+                    _prepare(operation);
+                    return;
+                }
+
+                operation->offset += static_cast<std::size_t>(result);
+
+                if (operation->offset < request.buffer.size())
+                {
+                    _prepare(operation);
+                }
+                else
+                {
+                    _nextAfterTransfer(operation);
+                }
+
+                return;
+            }
+            case Stage::SYNC:
+            {
+                if (result < 0)
+                {
+                    operation->error = -result;
+                }
+
+                operation->stage = Stage::CLOSE;
+                _prepare(operation);
+                return;
+            }
+            case Stage::CLOSE:
+            {
+                if (result < 0 && operation->error == 0)
+                {
+                    operation->error = -result;
+                }
+
+                _finish(operation);
+                return;
+            }
+        }
+    }
+
+    /// \brief Deliver the result and release the operation.
+    void _finish(Operation* operation)
+    {
+        std::unique_ptr<Operation> owner(operation);
+        Job& job = *operation->job;
+
+        ByteBuffer buffer;
+
+        if (job.request.type == AsyncFileRequest::Type::READ)
+        {
+            buffer = std::move(operation->buffer);
+        }
+        else
+        {
+            buffer = std::move(job.request.buffer);
+        }
+
+        std::string message;
+
+        if (operation->error != 0)
+        {
+            message = job.request.path + ": " + std::strerror(operation->error);
+        }
+
+        job.complete(std::move(buffer), operation->error, message);
+        _operations.erase(operation);
+        --_inFlight;
+    }
+
+    /// \brief Complete a job with the error that stopped the ring.
+    static void _failJob(Job& job, int error)
+    {
+        const std::string message = job.request.path + ": io_uring_enter failed: " + std::strerror(error);
+        job.complete(ByteBuffer(), error, message);
+    }
+
+    /// \brief Fail every job once the ring can no longer be entered.
+    ///
+    /// The kernel may still hold entries of the operations in flight, so
+    /// they keep their buffers until the ring is closed. Later submissions
+    /// fail at once.
+    void _fail(int error)
+    {
+        std::deque<std::unique_ptr<Job>> jobs;
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _failure = error;
+            jobs.swap(_jobs);
+        }
+
+        for (Operation* operation: _operations)
+        {
+            // A close may be in flight, and the fd reused, so leave it.
+            if (operation->fd >= 0 && operation->stage != Stage::CLOSE)
+            {
+                ::close(operation->fd);
+                operation->fd = -1;
+            }
+
+            _failJob(*operation->job, error);
+        }
+
+        for (auto& job: jobs)
+        {
+            _failJob(*job, error);
+        }
+    }
+
+    /// \brief Submit prepared entries and wait for at least one completion.
+    /// \returns 0, or the errno of a failure that leaves the ring unusable.
+    int _enter()
+    {
+        // Publish the new tail before the kernel reads the entries.
+        __atomic_store_n(_sqTail, _sqTailLocal, __ATOMIC_RELEASE);
+
+        while (true)
+        {
+            long result = ::syscall(__NR_io_uring_enter,
+                                    _ring,
+                                    _toSubmit,
+                                    _inFlight > 0 ? 1 : 0,
+                                    IORING_ENTER_GETEVENTS,
+                                    nullptr,
+                                    0);
+
+            if (result >= 0)
+            {
+                _toSubmit -= static_cast<unsigned>(result);
+                return 0;
+            }
+            else if (errno == EINTR)
+            {
+                continue;
+            }
+            else if (errno == EBUSY || errno == EAGAIN)
+            {
+                // The completion queue is full, reap before submitting more.
+                return 0;
+            }
+
+            const int error = errno;
+            ofLogError("AsyncFileIO") << "io_uring_enter failed: " << std::strerror(error);
+            return error;
+        }
+    }
+
+    /// \brief Process every available completion.
+    void _reap()
+    {
+        unsigned head = *_cqHead;
+        unsigned tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+
+        while (head != tail)
+        {
+            const io_uring_cqe& cqe = _cqes[head & _cqMask];
+            Operation* operation = reinterpret_cast<Operation*>(cqe.user_data);
+            int result = cqe.res;
+            ++head;
+            __atomic_store_n(_cqHead, head, __ATOMIC_RELEASE);
+            _advance(operation, result);
+            tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+        }
+    }
+
+    void _run()
+    {
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+
+                if (_inFlight == 0)
+                {
+                    _condition.wait(lock, [this]() { return _stopping || !_jobs.empty(); });
+
+                    if (_jobs.empty())
+                    {
+                        return;
+                    }
+                }
+
+                // Each operation has a single entry in flight, so the number
+                // of operations is bounded by the submission queue size.
+                while (!_jobs.empty() && _inFlight < _capacity)
+                {
+                    Operation* operation = new Operation();
+                    operation->job = std::move(_jobs.front());
+                    _jobs.pop_front();
+                    _operations.insert(operation);
+                    ++_inFlight;
+                    _prepare(operation);
+                }
+            }
+
+            const int error = _enter();
+            _reap();
+
+            if (error != 0)
+            {
+                // Entering again would fail the same way, and spin.
+                _fail(error);
+                return;
+            }
+        }
+    }
+
+    int _ring = -1;
+
+    void* _sqRing = nullptr;
+    void* _cqRing = nullptr;
+    std::size_t _sqRingSize = 0;
+    std::size_t _cqRingSize = 0;
+    std::size_t _sqesSize = 0;
+
+    io_uring_sqe* _sqes = nullptr;
+    unsigned* _sqTail = nullptr;
+    unsigned* _sqArray = nullptr;
+    unsigned _sqMask = 0;
+    unsigned _sqTailLocal = 0;
+    unsigned _toSubmit = 0;
+
+    unsigned* _cqHead = nullptr;
+    unsigned* _cqTail = nullptr;
+    unsigned _cqMask = 0;
+    io_uring_cqe* _cqes = nullptr;
+
+    std::size_t _capacity = 0;
+    std::size_t _inFlight = 0;
+
+    /// \brief The operations in flight, owned by the ring thread.
+    std::unordered_set<Operation*> _operations;
+
+    /// \brief The errno that stopped the ring, or 0.
+    int _failure = 0;
+
+    std::thread _thread;
+    std::deque<std::unique_ptr<Job>> _jobs;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stopping = false;
+
+};
+
+
+#endif
+
+
+AsyncFileIO::AsyncFileIO(Backend backend, std::size_t concurrency)
+{
+#if defined(OFX_IO_HAVE_IO_URING)
+    if (backend != Backend::THREAD_POOL)
+    {
+        try
+        {
+            _engine.reset(new IOUringEngine(concurrency));
+        }
+        catch (const Poco::Exception& exc)
+        {
+            if (backend == Backend::IO_URING)
+            {
+                ofLogWarning("AsyncFileIO::AsyncFileIO") << "Using a thread pool, " << exc.displayText();
+            }
+        }
+    }
+#else
+    if (backend == Backend::IO_URING)
+    {
+        ofLogWarning("AsyncFileIO::AsyncFileIO") << "Using a thread pool, io_uring is not available.";
+    }
+#endif
+
+    if (!_engine)
+    {
+        _engine.reset(new ThreadPoolEngine(concurrency));
+    }
+}
+
+
+AsyncFileIO::~AsyncFileIO()
+{
+}
+
+
+AsyncFileIO::Backend AsyncFileIO::backend() const
+{
+    return _engine->backend();
+}
+
+
+std::future<AsyncFileResult> AsyncFileIO::read(const std::string& path,
+                                               int flags)
+{
+    std::vector<AsyncFileRequest> requests;
+    requests.push_back(AsyncFileRequest::read(path, flags));
+    return std::move(submit(std::move(requests)).front());
+}
+
+
+std::future<AsyncFileResult> AsyncFileIO::write(const std::string& path,
+                                                ByteBuffer buffer,
+                                                int flags)
+{
+    std::vector<AsyncFileRequest> requests;
+    requests.push_back(AsyncFileRequest::write(path, std::move(buffer), flags));
+    return std::move(submit(std::move(requests)).front());
+}
+
+
+std::vector<std::future<AsyncFileResult>> AsyncFileIO::submit(std::vector<AsyncFileRequest> requests)
+{
+    std::vector<std::future<AsyncFileResult>> futures;
+    std::vector<std::unique_ptr<Job>> jobs;
+    futures.reserve(requests.size());
+    jobs.reserve(requests.size());
+
+    for (auto& request: requests)
+    {
+        jobs.emplace_back(new Job(std::move(request), nullptr));
+        futures.push_back(jobs.back()->promise.get_future());
+    }
+
+    _engine->submit(jobs);
+    return futures;
+}
+
+
+void AsyncFileIO::submit(std::vector<AsyncFileRequest> requests,
+                         ThreadChannel<AsyncFileResult>& channel)
+{
+    std::vector<std::unique_ptr<Job>> jobs;
+    jobs.reserve(requests.size());
+
+    for (auto& request: requests)
+    {
+        jobs.emplace_back(new Job(std::move(request), &channel));
+    }
+
+    _engine->submit(jobs);
+}
+
+
+} } // ofx::IO
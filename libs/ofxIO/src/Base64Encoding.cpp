@@ -6,19 +6,677 @@
 
 
 #include "ofx/IO/Base64Encoding.h"
-#include <stdint.h>
-#include "Poco/Base64Encoder.h"
-#include "Poco/Base64Decoder.h"
-#include "Poco/String.h"
-#include "Poco/StreamCopier.h"
+#include <algorithm>
+#include <cstring>
 #include "ofx/IO/ByteBuffer.h"
-#include "ofx/IO/ByteBufferStream.h"
+
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define OFX_IO_BASE64_AVX2 1
+#define OFX_IO_BASE64_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && defined(__AVX2__)
+#include <immintrin.h>
+#define OFX_IO_BASE64_AVX2 1
+#define OFX_IO_BASE64_AVX2_TARGET
+#elif defined(__aarch64__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define OFX_IO_BASE64_NEON 1
+#endif
 
 
 namespace ofx {
 namespace IO {
 
 
+namespace {
+
+
+const char STANDARD_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+const char URL_SAFE_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+
+/// \brief The chunked line length, the same as Poco::Base64Encoder.
+const std::size_t LINE_LENGTH = 72;
+
+/// \brief The number of 3 byte groups encoded on each chunked line.
+const std::size_t LINE_GROUPS = LINE_LENGTH / 4;
+
+/// \brief Decode table value for characters that end decoding.
+const uint8_t INVALID = 0xFF;
+
+/// \brief Decode table value for whitespace, which is skipped.
+const uint8_t SKIP = 0xFE;
+
+/// \brief Quantum table value for characters that are not Base64.
+const uint32_t QUANTUM_INVALID = 0x01000000;
+
+
+/// \brief Lookup tables for the scalar codec.
+struct Tables
+{
+    Tables()
+    {
+        for (std::size_t i = 0; i < 4096; ++i)
+        {
+            standardPairs[i][0] = STANDARD_ALPHABET[i >> 6];
+            standardPairs[i][1] = STANDARD_ALPHABET[i & 63];
+            urlSafePairs[i][0] = URL_SAFE_ALPHABET[i >> 6];
+            urlSafePairs[i][1] = URL_SAFE_ALPHABET[i & 63];
+        }
+
+        std::memset(decode, INVALID, sizeof(decode));
+
+        for (uint8_t i = 0; i < 64; ++i)
+        {
+            decode[uint8_t(STANDARD_ALPHABET[i])] = i;
+            decode[uint8_t(URL_SAFE_ALPHABET[i])] = i;
+        }
+
+        for (uint8_t c: { ' ', '\t', '\n', '\v', '\f', '\r' })
+        {
+            decode[c] = SKIP;
+        }
+
+        for (std::size_t c = 0; c < 256; ++c)
+        {
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                quanta[k][c] = decode[c] < 64 ? uint32_t(decode[c]) << (18 - 6 * k) : QUANTUM_INVALID;
+            }
+        }
+    }
+
+    /// \brief Two characters for each 12 bit value.
+    uint8_t standardPairs[4096][2];
+    uint8_t urlSafePairs[4096][2];
+
+    /// \brief The 6 bit value of each character, INVALID or SKIP.
+    uint8_t decode[256];
+
+    /// \brief The value of each character, shifted to each position of a
+    /// quantum, or QUANTUM_INVALID.
+    uint32_t quanta[4][256];
+};
+
+
+const Tables& tables()
+{
+    static const Tables tables;
+    return tables;
+}
+
+
+#if defined(OFX_IO_BASE64_AVX2)
+
+
+bool hasAVX2()
+{
+#if defined(__GNUC__)
+    static const bool supported = []() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return supported;
+#else
+    return true;
+#endif
+}
+
+
+/// \brief Encode groups 8 at a time, returning the number encoded.
+///
+/// Each block reads 28 bytes and consumes 24, so the last few groups are
+/// always left for the scalar codec.
+OFX_IO_BASE64_AVX2_TARGET
+std::size_t encodeAVX2(const uint8_t* in,
+                       std::size_t groups,
+                       uint8_t* out,
+                       bool isUrlSafe)
+{
+    // Spread each 3 byte group over a 32-bit lane, in the order the
+    // multiplies below expect.
+    const __m256i shuffle = _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+
+    // The offset from each 6 bit value range to its ASCII range.
+    const __m256i offsets = isUrlSafe
+        ? _mm256_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -17, 32, 0, 0,
+                           65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -17, 32, 0, 0)
+        : _mm256_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0,
+                           65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+
+    std::size_t g = 0;
+
+    for (; g + 10 <= groups; g += 8, in += 24, out += 32)
+    {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 12));
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        v = _mm256_shuffle_epi8(v, shuffle);
+
+        // Split each lane into four 6 bit values.
+        __m256i t0 = _mm256_and_si256(v, _mm256_set1_epi32(0x0FC0FC00));
+        __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        __m256i t2 = _mm256_and_si256(v, _mm256_set1_epi32(0x003F03F0));
+        __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        __m256i values = _mm256_or_si256(t1, t3);
+
+        // 0-25 use offset 0, 26-51 offset 1, 52-61 offsets 2-11, 62 and 63
+        // offsets 12 and 13.
+        __m256i index = _mm256_subs_epu8(values, _mm256_set1_epi8(51));
+        __m256i isNotUpper = _mm256_cmpgt_epi8(values, _mm256_set1_epi8(25));
+        index = _mm256_sub_epi8(index, isNotUpper);
+
+        __m256i chars = _mm256_add_epi8(values, _mm256_shuffle_epi8(offsets, index));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), chars);
+    }
+
+    return g;
+}
+
+
+/// \brief Decode characters 32 at a time, returning the number consumed.
+///
+/// Each block writes 32 bytes and produces 24, so blocks are only decoded
+/// while 44 or more characters remain. Decoding stops at the first block
+/// that is not entirely made of Base64 characters.
+OFX_IO_BASE64_AVX2_TARGET
+std::size_t decodeAVX2(const uint8_t* in, std::size_t size, uint8_t* out)
+{
+    const __m256i shuffle = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+    const __m256i pack = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+
+    // A character is valid when the bit of its high nibble is clear in the
+    // entry of its low nibble. High nibbles 0, 1 and 8-15 are never valid.
+    const __m256i validLow = _mm256_setr_epi8(
+        0x55, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x43, 0x6A, 0x6B, 0x6A, 0x6B, 0x62,
+        0x55, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x43, 0x6A, 0x6B, 0x6A, 0x6B, 0x62);
+    const __m256i validHigh = _mm256_setr_epi8(
+        0x40, 0x40, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+        0x40, 0x40, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40);
+
+    // The offset to each 6 bit value by high nibble. The unused slots 0, 1
+    // and 8 hold the offsets of `-`, `/` and `_`.
+    const __m256i offsets = _mm256_setr_epi8(
+        17, 16, 19, 4, -65, -65, -71, -71, -32, 0, 0, 0, 0, 0, 0, 0,
+        17, 16, 19, 4, -65, -65, -71, -71, -32, 0, 0, 0, 0, 0, 0, 0);
+
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+
+    std::size_t i = 0;
+
+    for (; i + 44 <= size; i += 32, out += 24)
+    {
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i high = _mm256_and_si256(_mm256_srli_epi32(c, 4), nibble);
+        __m256i low = _mm256_and_si256(c, nibble);
+
+        if (!_mm256_testz_si256(_mm256_shuffle_epi8(validLow, low),
+                                _mm256_shuffle_epi8(validHigh, high)))
+        {
+            break;
+        }
+
+        // Move `-` from slot 2 to 0, `/` from 2 to 1 and `_` from 5 to 8.
+        __m256i isMinus = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('-'));
+        __m256i index = _mm256_add_epi8(high, _mm256_cmpeq_epi8(c, _mm256_set1_epi8('/')));
+        index = _mm256_add_epi8(index, _mm256_add_epi8(isMinus, isMinus));
+        index = _mm256_add_epi8(index, _mm256_and_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('_')),
+                                                        _mm256_set1_epi8(3)));
+
+        __m256i values = _mm256_add_epi8(c, _mm256_shuffle_epi8(offsets, index));
+
+        // Merge four 6 bit values into 24 bits per 32-bit lane, then pack
+        // the three bytes of each lane in big endian order.
+        __m256i merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+        merged = _mm256_shuffle_epi8(merged, shuffle);
+        merged = _mm256_permutevar8x32_epi32(merged, pack);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), merged);
+    }
+
+    return i;
+}
+
+
+#elif defined(OFX_IO_BASE64_NEON)
+
+
+/// \brief Encode groups 16 at a time, returning the number encoded.
+std::size_t encodeNEON(const uint8_t* in,
+                       std::size_t groups,
+                       uint8_t* out,
+                       bool isUrlSafe)
+{
+    const uint8_t* alphabet = reinterpret_cast<const uint8_t*>(isUrlSafe ? URL_SAFE_ALPHABET : STANDARD_ALPHABET);
+
+    uint8x16x4_t table;
+    table.val[0] = vld1q_u8(alphabet);
+    table.val[1] = vld1q_u8(alphabet + 16);
+    table.val[2] = vld1q_u8(alphabet + 32);
+    table.val[3] = vld1q_u8(alphabet + 48);
+
+    const uint8x16_t mask = vdupq_n_u8(0x3F);
+
+    std::size_t g = 0;
+
+    for (; g + 16 <= groups; g += 16, in += 48, out += 64)
+    {
+        uint8x16x3_t bytes = vld3q_u8(in);
+        uint8x16x4_t chars;
+
+        chars.val[0] = vshrq_n_u8(bytes.val[0], 2);
+        chars.val[1] = vandq_u8(vorrq_u8(vshrq_n_u8(bytes.val[1], 4), vshlq_n_u8(bytes.val[0], 4)), mask);
+        chars.val[2] = vandq_u8(vorrq_u8(vshrq_n_u8(bytes.val[2], 6), vshlq_n_u8(bytes.val[1], 2)), mask);
+        chars.val[3] = vandq_u8(bytes.val[2], mask);
+
+        chars.val[0] = vqtbl4q_u8(table, chars.val[0]);
+        chars.val[1] = vqtbl4q_u8(table, chars.val[1]);
+        chars.val[2] = vqtbl4q_u8(table, chars.val[2]);
+        chars.val[3] = vqtbl4q_u8(table, chars.val[3]);
+
+        vst4q_u8(out, chars);
+    }
+
+    return g;
+}
+
+
+/// \brief Look up the 6 bit values of 16 characters.
+///
+/// Characters above 127 are mapped to INVALID.
+inline uint8x16_t decodeNEON(const uint8x16x4_t& lo,
+                             const uint8x16x4_t& hi,
+                             uint8x16_t c)
+{
+    uint8x16_t values = vqtbl4q_u8(lo, c);
+    values = vqtbx4q_u8(values, hi, vsubq_u8(c, vdupq_n_u8(64)));
+    return vorrq_u8(values, vcgeq_u8(c, vdupq_n_u8(128)));
+}
+
+
+/// \brief Decode characters 64 at a time, returning the number consumed.
+///
+/// Decoding stops at the first block that is not entirely made of Base64
+/// characters.
+std::size_t decodeNEON(const uint8_t* in, std::size_t size, uint8_t* out)
+{
+    const uint8_t* table = tables().decode;
+
+    uint8x16x4_t lo;
+    lo.val[0] = vld1q_u8(table);
+    lo.val[1] = vld1q_u8(table + 16);
+    lo.val[2] = vld1q_u8(table + 32);
+    lo.val[3] = vld1q_u8(table + 48);
+
+    uint8x16x4_t hi;
+    hi.val[0] = vld1q_u8(table + 64);
+    hi.val[1] = vld1q_u8(table + 80);
+    hi.val[2] = vld1q_u8(table + 96);
+    hi.val[3] = vld1q_u8(table + 112);
+
+    std::size_t i = 0;
+
+    for (; i + 64 <= size; i += 64, out += 48)
+    {
+        uint8x16x4_t chars = vld4q_u8(in + i);
+
+        uint8x16_t v0 = decodeNEON(lo, hi, chars.val[0]);
+        uint8x16_t v1 = decodeNEON(lo, hi, chars.val[1]);
+        uint8x16_t v2 = decodeNEON(lo, hi, chars.val[2]);
+        uint8x16_t v3 = decodeNEON(lo, hi, chars.val[3]);
+
+        // INVALID and SKIP are both 64 or more.
+        if (vmaxvq_u8(vorrq_u8(vorrq_u8(v0, v1), vorrq_u8(v2, v3))) >= 64)
+        {
+            break;
+        }
+
+        uint8x16x3_t bytes;
+        bytes.val[0] = vorrq_u8(vshlq_n_u8(v0, 2), vshrq_n_u8(v1, 4));
+        bytes.val[1] = vorrq_u8(vshlq_n_u8(v1, 4), vshrq_n_u8(v2, 2));
+        bytes.val[2] = vorrq_u8(vshlq_n_u8(v2, 6), v3);
+
+        vst3q_u8(out, bytes);
+    }
+
+    return i;
+}
+
+
+#endif
+
+
+/// \brief Encode whole 3 byte groups without line breaks or padding.
+void encodeGroups(const uint8_t* in,
+                  std::size_t groups,
+                  uint8_t* out,
+                  bool isUrlSafe)
+{
+    std::size_t g = 0;
+
+#if defined(OFX_IO_BASE64_AVX2)
+    if (hasAVX2())
+    {
+        g = encodeAVX2(in, groups, out, isUrlSafe);
+    }
+#elif defined(OFX_IO_BASE64_NEON)
+    g = encodeNEON(in, groups, out, isUrlSafe);
+#endif
+
+    in += g * 3;
+    out += g * 4;
+
+    const uint8_t (*pairs)[2] = isUrlSafe ? tables().urlSafePairs : tables().standardPairs;
+
+    for (; g < groups; ++g, in += 3, out += 4)
+    {
+        uint32_t bits = (uint32_t(in[0]) << 16) | (uint32_t(in[1]) << 8) | in[2];
+        std::memcpy(out, pairs[bits >> 12], 2);
+        std::memcpy(out + 2, pairs[bits & 0xFFF], 2);
+    }
+}
+
+
+/// \brief Decode whole 4 character quanta, returning the number consumed.
+///
+/// Decoding stops at the first quantum that is not entirely made of Base64
+/// characters, which is then left for the caller.
+std::size_t decodeQuanta(const uint8_t* in, std::size_t size, uint8_t* out)
+{
+    std::size_t i = 0;
+
+#if defined(OFX_IO_BASE64_AVX2)
+    if (hasAVX2())
+    {
+        i = decodeAVX2(in, size, out);
+    }
+#elif defined(OFX_IO_BASE64_NEON)
+    i = decodeNEON(in, size, out);
+#endif
+
+    out += i / 4 * 3;
+
+    const uint32_t (*quanta)[256] = tables().quanta;
+
+    for (; i + 4 <= size; i += 4, out += 3)
+    {
+        uint32_t bits = quanta[0][in[i]]
+                      | quanta[1][in[i + 1]]
+                      | quanta[2][in[i + 2]]
+                      | quanta[3][in[i + 3]];
+
+        if (bits & QUANTUM_INVALID)
+        {
+            break;
+        }
+
+        out[0] = uint8_t(bits >> 16);
+        out[1] = uint8_t(bits >> 8);
+        out[2] = uint8_t(bits);
+    }
+
+    return i;
+}
+
+
+/// \brief The state of a decoder between chunks of input.
+struct DecodeState
+{
+    /// \brief The bits of a partial quantum.
+    uint32_t bits = 0;
+
+    /// \brief The number of characters in the partial quantum.
+    std::size_t count = 0;
+
+    /// \brief True once padding or an invalid character has been read.
+    bool isDone = false;
+};
+
+
+/// \brief Decode a chunk of input, keeping a trailing partial quantum.
+/// \returns the end of the decoded bytes.
+uint8_t* decodeChunk(const uint8_t* in,
+                     std::size_t size,
+                     uint8_t* out,
+                     DecodeState& state)
+{
+    const uint8_t* table = tables().decode;
+    const uint8_t* end = in + size;
+    const uint8_t* bulkFrom = in;
+
+    uint32_t bits = state.bits;
+    std::size_t count = state.count;
+
+    while (!state.isDone && in < end)
+    {
+        // Between quanta, decode in bulk until a quantum contains padding,
+        // whitespace or an invalid character, then step over that quantum
+        // one character at a time.
+        if (count == 0 && in >= bulkFrom)
+        {
+            std::size_t consumed = decodeQuanta(in, static_cast<std::size_t>(end - in), out);
+            in += consumed;
+            out += consumed / 4 * 3;
+            bulkFrom = in + 4;
+
+            if (in == end)
+            {
+                break;
+            }
+        }
+
+        uint8_t value = table[*in++];
+
+        if (value < 64)
+        {
+            bits = (bits << 6) | value;
+
+            if (++count == 4)
+            {
+                out[0] = uint8_t(bits >> 16);
+                out[1] = uint8_t(bits >> 8);
+                out[2] = uint8_t(bits);
+                out += 3;
+                bits = 0;
+                count = 0;
+            }
+        }
+        else if (value != SKIP)
+        {
+            // Padding or an invalid character.
+            state.isDone = true;
+        }
+    }
+
+    state.bits = bits;
+    state.count = count;
+    return out;
+}
+
+
+/// \brief Flush a final partial quantum and reset the state.
+///
+/// A single character holds no whole byte and is dropped.
+///
+/// \returns the end of the decoded bytes.
+uint8_t* flushQuantum(uint8_t* out, DecodeState& state)
+{
+    if (state.count == 2)
+    {
+        *out++ = uint8_t(state.bits >> 4);
+    }
+    else if (state.count == 3)
+    {
+        *out++ = uint8_t(state.bits >> 10);
+        *out++ = uint8_t(state.bits >> 2);
+    }
+
+    state = DecodeState();
+    return out;
+}
+
+
+/// \brief An incremental Base64 encoder.
+class Base64StreamEncoder: public AbstractByteTransform
+{
+public:
+    Base64StreamEncoder(bool isUrlSafe, bool isChunked, bool isPadded):
+        _isUrlSafe(isUrlSafe),
+        _isChunked(isChunked),
+        _isPadded(isPadded)
+    {
+    }
+
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        const uint8_t* in = buffer.getPtr();
+        std::size_t size = buffer.size();
+
+        const std::size_t groups = (_pendingSize + size) / 3;
+        const std::size_t offset = outputBuffer.size();
+        outputBuffer.resize(offset + groups * 4 + (groups / LINE_GROUPS + 1) * 2);
+
+        uint8_t* out = outputBuffer.getPtr() + offset;
+
+        if (_pendingSize > 0)
+        {
+            while (_pendingSize < 3 && size > 0)
+            {
+                _pending[_pendingSize++] = *in++;
+                --size;
+            }
+
+            if (_pendingSize == 3)
+            {
+                out = encodeGroups(_pending, 1, out);
+                _pendingSize = 0;
+            }
+        }
+
+        out = encodeGroups(in, size / 3, out);
+        in += size / 3 * 3;
+        size -= size / 3 * 3;
+
+        while (size-- > 0)
+        {
+            _pending[_pendingSize++] = *in++;
+        }
+
+        std::size_t written = static_cast<std::size_t>(out - (outputBuffer.getPtr() + offset));
+        outputBuffer.resize(offset + written);
+        return written;
+    }
+
+    std::size_t finish(ByteBuffer& outputBuffer) override
+    {
+        std::size_t written = 0;
+
+        if (_pendingSize > 0)
+        {
+            uint8_t tail[4];
+            written = Base64Encoding::encode(_pending, _pendingSize, tail, _isUrlSafe, false, _isPadded);
+            outputBuffer.writeBytes(tail, written);
+        }
+
+        reset();
+        return written;
+    }
+
+    void reset() override
+    {
+        _pendingSize = 0;
+        _lineGroups = 0;
+    }
+
+private:
+    /// \brief Encode whole groups, breaking lines if chunked.
+    uint8_t* encodeGroups(const uint8_t* in, std::size_t groups, uint8_t* out)
+    {
+        if (!_isChunked)
+        {
+            return out + Base64Encoding::encode(in, groups * 3, out, _isUrlSafe);
+        }
+
+        while (groups > 0)
+        {
+            std::size_t n = std::min(groups, LINE_GROUPS - _lineGroups);
+            out += Base64Encoding::encode(in, n * 3, out, _isUrlSafe);
+            in += n * 3;
+            groups -= n;
+            _lineGroups += n;
+
+            if (_lineGroups == LINE_GROUPS)
+            {
+                *out++ = '\r';
+                *out++ = '\n';
+                _lineGroups = 0;
+            }
+        }
+
+        return out;
+    }
+
+    bool _isUrlSafe = false;
+    bool _isChunked = false;
+    bool _isPadded = false;
+
+    /// \brief Input bytes that do not yet form a whole group.
+    uint8_t _pending[3];
+    std::size_t _pendingSize = 0;
+
+    /// \brief The number of groups on the current chunked line.
+    std::size_t _lineGroups = 0;
+
+};
+
+
+/// \brief An incremental Base64 decoder.
+class Base64StreamDecoder: public AbstractByteTransform
+{
+public:
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        // The bulk decoders may write up to 32 bytes past the decoded size
+        // when a partial quantum is carried over from the last chunk.
+        const std::size_t offset = outputBuffer.size();
+        outputBuffer.resize(offset + Base64Encoding::maximumDecodedSize(buffer.size()) + 32);
+
+        uint8_t* begin = outputBuffer.getPtr() + offset;
+        uint8_t* end = decodeChunk(buffer.getPtr(), buffer.size(), begin, _state);
+
+        std::size_t written = static_cast<std::size_t>(end - begin);
+        outputBuffer.resize(offset + written);
+        return written;
+    }
+
+    std::size_t finish(ByteBuffer& outputBuffer) override
+    {
+        uint8_t tail[2];
+        std::size_t written = static_cast<std::size_t>(flushQuantum(tail, _state) - tail);
+        return outputBuffer.writeBytes(tail, written);
+    }
+
+    void reset() override
+    {
+        _state = DecodeState();
+    }
+
+private:
+    DecodeState _state;
+
+};
+
+
+} // namespace
+
+
 Base64Encoding::Base64Encoding(bool isUrlSafe,
                                bool isChunked,
                                bool isPadded):
@@ -36,59 +694,169 @@ Base64Encoding::~Base64Encoding()
 
 std::size_t Base64Encoding::encode(const ByteBuffer& buffer,
                                    ByteBuffer& encodedBuffer)
+{
+    return encode(ByteBufferView(buffer), encodedBuffer);
+}
+
+
+std::size_t Base64Encoding::decode(const ByteBuffer& buffer,
+                                   ByteBuffer& decodedBuffer)
+{
+    return decode(ByteBufferView(buffer), decodedBuffer);
+}
+
+
+std::size_t Base64Encoding::encode(const ByteBufferView& buffer,
+                                   ByteBuffer& encodedBuffer)
 {
     encodedBuffer.clear();
-    ByteBufferOutputStream os(encodedBuffer);
-    Poco::Base64Encoder _encoder(os);
+    encodedBuffer.resize(encodedSize(buffer.size(), _isChunked, _isPadded));
+
+    if (buffer.size() > 0)
+    {
+        encode(buffer.getPtr(),
+               buffer.size(),
+               encodedBuffer.getPtr(),
+               _isUrlSafe,
+               _isChunked,
+               _isPadded);
+    }
+
+    return encodedBuffer.size();
+}
 
-    ByteBufferUtils::copyBufferToStream(buffer, _encoder);
 
-    _encoder.close(); // Flush bytes.
+std::size_t Base64Encoding::decode(const ByteBufferView& buffer,
+                                   ByteBuffer& decodedBuffer)
+{
+    decodedBuffer.clear();
 
-    if (!_isPadded)
+    if (buffer.size() > 0)
     {
-        encodedBuffer.remove('=');
+        decodedBuffer.resize(maximumDecodedSize(buffer.size()));
+        std::size_t size = decode(buffer.getPtr(),
+                                  buffer.size(),
+                                  decodedBuffer.getPtr());
+        decodedBuffer.resize(size);
     }
 
-    if (!_isChunked)
+    return decodedBuffer.size();
+}
+
+
+std::unique_ptr<AbstractByteTransform> Base64Encoding::createStreamEncoder()
+{
+    return std::make_unique<Base64StreamEncoder>(_isUrlSafe, _isChunked, _isPadded);
+}
+
+
+std::unique_ptr<AbstractByteTransform> Base64Encoding::createStreamDecoder()
+{
+    return std::make_unique<Base64StreamDecoder>();
+}
+
+
+std::size_t Base64Encoding::encode(const uint8_t* buffer,
+                                   std::size_t size,
+                                   uint8_t* encodedBuffer,
+                                   bool isUrlSafe,
+                                   bool isChunked,
+                                   bool isPadded)
+{
+    const std::size_t groups = size / 3;
+
+    uint8_t* out = encodedBuffer;
+    std::size_t g = 0;
+
+    if (isChunked)
     {
-        encodedBuffer.remove('\r');
-        encodedBuffer.remove('\n');
+        // Like Poco::Base64Encoder, a line break follows every full line of
+        // whole groups, but never the final partial group.
+        for (; g + LINE_GROUPS <= groups; g += LINE_GROUPS)
+        {
+            encodeGroups(buffer + g * 3, LINE_GROUPS, out, isUrlSafe);
+            out += LINE_LENGTH;
+            *out++ = '\r';
+            *out++ = '\n';
+        }
     }
 
-    if (_isUrlSafe)
+    encodeGroups(buffer + g * 3, groups - g, out, isUrlSafe);
+    out += (groups - g) * 4;
+
+    const std::size_t remainder = size - groups * 3;
+
+    if (remainder > 0)
     {
-        encodedBuffer.replace('+', '-');
-        encodedBuffer.replace('/', '_');
+        const char* alphabet = isUrlSafe ? URL_SAFE_ALPHABET : STANDARD_ALPHABET;
+        const uint8_t* in = buffer + groups * 3;
+
+        uint32_t bits = uint32_t(in[0]) << 16;
+
+        if (remainder == 2)
+        {
+            bits |= uint32_t(in[1]) << 8;
+        }
+
+        *out++ = alphabet[bits >> 18];
+        *out++ = alphabet[(bits >> 12) & 63];
+
+        if (remainder == 2)
+        {
+            *out++ = alphabet[(bits >> 6) & 63];
+        }
+        else if (isPadded)
+        {
+            *out++ = '=';
+        }
+
+        if (isPadded)
+        {
+            *out++ = '=';
+        }
     }
 
-    return encodedBuffer.size();
+    return static_cast<std::size_t>(out - encodedBuffer);
 }
 
-std::size_t Base64Encoding::decode(const ByteBuffer& buffer,
-                                   ByteBuffer& decodedBuffer)
+
+std::size_t Base64Encoding::decode(const uint8_t* buffer,
+                                   std::size_t size,
+                                   uint8_t* decodedBuffer)
 {
-    ByteBuffer _buffer(buffer);
-    decodedBuffer.clear();
+    DecodeState state;
+    uint8_t* out = decodeChunk(buffer, size, decodedBuffer, state);
+    out = flushQuantum(out, state);
+    return static_cast<std::size_t>(out - decodedBuffer);
+}
+
 
-    if (_isUrlSafe)
+std::size_t Base64Encoding::encodedSize(std::size_t size,
+                                        bool isChunked,
+                                        bool isPadded)
+{
+    const std::size_t groups = size / 3;
+    const std::size_t remainder = size - groups * 3;
+
+    std::size_t encoded = groups * 4;
+
+    if (remainder > 0)
     {
-        _buffer.replace('-', '+');
-        _buffer.replace('_', '/');
+        encoded += isPadded ? 4 : remainder + 1;
     }
 
-    std::size_t m4 = (_buffer.size() % 4);
-
-    if (m4 != 0)
+    if (isChunked)
     {
-        _buffer.writeBytes(ByteBuffer(4 - m4, '='));
+        encoded += (groups / LINE_GROUPS) * 2;
     }
 
-    ByteBufferInputStream is(_buffer);
+    return encoded;
+}
 
-    Poco::Base64Decoder _decoder(is);
 
-    return ByteBufferUtils::copyStreamToBuffer(_decoder, decodedBuffer);
+std::size_t Base64Encoding::maximumDecodedSize(std::size_t size)
+{
+    return (size + 3) / 4 * 3;
 }
 
 
@@ -97,30 +865,43 @@ std::string Base64Encoding::encode(const std::string& buffer,
                                    bool isChunked,
                                    bool isPadded)
 {
-    return encode(ByteBuffer(buffer), isUrlSafe, isChunked, isPadded);
+    return encode(ByteBufferView(buffer), isUrlSafe, isChunked, isPadded);
 }
 
 
-std::string Base64Encoding::encode(const ByteBuffer& buffer,
+std::string Base64Encoding::encode(const ByteBufferView& buffer,
                                    bool isUrlSafe,
                                    bool isChunked,
                                    bool isPadded)
 {
-    Base64Encoding encoder(isUrlSafe, isChunked, isPadded);
-    ByteBuffer _output;
-    encoder.encode(buffer, _output);
-    return _output.toString();
-}
+    std::string output(encodedSize(buffer.size(), isChunked, isPadded), '\0');
+
+    if (!output.empty())
+    {
+        encode(buffer.getPtr(),
+               buffer.size(),
+               reinterpret_cast<uint8_t*>(&output[0]),
+               isUrlSafe,
+               isChunked,
+               isPadded);
+    }
 
+    return output;
+}
 
 
-std::string Base64Encoding::decode(const std::string& buffer, bool isUrlSafe)
+std::string Base64Encoding::decode(const std::string& buffer, bool)
 {
-    ByteBuffer _buffer(buffer);
-    ByteBuffer output;
-    Base64Encoding decoder(isUrlSafe);
-    decoder.decode(_buffer, output);
-    return output.toString();
+    std::string output(maximumDecodedSize(buffer.size()), '\0');
+
+    if (!output.empty())
+    {
+        output.resize(decode(reinterpret_cast<const uint8_t*>(buffer.data()),
+                             buffer.size(),
+                             reinterpret_cast<uint8_t*>(&output[0])));
+    }
+
+    return output;
 }
 
 
@@ -6,6 +6,21 @@
 
 
 #include "ofx/IO/ByteBuffer.h"
+#include <cstring>
+
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OFX_IO_BYTE_BUFFER_SSE2 1
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__aarch64__)
+#include <arm_neon.h>
+#define OFX_IO_BYTE_BUFFER_NEON 1
+#endif
+
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 
 #ifdef min
@@ -19,6 +34,300 @@
 namespace ofx {
 namespace IO {
 
+
+namespace {
+
+
+/// \brief The largest set of bytes that is matched with SIMD compares.
+const std::size_t MAXIMUM_SIMD_MATCHES = 8;
+
+
+/// \brief Index of the lowest set bit of a non-zero mask.
+inline unsigned lowestBit(uint64_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
+
+
+#if defined(OFX_IO_BYTE_BUFFER_SSE2)
+typedef __m128i Vector;
+
+inline Vector load(const uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+inline void store(uint8_t* p, Vector v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+inline Vector splat(uint8_t b) { return _mm_set1_epi8(static_cast<char>(b)); }
+inline Vector equal(Vector a, Vector b) { return _mm_cmpeq_epi8(a, b); }
+inline Vector either(Vector a, Vector b) { return _mm_or_si128(a, b); }
+inline Vector select(Vector mask, Vector a, Vector b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+/// \brief One bit per byte lane.
+inline uint64_t bits(Vector mask) { return static_cast<uint64_t>(_mm_movemask_epi8(mask)); }
+const unsigned BITS_PER_LANE = 1;
+#elif defined(OFX_IO_BYTE_BUFFER_NEON)
+typedef uint8x16_t Vector;
+
+inline Vector load(const uint8_t* p) { return vld1q_u8(p); }
+inline void store(uint8_t* p, Vector v) { vst1q_u8(p, v); }
+inline Vector splat(uint8_t b) { return vdupq_n_u8(b); }
+inline Vector equal(Vector a, Vector b) { return vceqq_u8(a, b); }
+inline Vector either(Vector a, Vector b) { return vorrq_u8(a, b); }
+inline Vector select(Vector mask, Vector a, Vector b) { return vbslq_u8(mask, a, b); }
+/// \brief Four bits per byte lane, via a narrowing shift.
+inline uint64_t bits(Vector mask) { return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(mask), 4)), 0); }
+const unsigned BITS_PER_LANE = 4;
+#endif
+
+
+/// \brief Matches bytes against a ByteSet.
+///
+/// Small sets are matched with one SIMD compare per member, larger sets fall
+/// back to the ByteSet bitmap.
+class Matcher
+{
+public:
+    explicit Matcher(const ByteSet& set): _set(set)
+    {
+        for (int byte = 0; byte < 256; ++byte)
+        {
+            if (set.contains(static_cast<uint8_t>(byte)))
+            {
+                if (_size < MAXIMUM_SIMD_MATCHES)
+                {
+#if defined(OFX_IO_BYTE_BUFFER_SSE2) || defined(OFX_IO_BYTE_BUFFER_NEON)
+                    _needles[_size] = splat(static_cast<uint8_t>(byte));
+#endif
+                }
+
+                ++_size;
+            }
+        }
+    }
+
+    /// \returns true if the SIMD match() can be used.
+    bool vectorized() const
+    {
+#if defined(OFX_IO_BYTE_BUFFER_SSE2) || defined(OFX_IO_BYTE_BUFFER_NEON)
+        return _size > 0 && _size <= MAXIMUM_SIMD_MATCHES;
+#else
+        return false;
+#endif
+    }
+
+    bool contains(uint8_t byte) const
+    {
+        return _set.contains(byte);
+    }
+
+#if defined(OFX_IO_BYTE_BUFFER_SSE2) || defined(OFX_IO_BYTE_BUFFER_NEON)
+    /// \returns a mask with all bits set in the lanes that match.
+    Vector match(Vector v) const
+    {
+        Vector mask = equal(v, _needles[0]);
+
+        for (std::size_t i = 1; i < _size; ++i)
+        {
+            mask = either(mask, equal(v, _needles[i]));
+        }
+
+        return mask;
+    }
+#endif
+
+private:
+    const ByteSet& _set;
+    std::size_t _size = 0;
+
+#if defined(OFX_IO_BYTE_BUFFER_SSE2) || defined(OFX_IO_BYTE_BUFFER_NEON)
+    Vector _needles[MAXIMUM_SIMD_MATCHES];
+#endif
+
+};
+
+
+std::size_t findKernel(const uint8_t* data, std::size_t size, const ByteSet& set)
+{
+    Matcher matcher(set);
+    std::size_t i = 0;
+
+#if defined(OFX_IO_BYTE_BUFFER_SSE2) || defined(OFX_IO_BYTE_BUFFER_NEON)
+    if (matcher.vectorized())
+    {
+        for (; i + 16 <= size; i += 16)
+        {
+            uint64_t mask = bits(matcher.match(load(data + i)));
+
+            if (mask != 0)
+            {
+                return i + lowestBit(mask) / BITS_PER_LANE;
+            }
+        }
+    }
+#endif
+
+    for (; i < size; ++i)
+    {
+        if (matcher.contains(data[i])) return i;
+    }
+
+    return size;
+}
+
+
+std::size_t countKernel(const uint8_t* data, std::size_t size, const ByteSet& set)
+{
+    Matcher matcher(set);
+    std::size_t total = 0;
+    std::size_t i = 0;
+
+#if defined(OFX_IO_BYTE_BUFFER_SSE2)
+    if (matcher.vectorized())
+    {
+        const __m128i zero = _mm_setzero_si128();
+
+        while (i + 16 <= size)
+        {
+            // Per-lane counters are 8 bits wide, so flush every 255 blocks.
+            __m128i counts = zero;
+            std::size_t blocks = std::min<std::size_t>((size - i) / 16, 255);
+
+            for (std::size_t b = 0; b < blocks; ++b, i += 16)
+            {
+                counts = _mm_sub_epi8(counts, matcher.match(load(data + i)));
+            }
+
+            __m128i sums = _mm_sad_epu8(counts, zero);
+            uint64_t lanes[2];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sums);
+            total += static_cast<std::size_t>(lanes[0] + lanes[1]);
+        }
+    }
+#elif defined(OFX_IO_BYTE_BUFFER_NEON)
+    if (matcher.vectorized())
+    {
+        while (i + 16 <= size)
+        {
+            uint8x16_t counts = vdupq_n_u8(0);
+            std::size_t blocks = std::min<std::size_t>((size - i) / 16, 255);
+
+            for (std::size_t b = 0; b < blocks; ++b, i += 16)
+            {
+                counts = vsubq_u8(counts, matcher.match(load(data + i)));
+            }
+
+            total += vaddlvq_u8(counts);
+        }
+    }
+#endif
+
+    for (; i < size; ++i)
+    {
+        if (matcher.contains(data[i])) ++total;
+    }
+
+    return total;
+}
+
+
+std::size_t removeKernel(uint8_t* data, std::size_t size, const ByteSet& set)
+{
+    Matcher matcher(set);
+    std::size_t write = 0;
+    std::size_t i = 0;
+
+#if defined(OFX_IO_BYTE_BUFFER_SSE2) || defined(OFX_IO_BYTE_BUFFER_NEON)
+    if (matcher.vectorized())
+    {
+        for (; i + 16 <= size; i += 16)
+        {
+            Vector v = load(data + i);
+            uint64_t mask = bits(matcher.match(v));
+
+            if (mask == 0)
+            {
+                // Blocks without matches move as a whole. The store never
+                // reaches past the block that was just loaded.
+                if (write != i) store(data + write, v);
+                write += 16;
+            }
+            else
+            {
+                uint8_t block[16];
+                store(block, v);
+
+                for (unsigned j = 0; j < 16; ++j)
+                {
+                    if (((mask >> (j * BITS_PER_LANE)) & 1) == 0)
+                    {
+                        data[write++] = block[j];
+                    }
+                }
+            }
+        }
+    }
+#endif
+
+    for (; i < size; ++i)
+    {
+        if (!matcher.contains(data[i])) data[write++] = data[i];
+    }
+
+    return write;
+}
+
+
+void replaceKernel(uint8_t* data,
+                   std::size_t size,
+                   const uint8_t* from,
+                   const uint8_t* to,
+                   std::size_t numPairs)
+{
+    std::size_t i = 0;
+
+#if defined(OFX_IO_BYTE_BUFFER_SSE2) || defined(OFX_IO_BYTE_BUFFER_NEON)
+    Vector fromVectors[MAXIMUM_SIMD_MATCHES];
+    Vector toVectors[MAXIMUM_SIMD_MATCHES];
+
+    for (std::size_t p = 0; p < numPairs; ++p)
+    {
+        fromVectors[p] = splat(from[p]);
+        toVectors[p] = splat(to[p]);
+    }
+
+    for (; i + 16 <= size; i += 16)
+    {
+        Vector v = load(data + i);
+        Vector result = v;
+
+        // Compare against the original bytes so that pairs do not chain.
+        for (std::size_t p = 0; p < numPairs; ++p)
+        {
+            result = select(equal(v, fromVectors[p]), toVectors[p], result);
+        }
+
+        store(data + i, result);
+    }
+#endif
+
+    for (; i < size; ++i)
+    {
+        for (std::size_t p = 0; p < numPairs; ++p)
+        {
+            if (data[i] == from[p])
+            {
+                data[i] = to[p];
+                break;
+            }
+        }
+    }
+}
+
+
+} // namespace
+
     
 ByteBuffer::ByteBuffer()
 {
@@ -71,6 +380,12 @@ ByteBuffer::ByteBuffer(const std::vector<uint8_t>& buffer)
 }
 
 
+ByteBuffer::ByteBuffer(std::vector<uint8_t>&& buffer):
+    _buffer(std::move(buffer))
+{
+}
+
+
 ByteBuffer::ByteBuffer(const std::string& buffer)
 {
     writeBytes(buffer);
@@ -133,7 +448,6 @@ std::size_t ByteBuffer::writeByte(uint8_t data)
 
 std::size_t ByteBuffer::writeBytes(const uint8_t* buffer, std::size_t size)
 {
-    _buffer.reserve(_buffer.size() + size);
     _buffer.insert(_buffer.end(), buffer, buffer + size);
     return size;
 }
@@ -141,7 +455,6 @@ std::size_t ByteBuffer::writeBytes(const uint8_t* buffer, std::size_t size)
 
 std::size_t ByteBuffer::writeBytes(const std::vector<uint8_t>& buffer)
 {
-    _buffer.reserve(_buffer.size() + buffer.size());
     _buffer.insert(_buffer.end(), buffer.begin(), buffer.end());
     return buffer.size();
 }
@@ -156,7 +469,6 @@ std::size_t ByteBuffer::writeBytes(std::initializer_list<uint8_t> bytes)
 
 std::size_t ByteBuffer::writeBytes(const std::string& buffer)
 {
-    _buffer.reserve(_buffer.size() + buffer.size());
     _buffer.insert(_buffer.end(), buffer.begin(), buffer.end());
     return buffer.size();
 }
@@ -218,6 +530,26 @@ const std::vector<uint8_t>& ByteBuffer::getBuffer() const
 }
 
 
+std::vector<uint8_t> ByteBuffer::release()
+{
+    std::vector<uint8_t> buffer;
+    buffer.swap(_buffer);
+    return buffer;
+}
+
+
+void ByteBuffer::swap(ByteBuffer& buffer)
+{
+    _buffer.swap(buffer._buffer);
+}
+
+
+void ByteBuffer::swap(std::vector<uint8_t>& buffer)
+{
+    _buffer.swap(buffer);
+}
+
+
 uint8_t& ByteBuffer::operator [] (std::size_t n)
 {
     return _buffer[n];
@@ -358,16 +690,96 @@ std::vector<uint8_t>::const_reverse_iterator ByteBuffer::rend() const
 
 void ByteBuffer::remove(uint8_t data)
 {
-    _buffer.erase(std::remove(_buffer.begin(),
-                              _buffer.end(),
-                              data),
-                  _buffer.end());
+    remove(ByteSet({ data }));
+}
+
+
+void ByteBuffer::remove(const ByteSet& bytes)
+{
+    _buffer.resize(removeKernel(_buffer.data(), _buffer.size(), bytes));
 }
 
 
 void ByteBuffer::replace(uint8_t data, uint8_t replacement)
 {
-    std::replace(_buffer.begin(), _buffer.end(), data, replacement);
+    replaceKernel(_buffer.data(), _buffer.size(), &data, &replacement, 1);
+}
+
+
+void ByteBuffer::translate(const std::array<uint8_t, 256>& table)
+{
+    uint8_t from[MAXIMUM_SIMD_MATCHES];
+    uint8_t to[MAXIMUM_SIMD_MATCHES];
+    std::size_t numPairs = 0;
+
+    for (std::size_t byte = 0; byte < table.size(); ++byte)
+    {
+        if (table[byte] != byte)
+        {
+            if (numPairs == MAXIMUM_SIMD_MATCHES)
+            {
+                // Too many changes for compares, use a table lookup.
+                for (auto& value: _buffer) value = table[value];
+                return;
+            }
+
+            from[numPairs] = static_cast<uint8_t>(byte);
+            to[numPairs] = table[byte];
+            ++numPairs;
+        }
+    }
+
+    if (numPairs > 0)
+    {
+        replaceKernel(_buffer.data(), _buffer.size(), from, to, numPairs);
+    }
+}
+
+
+std::size_t ByteBuffer::find(uint8_t data, std::size_t offset) const
+{
+    if (offset >= _buffer.size()) return std::string::npos;
+
+    const void* p = std::memchr(_buffer.data() + offset, data, _buffer.size() - offset);
+
+    return p ? static_cast<std::size_t>(static_cast<const uint8_t*>(p) - _buffer.data())
+             : std::string::npos;
+}
+
+
+std::size_t ByteBuffer::find(const ByteSet& bytes, std::size_t offset) const
+{
+    if (offset >= _buffer.size()) return std::string::npos;
+
+    std::size_t size = _buffer.size() - offset;
+    std::size_t index = findKernel(_buffer.data() + offset, size, bytes);
+
+    return index < size ? offset + index : std::string::npos;
+}
+
+
+std::size_t ByteBuffer::count(uint8_t data) const
+{
+    return count(ByteSet({ data }));
+}
+
+
+std::size_t ByteBuffer::count(const ByteSet& bytes) const
+{
+    return countKernel(_buffer.data(), _buffer.size(), bytes);
+}
+
+
+std::array<uint8_t, 256> ByteBuffer::identityTable()
+{
+    std::array<uint8_t, 256> table;
+
+    for (std::size_t i = 0; i < table.size(); ++i)
+    {
+        table[i] = static_cast<uint8_t>(i);
+    }
+
+    return table;
 }
 
 
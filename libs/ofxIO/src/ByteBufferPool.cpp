@@ -0,0 +1,144 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/IO/ByteBufferPool.h"
+#include <algorithm>
+
+
+namespace ofx {
+namespace IO {
+
+
+ByteBufferPool::ByteBufferPool(std::size_t maximumBuffersPerSizeClass):
+    ByteBufferPool(maximumBuffersPerSizeClass, DEFAULT_MAXIMUM_CAPACITY)
+{
+}
+
+
+ByteBufferPool::ByteBufferPool(std::size_t maximumBuffersPerSizeClass,
+                               std::size_t maximumCapacity):
+    _maximumBuffersPerSizeClass(maximumBuffersPerSizeClass),
+    _maximumCapacity(maximumCapacity)
+{
+}
+
+
+ByteBufferPool::~ByteBufferPool()
+{
+}
+
+
+ByteBuffer ByteBufferPool::acquire(std::size_t capacity)
+{
+    std::size_t sizeClass = _sizeClassFor(capacity);
+
+    for (std::size_t i = sizeClass; i < NUM_SIZE_CLASSES; ++i)
+    {
+        if (!_buffers[i].empty())
+        {
+            _capacity -= _buffers[i].back().capacity();
+            ByteBuffer buffer(std::move(_buffers[i].back()));
+            _buffers[i].pop_back();
+            buffer.clear();
+
+            // Only grows requests larger than the largest size class.
+            buffer.reserve(capacity);
+            return buffer;
+        }
+    }
+
+    ByteBuffer buffer;
+    buffer.reserve(std::max(capacity, std::size_t(1) << (sizeClass + MINIMUM_SIZE_CLASS)));
+    return buffer;
+}
+
+
+void ByteBufferPool::recycle(ByteBuffer&& buffer)
+{
+    std::vector<uint8_t> storage = buffer.release();
+
+    if (storage.capacity() < (std::size_t(1) << MINIMUM_SIZE_CLASS))
+    {
+        return;
+    }
+
+    // Round down, so that every buffer in a class is at least that size.
+    std::size_t sizeClass = _sizeClassFor(storage.capacity());
+
+    if (sizeClass > 0 && (std::size_t(1) << (sizeClass + MINIMUM_SIZE_CLASS)) > storage.capacity())
+    {
+        --sizeClass;
+    }
+
+    if (_buffers[sizeClass].size() < _maximumBuffersPerSizeClass
+    && storage.capacity() <= _maximumCapacity - _capacity)
+    {
+        _capacity += storage.capacity();
+        _buffers[sizeClass].push_back(std::move(storage));
+    }
+}
+
+
+void ByteBufferPool::reset()
+{
+    for (auto& buffers: _buffers)
+    {
+        buffers.clear();
+        buffers.shrink_to_fit();
+    }
+
+    _capacity = 0;
+}
+
+
+std::size_t ByteBufferPool::size() const
+{
+    std::size_t total = 0;
+
+    for (const auto& buffers: _buffers)
+    {
+        total += buffers.size();
+    }
+
+    return total;
+}
+
+
+std::size_t ByteBufferPool::capacity() const
+{
+    return _capacity;
+}
+
+
+std::size_t ByteBufferPool::maximumCapacity() const
+{
+    return _maximumCapacity;
+}
+
+
+ByteBufferPool& ByteBufferPool::threadLocal()
+{
+    static thread_local ByteBufferPool pool;
+    return pool;
+}
+
+
+std::size_t ByteBufferPool::_sizeClassFor(std::size_t capacity)
+{
+    std::size_t sizeClass = 0;
+
+    while (sizeClass + 1 < NUM_SIZE_CLASSES &&
+           (std::size_t(1) << (sizeClass + MINIMUM_SIZE_CLASS)) < capacity)
+    {
+        ++sizeClass;
+    }
+
+    return sizeClass;
+}
+
+
+} }  // namespace ofx::IO
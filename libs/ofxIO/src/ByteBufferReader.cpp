@@ -21,21 +21,6 @@ ByteBufferReader::ByteBufferReader(const ByteBuffer& buffer, std::size_t offset)
 }
 
 
-std::size_t ByteBufferReader::_read(void* destination, std::size_t size) const
-{
-    if (_offset + size <= _buffer.size())
-    {
-        std::memcpy(destination, _buffer.getPtr() + _offset, size);
-        _offset += size;
-        return size;
-    }
-    else
-    {
-        return 0;
-    }
-}
-
-
 void ByteBufferReader::setOffset(std::size_t offset)
 {
     if (offset < _buffer.size()) _offset = offset;
@@ -6,16 +6,21 @@
 
 
 #include "ofx/IO/ByteBufferStream.h"
+#include <algorithm>
+#include <cstring>
 
 
 namespace ofx {
 namespace IO {
 
 
-ByteBufferInputStreamBuf::ByteBufferInputStreamBuf(const ByteBuffer& buffer,
-                                                   std::size_t offset):
-    _bufferReader(buffer, offset)
+ByteBufferInputStreamBuf::ByteBufferInputStreamBuf(const ByteBufferView& buffer,
+                                                   std::size_t offset)
 {
+    // The get area is never written to, so it is safe to cast away const.
+    char* begin = const_cast<char*>(buffer.getCharPtr());
+    char* end = begin + buffer.size();
+    setg(begin, begin + std::min(offset, buffer.size()), end);
 }
 
 
@@ -24,24 +29,91 @@ ByteBufferInputStreamBuf::~ByteBufferInputStreamBuf()
 }
 
 
-int ByteBufferInputStreamBuf::readFromDevice()
+ByteBufferInputStreamBuf::int_type ByteBufferInputStreamBuf::underflow()
 {
-    char byte;
+    if (gptr() < egptr())
+    {
+        return traits_type::to_int_type(*gptr());
+    }
+    else
+    {
+        return traits_type::eof();
+    }
+}
+
+
+std::streamsize ByteBufferInputStreamBuf::showmanyc()
+{
+    std::streamsize n = egptr() - gptr();
+    return n > 0 ? n : -1;
+}
+
 
-    if (_bufferReader.read(byte) > 0)
+std::streamsize ByteBufferInputStreamBuf::xsgetn(char_type* s,
+                                                 std::streamsize n)
+{
+    std::streamsize count = std::min(n, std::streamsize(egptr() - gptr()));
+
+    if (count > 0)
     {
-        return charToInt(byte);
+        std::memcpy(s, gptr(), static_cast<std::size_t>(count));
+        setg(eback(), gptr() + count, egptr());
+    }
+
+    return count;
+}
+
+
+ByteBufferInputStreamBuf::pos_type ByteBufferInputStreamBuf::seekoff(off_type off,
+                                                                     std::ios_base::seekdir dir,
+                                                                     std::ios_base::openmode which)
+{
+    if (!(which & std::ios_base::in))
+    {
+        return pos_type(off_type(-1));
+    }
+
+    off_type position = 0;
+
+    if (dir == std::ios_base::beg)
+    {
+        position = off;
+    }
+    else if (dir == std::ios_base::cur)
+    {
+        position = (gptr() - eback()) + off;
+    }
+    else if (dir == std::ios_base::end)
+    {
+        position = (egptr() - eback()) + off;
     }
     else
     {
-        return char_traits::eof();
+        return pos_type(off_type(-1));
     }
+
+    if (position < 0 || position > egptr() - eback())
+    {
+        return pos_type(off_type(-1));
+    }
+
+    setg(eback(), eback() + position, egptr());
+    return pos_type(position);
+}
+
+
+ByteBufferInputStreamBuf::pos_type ByteBufferInputStreamBuf::seekpos(pos_type pos,
+                                                                     std::ios_base::openmode which)
+{
+    return seekoff(off_type(pos), std::ios_base::beg, which);
 }
 
 
 ByteBufferOutputStreamBuf::ByteBufferOutputStreamBuf(ByteBuffer& buffer):
     _buffer(buffer)
 {
+    // There is no put area, each write is appended to the ByteBuffer.
+    setp(nullptr, nullptr);
 }
 
 
@@ -50,16 +122,28 @@ ByteBufferOutputStreamBuf::~ByteBufferOutputStreamBuf()
 }
 
 
-int ByteBufferOutputStreamBuf::writeToDevice(char byte)
+ByteBufferOutputStreamBuf::int_type ByteBufferOutputStreamBuf::overflow(int_type c)
 {
-    if (_buffer.writeByte(byte) > 0)
+    if (traits_type::eq_int_type(c, traits_type::eof()))
     {
-        return charToInt(byte);
+        return traits_type::not_eof(c);
     }
-    else
+
+    _buffer.writeByte(static_cast<uint8_t>(traits_type::to_char_type(c)));
+    return c;
+}
+
+
+std::streamsize ByteBufferOutputStreamBuf::xsputn(const char_type* s,
+                                                  std::streamsize n)
+{
+    if (n <= 0)
     {
-        return char_traits::eof();
+        return 0;
     }
+
+    _buffer.writeBytes(reinterpret_cast<const uint8_t*>(s), static_cast<std::size_t>(n));
+    return n;
 }
 
 
@@ -7,17 +7,435 @@
 
 #include "ofx/IO/ByteBufferUtils.h"
 #include "ofx/IO/ByteBuffer.h"
+#include "ofx/IO/ByteChain.h"
 #include "Poco/Buffer.h"
+#include "Poco/Exception.h"
 #include "Poco/FileStream.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <iostream> 
+#include <memory>
+#include "ofConstants.h"
 #include "ofLog.h"
 #include "ofUtils.h"
 
 
+#if !defined(TARGET_WIN32)
+#include <climits>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+
 namespace ofx {
 namespace IO {
 
 
+#if !defined(TARGET_WIN32)
+
+
+namespace {
+
+
+/// \brief The largest request passed to a single read() or write() call.
+///
+/// Linux transfers at most 0x7ffff000 bytes per call.
+const std::size_t MAXIMUM_IO_SIZE = 1 << 30;
+
+/// \brief The size of the chunks used for files of unknown size.
+const std::size_t CHUNK_IO_SIZE = 1 << 16;
+
+/// \brief The alignment required for O_DIRECT buffers, offsets and sizes.
+const std::size_t DIRECT_IO_ALIGNMENT = 4096;
+
+/// \brief The size of the aligned bounce buffer used with O_DIRECT.
+const std::size_t DIRECT_IO_BUFFER_SIZE = 1 << 20;
+
+
+/// \brief Closes a file descriptor when it goes out of scope.
+class FileDescriptor
+{
+public:
+    explicit FileDescriptor(int fd): _fd(fd)
+    {
+    }
+
+    ~FileDescriptor()
+    {
+        if (_fd >= 0) ::close(_fd);
+    }
+
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator = (const FileDescriptor&) = delete;
+
+    int get() const
+    {
+        return _fd;
+    }
+
+    /// \returns the result of close(), or 0 if already closed.
+    int close()
+    {
+        int result = _fd >= 0 ? ::close(_fd) : 0;
+        _fd = -1;
+        return result;
+    }
+
+private:
+    int _fd = -1;
+};
+
+
+/// \brief Frees memory allocated with posix_memalign().
+struct AlignedDeleter
+{
+    void operator () (uint8_t* p) const
+    {
+        std::free(p);
+    }
+};
+
+
+typedef std::unique_ptr<uint8_t, AlignedDeleter> AlignedBuffer;
+
+
+AlignedBuffer makeAlignedBuffer(std::size_t size)
+{
+    void* p = nullptr;
+
+    if (posix_memalign(&p, DIRECT_IO_ALIGNMENT, size) != 0)
+    {
+        throw std::bad_alloc();
+    }
+
+    return AlignedBuffer(static_cast<uint8_t*>(p));
+}
+
+
+/// \brief Throw the Poco exception that matches the current errno.
+void throwFileError(const std::string& path)
+{
+    int error = errno;
+
+    switch (error)
+    {
+        case ENOENT:
+        case ENOTDIR:
+            throw Poco::FileNotFoundException(path, std::strerror(error));
+        case EACCES:
+        case EPERM:
+        case EROFS:
+            throw Poco::FileAccessDeniedException(path, std::strerror(error));
+        default:
+            throw Poco::IOException(path, std::strerror(error));
+    }
+}
+
+
+/// \brief Open a file, trying O_DIRECT first if requested.
+/// \param direct Set to true if the file was opened with O_DIRECT.
+int openFile(const std::string& path, int oflags, bool useDirect, bool& direct)
+{
+    direct = false;
+
+#if defined(O_DIRECT)
+    if (useDirect)
+    {
+        int fd = ::open(path.c_str(), oflags | O_DIRECT, 0666);
+
+        // Some file systems (e.g. tmpfs) reject O_DIRECT with EINVAL.
+        if (fd >= 0 || errno != EINVAL)
+        {
+            direct = fd >= 0;
+            return fd;
+        }
+    }
+#endif
+
+    return ::open(path.c_str(), oflags, 0666);
+}
+
+
+/// \brief Turn off O_DIRECT on an open file descriptor.
+void clearDirect(int fd, bool& direct)
+{
+#if defined(O_DIRECT)
+    int oflags = ::fcntl(fd, F_GETFL);
+
+    if (oflags >= 0)
+    {
+        ::fcntl(fd, F_SETFL, oflags & ~O_DIRECT);
+    }
+#endif
+
+    direct = false;
+}
+
+
+/// \brief Read until size bytes are read or the end of the file is reached.
+/// \returns the number of bytes read.
+std::size_t readFully(int fd,
+                      uint8_t* data,
+                      std::size_t size,
+                      bool& direct,
+                      const std::string& path)
+{
+    std::size_t total = 0;
+
+    while (total < size)
+    {
+        ssize_t n = ::read(fd, data + total, std::min(size - total, MAXIMUM_IO_SIZE));
+
+        if (n > 0)
+        {
+            total += static_cast<std::size_t>(n);
+        }
+        else if (n == 0)
+        {
+            break;
+        }
+        else if (errno == EINVAL && direct)
+        {
+            // The final, unaligned block of a file is not always accepted.
+            clearDirect(fd, direct);
+        }
+        else if (errno != EINTR)
+        {
+            throwFileError(path);
+        }
+    }
+
+    return total;
+}
+
+
+/// \brief Write all bytes, retrying after short writes.
+void writeFully(int fd,
+                const uint8_t* data,
+                std::size_t size,
+                bool& direct,
+                const std::string& path)
+{
+    while (size > 0)
+    {
+        ssize_t n = ::write(fd, data, std::min(size, MAXIMUM_IO_SIZE));
+
+        if (n > 0)
+        {
+            data += n;
+            size -= static_cast<std::size_t>(n);
+        }
+        else if (n < 0 && errno == EINVAL && direct)
+        {
+            // An unaligned file offset, e.g. when appending.
+            clearDirect(fd, direct);
+        }
+        else if (n == 0 || errno != EINTR)
+        {
+            throwFileError(path);
+        }
+    }
+}
+
+
+/// \brief Write all iovecs, batching by IOV_MAX and resuming short writes.
+void writeVectors(int fd,
+                  std::vector<struct iovec>& vecs,
+                  const std::string& path)
+{
+    std::size_t index = 0;
+
+    while (index < vecs.size())
+    {
+        int count = static_cast<int>(std::min<std::size_t>(vecs.size() - index, IOV_MAX));
+        ssize_t n = ::writev(fd, &vecs[index], count);
+
+        if (n < 0)
+        {
+            if (errno == EINTR) continue;
+            throwFileError(path);
+        }
+
+        std::size_t written = static_cast<std::size_t>(n);
+        std::size_t last = index;
+
+        while (index < vecs.size() && written >= vecs[index].iov_len)
+        {
+            written -= vecs[index].iov_len;
+            ++index;
+        }
+
+        if (index < vecs.size() && written > 0)
+        {
+            vecs[index].iov_base = static_cast<uint8_t*>(vecs[index].iov_base) + written;
+            vecs[index].iov_len -= written;
+        }
+        else if (n == 0 && index == last)
+        {
+            errno = EIO;
+            throwFileError(path);
+        }
+    }
+}
+
+
+/// \brief Write all iovecs through an aligned bounce buffer for O_DIRECT.
+///
+/// Only whole bounce buffers are written with O_DIRECT. The unaligned tail
+/// is written after O_DIRECT has been cleared.
+void writeVectorsDirect(int fd,
+                        const std::vector<struct iovec>& vecs,
+                        bool& direct,
+                        const std::string& path)
+{
+    AlignedBuffer bounce = makeAlignedBuffer(DIRECT_IO_BUFFER_SIZE);
+    std::size_t used = 0;
+
+    for (const auto& vec: vecs)
+    {
+        const uint8_t* data = static_cast<const uint8_t*>(vec.iov_base);
+        std::size_t size = vec.iov_len;
+
+        while (size > 0)
+        {
+            std::size_t n = std::min(size, DIRECT_IO_BUFFER_SIZE - used);
+            std::memcpy(bounce.get() + used, data, n);
+            used += n;
+            data += n;
+            size -= n;
+
+            if (used == DIRECT_IO_BUFFER_SIZE)
+            {
+                writeFully(fd, bounce.get(), used, direct, path);
+                used = 0;
+            }
+        }
+    }
+
+    if (used > 0)
+    {
+        if (direct)
+        {
+            clearDirect(fd, direct);
+        }
+
+        writeFully(fd, bounce.get(), used, direct, path);
+    }
+}
+
+
+/// \brief Open, write and optionally sync a file from a list of iovecs.
+bool writeFile(const std::string& path,
+               std::vector<struct iovec>& vecs,
+               int flags)
+{
+    int oflags = O_WRONLY | O_CREAT | O_CLOEXEC;
+    oflags |= (flags & ByteBufferUtils::FILE_APPEND) ? O_APPEND : O_TRUNC;
+
+    bool direct = false;
+    FileDescriptor file(openFile(path,
+                                 oflags,
+                                 flags & ByteBufferUtils::FILE_DIRECT,
+                                 direct));
+
+    if (file.get() < 0)
+    {
+        throwFileError(path);
+    }
+
+    if (direct)
+    {
+        writeVectorsDirect(file.get(), vecs, direct, path);
+    }
+    else
+    {
+        writeVectors(file.get(), vecs, path);
+    }
+
+    if (flags & ByteBufferUtils::FILE_SYNC)
+    {
+#if defined(__APPLE__)
+        int result = ::fsync(file.get());
+#else
+        int result = ::fdatasync(file.get());
+#endif
+        if (result != 0)
+        {
+            throwFileError(path);
+        }
+    }
+
+    if (file.close() != 0)
+    {
+        throwFileError(path);
+    }
+
+    return true;
+}
+
+
+} // namespace
+
+
+#endif
+
+
+namespace {
+
+
+/// \brief Load a file through a Poco::FileInputStream.
+std::streamsize loadFromStream(const std::string& path,
+                               ByteBuffer& byteBuffer,
+                               bool appendBuffer,
+                               std::ios::openmode openMode)
+{
+    Poco::FileInputStream fis(ofToDataPath(path, true), openMode);
+
+    if (fis.good())
+    {
+        if (!appendBuffer)
+        {
+            byteBuffer.clear();
+        }
+
+        std::streamsize n = ByteBufferUtils::copyStreamToBuffer(fis, byteBuffer);
+        fis.close();
+        return n;
+    }
+    else
+    {
+        throw Poco::IOException("Bad file input stream.");
+    }
+}
+
+
+/// \brief Save a file through a Poco::FileOutputStream.
+bool saveToStream(const ByteBuffer& byteBuffer,
+                  const std::string& path,
+                  std::ios::openmode mode)
+{
+    Poco::FileOutputStream fos(ofToDataPath(path, true), mode);
+
+    if (fos.good())
+    {
+        ByteBufferUtils::copyBufferToStream(byteBuffer, fos);
+        fos.close();
+        return true;
+    }
+    else
+    {
+        throw Poco::IOException("Bad file output stream.");
+    }
+}
+
+
+} // namespace
+
+
 ByteBuffer ByteBufferUtils::makeBuffer(uint8_t d0,
                                        uint8_t d1)
 {
@@ -71,6 +489,29 @@ std::streamsize ByteBufferUtils::copyStreamToBuffer(std::istream& istr,
 {
 	poco_assert (bufferSize > 0);
 
+    // Reserve the remaining length of seekable streams up front.
+    std::streambuf* streamBuffer = istr.rdbuf();
+
+    if (istr.good() && streamBuffer)
+    {
+        std::streampos position = streamBuffer->pubseekoff(0, std::ios::cur, std::ios::in);
+
+        if (position != std::streampos(-1))
+        {
+            std::streampos end = streamBuffer->pubseekoff(0, std::ios::end, std::ios::in);
+
+            if (end != std::streampos(-1))
+            {
+                if (end > position)
+                {
+                    byteBuffer.reserve(byteBuffer.size() + static_cast<std::size_t>(end - position));
+                }
+
+                streamBuffer->pubseekpos(position, std::ios::in);
+            }
+        }
+    }
+
     Poco::Buffer<char> buffer(bufferSize);
     std::streamsize len = 0;
     istr.read(buffer.begin(), static_cast<std::streamsize>(bufferSize));
@@ -116,23 +557,101 @@ std::streamsize ByteBufferUtils::loadFromFile(const std::string& path,
                                               bool appendBuffer,
                                               std::ios::openmode openMode)
 {
-    Poco::FileInputStream fis(ofToDataPath(path, true), openMode);
+#if !defined(TARGET_WIN32)
+    if ((openMode & std::ios::ate) == 0)
+    {
+        return loadFromFileDescriptor(path, byteBuffer, appendBuffer, FILE_DEFAULT);
+    }
+#endif
 
-    if (fis.good())
+    return loadFromStream(path, byteBuffer, appendBuffer, openMode);
+}
+
+
+std::streamsize ByteBufferUtils::loadFromFileDescriptor(const std::string& path,
+                                                        ByteBuffer& byteBuffer,
+                                                        bool appendBuffer,
+                                                        int flags)
+{
+#if defined(TARGET_WIN32)
+    return loadFromStream(path, byteBuffer, appendBuffer, std::ios::in);
+#else
+    const std::string fullPath = ofToDataPath(path, true);
+
+    bool direct = false;
+    FileDescriptor file(openFile(fullPath,
+                                 O_RDONLY | O_CLOEXEC,
+                                 flags & FILE_DIRECT,
+                                 direct));
+
+    if (file.get() < 0)
     {
-        if (!appendBuffer)
+        throwFileError(fullPath);
+    }
+
+    struct stat info;
+
+    if (::fstat(file.get(), &info) != 0)
+    {
+        throwFileError(fullPath);
+    }
+
+    if (!appendBuffer)
+    {
+        byteBuffer.clear();
+    }
+
+    const std::size_t offset = byteBuffer.size();
+    std::size_t total = 0;
+
+    if (S_ISREG(info.st_mode))
+    {
+        const std::size_t expected = static_cast<std::size_t>(info.st_size);
+
+        byteBuffer.reserve(offset + expected);
+
+        if (!direct)
         {
-            byteBuffer.clear();
-        }
+#if defined(POSIX_FADV_SEQUENTIAL)
+            ::posix_fadvise(file.get(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+            byteBuffer.resize(offset + expected);
+            total = readFully(file.get(), byteBuffer.getPtr() + offset, expected, direct, fullPath);
+            byteBuffer.resize(offset + total);
 
-        std::streamsize n = copyStreamToBuffer(fis, byteBuffer);
-        fis.close();
-        return n;
+            // The file was truncated while reading.
+            if (total < expected)
+            {
+                return static_cast<std::streamsize>(total);
+            }
+        }
     }
-    else
+
+    // Read files of unknown size, anything appended since fstat() and all
+    // O_DIRECT reads through a bounce buffer.
+    AlignedBuffer bounce = makeAlignedBuffer(direct ? DIRECT_IO_BUFFER_SIZE : CHUNK_IO_SIZE);
+    const std::size_t chunkSize = direct ? DIRECT_IO_BUFFER_SIZE : CHUNK_IO_SIZE;
+
+    while (true)
     {
-        throw Poco::IOException("Bad file input stream.");
+        std::size_t n = readFully(file.get(), bounce.get(), chunkSize, direct, fullPath);
+
+        if (n == 0)
+        {
+            break;
+        }
+
+        byteBuffer.writeBytes(bounce.get(), n);
+        total += n;
+
+        if (n < chunkSize)
+        {
+            break;
+        }
     }
+
+    return static_cast<std::streamsize>(total);
+#endif
 }
 
 
@@ -140,11 +659,58 @@ bool ByteBufferUtils::saveToFile(const ByteBuffer& byteBuffer,
                                  const std::string& path,
                                  std::ios::openmode mode)
 {
-    Poco::FileOutputStream fos(ofToDataPath(path, true), mode);
+#if !defined(TARGET_WIN32)
+    std::ios::openmode fileMode = mode & ~std::ios::binary;
+
+    if (fileMode == std::ios::out || fileMode == (std::ios::out | std::ios::trunc))
+    {
+        return saveToFileDescriptor(byteBuffer, path, FILE_DEFAULT);
+    }
+    else if (fileMode == std::ios::app || fileMode == (std::ios::out | std::ios::app))
+    {
+        return saveToFileDescriptor(byteBuffer, path, FILE_APPEND);
+    }
+#endif
+
+    return saveToStream(byteBuffer, path, mode);
+}
+
+
+bool ByteBufferUtils::saveToFileDescriptor(const ByteBuffer& byteBuffer,
+                                           const std::string& path,
+                                           int flags)
+{
+#if defined(TARGET_WIN32)
+    return saveToStream(byteBuffer,
+                        path,
+                        (flags & FILE_APPEND) ? std::ios::out | std::ios::app
+                                              : std::ios::out | std::ios::trunc);
+#else
+    std::vector<struct iovec> vecs(1);
+    vecs[0].iov_base = const_cast<uint8_t*>(byteBuffer.getPtr());
+    vecs[0].iov_len = byteBuffer.size();
+    return writeFile(ofToDataPath(path, true), vecs, flags);
+#endif
+}
+
+
+bool ByteBufferUtils::saveToFileDescriptor(const ByteChain& chain,
+                                           const std::string& path,
+                                           int flags)
+{
+#if defined(TARGET_WIN32)
+    Poco::FileOutputStream fos(ofToDataPath(path, true),
+                               (flags & FILE_APPEND) ? std::ios::out | std::ios::app
+                                                     : std::ios::out | std::ios::trunc);
 
     if (fos.good())
     {
-        copyBufferToStream(byteBuffer, fos);
+        for (const auto& segment: chain.segments())
+        {
+            ByteBufferView view = segment.view();
+            fos.write(view.getCharPtr(), static_cast<std::streamsize>(view.size()));
+        }
+
         fos.close();
         return true;
     }
@@ -152,6 +718,10 @@ bool ByteBufferUtils::saveToFile(const ByteBuffer& byteBuffer,
     {
         throw Poco::IOException("Bad file output stream.");
     }
+#else
+    std::vector<struct iovec> vecs = chain.toIOVecs();
+    return writeFile(ofToDataPath(path, true), vecs, flags);
+#endif
 }
 
 
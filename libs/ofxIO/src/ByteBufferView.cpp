@@ -0,0 +1,175 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/IO/ByteBufferView.h"
+#include <algorithm>
+#include <cstring>
+#include "ofx/IO/ByteBuffer.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+ByteBufferView::ByteBufferView()
+{
+}
+
+
+ByteBufferView::ByteBufferView(const uint8_t* buffer, std::size_t size):
+    _data(buffer),
+    _size(size)
+{
+}
+
+
+ByteBufferView::ByteBufferView(const char* buffer, std::size_t size):
+    _data(reinterpret_cast<const uint8_t*>(buffer)),
+    _size(size)
+{
+}
+
+
+ByteBufferView::ByteBufferView(const ByteBuffer& buffer):
+    _data(buffer.getPtr()),
+    _size(buffer.size())
+{
+}
+
+
+ByteBufferView::ByteBufferView(const std::vector<uint8_t>& buffer):
+    _data(buffer.data()),
+    _size(buffer.size())
+{
+}
+
+
+ByteBufferView::ByteBufferView(const std::string& buffer):
+    _data(reinterpret_cast<const uint8_t*>(buffer.data())),
+    _size(buffer.size())
+{
+}
+
+
+ByteBufferView::~ByteBufferView()
+{
+}
+
+
+std::size_t ByteBufferView::readBytes(uint8_t* buffer, std::size_t size) const
+{
+    std::size_t numBytesToCopy = std::min(size, _size);
+
+    if (numBytesToCopy > 0)
+    {
+        std::memcpy(buffer, _data, numBytesToCopy);
+    }
+
+    return numBytesToCopy;
+}
+
+
+std::size_t ByteBufferView::readBytes(std::vector<uint8_t>& buffer) const
+{
+    buffer.assign(begin(), end());
+    return buffer.size();
+}
+
+
+std::size_t ByteBufferView::readBytes(std::string& buffer) const
+{
+    buffer.assign(begin(), end());
+    return buffer.size();
+}
+
+
+std::size_t ByteBufferView::readBytes(AbstractByteSink& buffer) const
+{
+    return buffer.writeBytes(_data, _size);
+}
+
+
+std::vector<uint8_t> ByteBufferView::readBytes() const
+{
+    return std::vector<uint8_t>(begin(), end());
+}
+
+
+std::size_t ByteBufferView::size() const
+{
+    return _size;
+}
+
+
+bool ByteBufferView::empty() const
+{
+    return _size == 0;
+}
+
+
+ByteBufferView ByteBufferView::slice(std::size_t offset, std::size_t size) const
+{
+    offset = std::min(offset, _size);
+    return ByteBufferView(_data + offset, std::min(size, _size - offset));
+}
+
+
+uint8_t ByteBufferView::operator [] (std::size_t n) const
+{
+    return _data[n];
+}
+
+
+const uint8_t* ByteBufferView::getPtr() const
+{
+    return _data;
+}
+
+
+const char* ByteBufferView::getCharPtr() const
+{
+    return reinterpret_cast<const char*>(_data);
+}
+
+
+const char* ByteBufferView::getData() const
+{
+    return getCharPtr();
+}
+
+
+std::string ByteBufferView::toString() const
+{
+    return std::string(begin(), end());
+}
+
+
+ByteBufferView::const_iterator ByteBufferView::begin() const
+{
+    return _data;
+}
+
+
+ByteBufferView::const_iterator ByteBufferView::end() const
+{
+    return _data + _size;
+}
+
+
+ByteBufferView::const_reverse_iterator ByteBufferView::rbegin() const
+{
+    return const_reverse_iterator(end());
+}
+
+
+ByteBufferView::const_reverse_iterator ByteBufferView::rend() const
+{
+    return const_reverse_iterator(begin());
+}
+
+
+} }  // namespace ofx::IO
@@ -21,18 +21,20 @@ ByteBufferWriter::ByteBufferWriter(ByteBuffer& buffer, std::size_t offset):
 }
 
 
-std::size_t ByteBufferWriter::_write(const void* source, std::size_t size)
+std::size_t ByteBufferWriter::reserve(std::size_t size)
 {
-    if (_offset + size <= _buffer.size())
+    if (_offset + size > _buffer.size())
     {
-        std::memcpy(_buffer.getPtr() + _offset, source, size);
-        _offset += size;
-        return size;
-    }
-    else
-    {
-        return 0;
+        _buffer.resize(_offset + size);
     }
+
+    return remaining();
+}
+
+
+void ByteBufferWriter::truncate()
+{
+    _buffer.resize(_offset);
 }
 
 
@@ -0,0 +1,248 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/IO/ByteChain.h"
+#include <algorithm>
+#include <cstring>
+
+
+namespace ofx {
+namespace IO {
+
+
+ByteBufferView ByteChain::Segment::view() const
+{
+    return ByteBufferView(buffer->getPtr() + offset, size);
+}
+
+
+ByteChain::ByteChain()
+{
+}
+
+
+ByteChain::ByteChain(ByteBuffer&& buffer)
+{
+    append(std::move(buffer));
+}
+
+
+ByteChain::~ByteChain()
+{
+}
+
+
+std::size_t ByteChain::readBytes(uint8_t* buffer, std::size_t size) const
+{
+    std::size_t total = 0;
+
+    for (const auto& segment: _segments)
+    {
+        if (total >= size)
+        {
+            break;
+        }
+
+        std::size_t n = std::min(segment.size, size - total);
+        std::memcpy(buffer + total, segment.buffer->getPtr() + segment.offset, n);
+        total += n;
+    }
+
+    return total;
+}
+
+
+std::size_t ByteChain::readBytes(std::vector<uint8_t>& buffer) const
+{
+    buffer.resize(_size);
+    return readBytes(buffer.data(), buffer.size());
+}
+
+
+std::size_t ByteChain::readBytes(std::string& buffer) const
+{
+    buffer.resize(_size);
+    return readBytes(reinterpret_cast<uint8_t*>(&buffer[0]), buffer.size());
+}
+
+
+std::size_t ByteChain::readBytes(AbstractByteSink& buffer) const
+{
+    std::size_t total = 0;
+
+    for (const auto& segment: _segments)
+    {
+        total += buffer.writeBytes(segment.buffer->getPtr() + segment.offset,
+                                   segment.size);
+    }
+
+    return total;
+}
+
+
+std::vector<uint8_t> ByteChain::readBytes() const
+{
+    std::vector<uint8_t> buffer;
+    readBytes(buffer);
+    return buffer;
+}
+
+
+std::size_t ByteChain::size() const
+{
+    return _size;
+}
+
+
+bool ByteChain::empty() const
+{
+    return _size == 0;
+}
+
+
+void ByteChain::clear()
+{
+    _segments.clear();
+    _size = 0;
+}
+
+
+void ByteChain::append(ByteBuffer&& buffer)
+{
+    if (!buffer.empty())
+    {
+        Segment segment;
+        segment.size = buffer.size();
+        segment.buffer = std::make_shared<const ByteBuffer>(std::move(buffer));
+        _size += segment.size;
+        _segments.push_back(std::move(segment));
+    }
+}
+
+
+void ByteChain::append(const ByteBufferView& buffer)
+{
+    append(ByteBuffer(buffer.getPtr(), buffer.size()));
+}
+
+
+void ByteChain::append(const ByteChain& chain)
+{
+    // Copy first, in case the chain is appended to itself.
+    std::deque<Segment> segments = chain._segments;
+    _segments.insert(_segments.end(), segments.begin(), segments.end());
+    _size += chain._size;
+}
+
+
+void ByteChain::prepend(ByteBuffer&& buffer)
+{
+    if (!buffer.empty())
+    {
+        Segment segment;
+        segment.size = buffer.size();
+        segment.buffer = std::make_shared<const ByteBuffer>(std::move(buffer));
+        _size += segment.size;
+        _segments.push_front(std::move(segment));
+    }
+}
+
+
+void ByteChain::prepend(const ByteBufferView& buffer)
+{
+    prepend(ByteBuffer(buffer.getPtr(), buffer.size()));
+}
+
+
+void ByteChain::prepend(const ByteChain& chain)
+{
+    std::deque<Segment> segments = chain._segments;
+    _segments.insert(_segments.begin(), segments.begin(), segments.end());
+    _size += chain._size;
+}
+
+
+ByteChain ByteChain::slice(std::size_t offset, std::size_t size) const
+{
+    ByteChain chain;
+
+    offset = std::min(offset, _size);
+    size = std::min(size, _size - offset);
+
+    for (const auto& segment: _segments)
+    {
+        if (size == 0)
+        {
+            break;
+        }
+
+        if (offset >= segment.size)
+        {
+            offset -= segment.size;
+            continue;
+        }
+
+        Segment sliced = segment;
+        sliced.offset += offset;
+        sliced.size = std::min(segment.size - offset, size);
+        offset = 0;
+
+        size -= sliced.size;
+        chain._size += sliced.size;
+        chain._segments.push_back(std::move(sliced));
+    }
+
+    return chain;
+}
+
+
+const std::deque<ByteChain::Segment>& ByteChain::segments() const
+{
+    return _segments;
+}
+
+
+std::vector<ByteBufferView> ByteChain::views() const
+{
+    std::vector<ByteBufferView> views;
+    views.reserve(_segments.size());
+
+    for (const auto& segment: _segments)
+    {
+        views.push_back(segment.view());
+    }
+
+    return views;
+}
+
+
+ByteBuffer ByteChain::toByteBuffer() const
+{
+    return ByteBuffer(readBytes());
+}
+
+
+#if !defined(TARGET_WIN32)
+std::vector<struct iovec> ByteChain::toIOVecs() const
+{
+    std::vector<struct iovec> iovecs;
+    iovecs.reserve(_segments.size());
+
+    for (const auto& segment: _segments)
+    {
+        struct iovec iov;
+        iov.iov_base = const_cast<uint8_t*>(segment.buffer->getPtr() + segment.offset);
+        iov.iov_len = segment.size;
+        iovecs.push_back(iov);
+    }
+
+    return iovecs;
+}
+#endif
+
+
+} }  // namespace ofx::IO
@@ -0,0 +1,152 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/IO/ByteOrder.h"
+
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OFX_IO_BYTE_ORDER_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OFX_IO_BYTE_ORDER_NEON 1
+#endif
+
+
+namespace ofx {
+namespace IO {
+
+
+#if defined(OFX_IO_BYTE_ORDER_SSE2)
+
+
+namespace {
+
+
+/// \brief Swap the bytes of each 16-bit lane.
+inline __m128i swapLanes16(__m128i v)
+{
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+
+} // namespace
+
+
+#endif
+
+
+void ByteOrderUtils::swap(void* data, std::size_t count, std::size_t width)
+{
+    switch (width)
+    {
+        case 2:
+            swap16(data, count);
+            break;
+        case 4:
+            swap32(data, count);
+            break;
+        case 8:
+            swap64(data, count);
+            break;
+        default:
+            break;
+    }
+}
+
+
+void ByteOrderUtils::swap16(void* data, std::size_t count)
+{
+    uint8_t* p = static_cast<uint8_t*>(data);
+    std::size_t i = 0;
+
+#if defined(OFX_IO_BYTE_ORDER_SSE2)
+    for (; i + 8 <= count; i += 8, p += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), swapLanes16(v));
+    }
+#elif defined(OFX_IO_BYTE_ORDER_NEON)
+    for (; i + 8 <= count; i += 8, p += 16)
+    {
+        vst1q_u8(p, vrev16q_u8(vld1q_u8(p)));
+    }
+#endif
+
+    for (; i < count; ++i, p += 2)
+    {
+        uint16_t value;
+        std::memcpy(&value, p, 2);
+        value = swap16(value);
+        std::memcpy(p, &value, 2);
+    }
+}
+
+
+void ByteOrderUtils::swap32(void* data, std::size_t count)
+{
+    uint8_t* p = static_cast<uint8_t*>(data);
+    std::size_t i = 0;
+
+#if defined(OFX_IO_BYTE_ORDER_SSE2)
+    for (; i + 4 <= count; i += 4, p += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        // Swap the 16-bit halves of each 32-bit lane, then the bytes.
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), swapLanes16(v));
+    }
+#elif defined(OFX_IO_BYTE_ORDER_NEON)
+    for (; i + 4 <= count; i += 4, p += 16)
+    {
+        vst1q_u8(p, vrev32q_u8(vld1q_u8(p)));
+    }
+#endif
+
+    for (; i < count; ++i, p += 4)
+    {
+        uint32_t value;
+        std::memcpy(&value, p, 4);
+        value = swap32(value);
+        std::memcpy(p, &value, 4);
+    }
+}
+
+
+void ByteOrderUtils::swap64(void* data, std::size_t count)
+{
+    uint8_t* p = static_cast<uint8_t*>(data);
+    std::size_t i = 0;
+
+#if defined(OFX_IO_BYTE_ORDER_SSE2)
+    for (; i + 2 <= count; i += 2, p += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        // Reverse the 16-bit quarters of each 64-bit lane, then the bytes.
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), swapLanes16(v));
+    }
+#elif defined(OFX_IO_BYTE_ORDER_NEON)
+    for (; i + 2 <= count; i += 2, p += 16)
+    {
+        vst1q_u8(p, vrev64q_u8(vld1q_u8(p)));
+    }
+#endif
+
+    for (; i < count; ++i, p += 8)
+    {
+        uint64_t value;
+        std::memcpy(&value, p, 8);
+        value = swap64(value);
+        std::memcpy(p, &value, 8);
+    }
+}
+
+
+} } // namespace ofx::IO
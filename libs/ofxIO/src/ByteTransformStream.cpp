@@ -0,0 +1,208 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/IO/ByteTransformStream.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include "ofx/IO/ByteBufferView.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+ByteTransformInputStreamBuf::ByteTransformInputStreamBuf(std::istream& source,
+                                                         AbstractByteTransform& transform,
+                                                         std::size_t chunkSize):
+    _source(source),
+    _transform(transform),
+    _input(std::max(chunkSize, std::size_t(1)), 0)
+{
+    setg(nullptr, nullptr, nullptr);
+}
+
+
+ByteTransformInputStreamBuf::~ByteTransformInputStreamBuf()
+{
+}
+
+
+ByteTransformInputStreamBuf::int_type ByteTransformInputStreamBuf::underflow()
+{
+    if (gptr() < egptr())
+    {
+        return traits_type::to_int_type(*gptr());
+    }
+
+    _output.clear();
+
+    // A chunk may transform to nothing, e.g. while a decoder waits for the
+    // rest of a group, so keep reading until there is output or the end.
+    while (_output.empty() && !_isFinished)
+    {
+        _source.read(_input.getCharPtr(), static_cast<std::streamsize>(_input.size()));
+        std::streamsize count = _source.gcount();
+
+        if (count > 0)
+        {
+            _transform.update(ByteBufferView(_input.getPtr(), static_cast<std::size_t>(count)), _output);
+        }
+        else
+        {
+            _transform.finish(_output);
+            _isFinished = true;
+        }
+    }
+
+    if (_output.empty())
+    {
+        setg(nullptr, nullptr, nullptr);
+        return traits_type::eof();
+    }
+
+    setg(_output.getCharPtr(), _output.getCharPtr(), _output.getCharPtr() + _output.size());
+    return traits_type::to_int_type(*gptr());
+}
+
+
+ByteTransformOutputStreamBuf::ByteTransformOutputStreamBuf(std::ostream& sink,
+                                                           AbstractByteTransform& transform,
+                                                           std::size_t chunkSize):
+    _sink(sink),
+    _transform(transform),
+    _input(std::min(std::max(chunkSize, std::size_t(1)), std::size_t(std::numeric_limits<int>::max())), 0)
+{
+    // The put area is advanced with pbump(), so its size must fit an int.
+    setp(_input.getCharPtr(), _input.getCharPtr() + _input.size());
+}
+
+
+ByteTransformOutputStreamBuf::~ByteTransformOutputStreamBuf()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+
+int ByteTransformOutputStreamBuf::close()
+{
+    if (_isClosed)
+    {
+        return 0;
+    }
+
+    bool isGood = _flushInput();
+
+    _isClosed = true;
+    setp(nullptr, nullptr);
+
+    _output.clear();
+    _transform.finish(_output);
+
+    isGood = _writeOutput() && isGood;
+    _sink.flush();
+
+    return isGood && _sink.good() ? 0 : -1;
+}
+
+
+ByteTransformOutputStreamBuf::int_type ByteTransformOutputStreamBuf::overflow(int_type c)
+{
+    if (traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        return traits_type::not_eof(c);
+    }
+
+    if (_isClosed || !_flushInput())
+    {
+        return traits_type::eof();
+    }
+
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+    return c;
+}
+
+
+std::streamsize ByteTransformOutputStreamBuf::xsputn(const char_type* s,
+                                                     std::streamsize n)
+{
+    if (n <= 0 || _isClosed)
+    {
+        return 0;
+    }
+
+    std::size_t size = static_cast<std::size_t>(n);
+
+    if (size <= static_cast<std::size_t>(epptr() - pptr()))
+    {
+        std::memcpy(pptr(), s, size);
+        pbump(static_cast<int>(size));
+        return n;
+    }
+
+    // Large writes are transformed directly rather than copied.
+    if (!_flushInput() || !_write(s, size))
+    {
+        return 0;
+    }
+
+    return n;
+}
+
+
+int ByteTransformOutputStreamBuf::sync()
+{
+    if (_isClosed)
+    {
+        return 0;
+    }
+
+    if (!_flushInput())
+    {
+        return -1;
+    }
+
+    _sink.flush();
+    return _sink.good() ? 0 : -1;
+}
+
+
+bool ByteTransformOutputStreamBuf::_flushInput()
+{
+    std::size_t size = static_cast<std::size_t>(pptr() - pbase());
+    setp(_input.getCharPtr(), _input.getCharPtr() + _input.size());
+    return size == 0 || _write(_input.getCharPtr(), size);
+}
+
+
+bool ByteTransformOutputStreamBuf::_write(const char* data, std::size_t size)
+{
+    _output.clear();
+    _transform.update(ByteBufferView(data, size), _output);
+    return _writeOutput();
+}
+
+
+bool ByteTransformOutputStreamBuf::_writeOutput()
+{
+    if (!_output.empty())
+    {
+        _sink.write(_output.getCharPtr(), static_cast<std::streamsize>(_output.size()));
+    }
+
+    return _sink.good();
+}
+
+
+} }  // namespace ofx::IO
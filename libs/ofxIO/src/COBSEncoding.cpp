@@ -9,13 +9,241 @@
 //
 
 #include "ofx/IO/COBSEncoding.h"
+#include <algorithm>
+#include <cstring>
 
 
 namespace ofx {
 namespace IO {
 
 
-COBSEncoding::COBSEncoding()
+namespace {
+
+
+/// \brief An incremental COBS encoder with the same output as encode().
+///
+/// At most one block of 254 bytes is held back, because each block's code
+/// byte precedes its data, and the final block may be reduced.
+class COBSTransformEncoder: public AbstractByteTransform
+{
+public:
+    COBSTransformEncoder(bool isReduced, uint8_t delimiter):
+        _isReduced(isReduced),
+        _delimiter(delimiter)
+    {
+    }
+
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        const uint8_t* in = buffer.getPtr();
+        std::size_t size = buffer.size();
+
+        if (size == 0)
+        {
+            return 0;
+        }
+
+        _hasInput = true;
+
+        const std::size_t offset = outputBuffer.size();
+        outputBuffer.resize(offset + size + size / 254 + 256);
+
+        uint8_t* out = outputBuffer.getPtr() + offset;
+
+        while (size > 0)
+        {
+            // A full block is only written once more data follows it.
+            if (_code == 0xFF)
+            {
+                out = emit(out, _code);
+            }
+
+            std::size_t room = std::min(size, std::size_t(0xFF - _code));
+            const uint8_t* next = static_cast<const uint8_t*>(std::memchr(in, _delimiter, room));
+            std::size_t run = next ? static_cast<std::size_t>(next - in) : room;
+
+            std::memcpy(_block + _code - 1, in, run);
+            _code = uint8_t(_code + run);
+            in += run;
+            size -= run;
+
+            if (next)
+            {
+                out = emit(out, _code);
+                ++in;
+                --size;
+            }
+        }
+
+        std::size_t written = static_cast<std::size_t>(out - (outputBuffer.getPtr() + offset));
+        outputBuffer.resize(offset + written);
+        return written;
+    }
+
+    std::size_t finish(ByteBuffer& outputBuffer) override
+    {
+        std::size_t written = 0;
+
+        if (_hasInput)
+        {
+            uint8_t block[0xFF];
+            uint8_t code = _code;
+
+            // COBS/R replaces the final code with a larger final byte.
+            if (_isReduced && _code > 1 && _block[_code - 2] > _code)
+            {
+                code = _block[_code - 2];
+                --_code;
+            }
+
+            written = static_cast<std::size_t>(emit(block, code) - block);
+            outputBuffer.writeBytes(block, written);
+        }
+
+        reset();
+        return written;
+    }
+
+    void reset() override
+    {
+        _code = 1;
+        _hasInput = false;
+    }
+
+private:
+    /// \brief Write the current block with the given code and start a new
+    /// one.
+    uint8_t* emit(uint8_t* out, uint8_t code)
+    {
+        *out++ = code ^ _delimiter;
+        std::memcpy(out, _block, _code - 1u);
+        out += _code - 1u;
+        _code = 1;
+        return out;
+    }
+
+    /// \brief True if the final block is reduced.
+    bool _isReduced = false;
+
+    /// \brief The delimiter value.
+    uint8_t _delimiter = 0;
+
+    /// \brief The data of the current block.
+    uint8_t _block[0xFE];
+
+    /// \brief The code of the current block, one more than its size.
+    uint8_t _code = 1;
+
+    /// \brief True if any input has been seen.
+    bool _hasInput = false;
+
+};
+
+
+/// \brief An incremental COBS decoder with the same output as decode().
+///
+/// The delimiter implied at the end of a block is only written once the
+/// next block begins, since the final block has none. A reduced final
+/// block is only known to be one when the input finishes.
+class COBSTransformDecoder: public AbstractByteTransform
+{
+public:
+    COBSTransformDecoder(bool isReduced, uint8_t delimiter):
+        _isReduced(isReduced),
+        _delimiter(delimiter)
+    {
+    }
+
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        const uint8_t* in = buffer.getPtr();
+        std::size_t size = buffer.size();
+
+        const std::size_t offset = outputBuffer.size();
+        outputBuffer.resize(offset + size + 1);
+
+        uint8_t* out = outputBuffer.getPtr() + offset;
+
+        while (size > 0)
+        {
+            if (_remaining == 0)
+            {
+                if (_hasPendingDelimiter)
+                {
+                    *out++ = _delimiter;
+                    _hasPendingDelimiter = false;
+                }
+
+                _code = *in++ ^ _delimiter;
+                --size;
+                _remaining = _code > 0 ? _code - 1u : 0;
+                _hasPendingDelimiter = (_remaining == 0 && _code != 0xFF);
+            }
+            else
+            {
+                std::size_t run = std::min(size, _remaining);
+                std::memcpy(out, in, run);
+                out += run;
+                in += run;
+                size -= run;
+                _remaining -= run;
+                _hasPendingDelimiter = (_remaining == 0 && _code != 0xFF);
+            }
+        }
+
+        std::size_t written = static_cast<std::size_t>(out - (outputBuffer.getPtr() + offset));
+        outputBuffer.resize(offset + written);
+        return written;
+    }
+
+    std::size_t finish(ByteBuffer& outputBuffer) override
+    {
+        std::size_t written = 0;
+
+        // A COBS/R final block is shorter than its code, which is its final
+        // byte.
+        if (_isReduced && _remaining > 0)
+        {
+            outputBuffer.writeByte(_code);
+            written = 1;
+        }
+
+        reset();
+        return written;
+    }
+
+    void reset() override
+    {
+        _code = 0;
+        _remaining = 0;
+        _hasPendingDelimiter = false;
+    }
+
+private:
+    /// \brief True if the final block may be reduced.
+    bool _isReduced = false;
+
+    /// \brief The delimiter value.
+    uint8_t _delimiter = 0;
+
+    /// \brief The code of the current block.
+    uint8_t _code = 0;
+
+    /// \brief The number of data bytes left in the current block.
+    std::size_t _remaining = 0;
+
+    /// \brief True if the last block ended with an implied delimiter.
+    bool _hasPendingDelimiter = false;
+
+};
+
+
+} // namespace
+
+
+COBSEncoding::COBSEncoding(bool isReduced, uint8_t delimiter):
+    _isReduced(isReduced),
+    _delimiter(delimiter)
 {
 }
 
@@ -27,6 +255,20 @@ COBSEncoding::~COBSEncoding()
 
 std::size_t COBSEncoding::encode(const ByteBuffer& buffer,
                                  ByteBuffer& encodedBuffer)
+{
+    return encode(ByteBufferView(buffer), encodedBuffer);
+}
+
+
+std::size_t COBSEncoding::decode(const ByteBuffer& buffer,
+                                 ByteBuffer& decodedBuffer)
+{
+    return decode(ByteBufferView(buffer), decodedBuffer);
+}
+
+
+std::size_t COBSEncoding::encode(const ByteBufferView& buffer,
+                                 ByteBuffer& encodedBuffer)
 {
     if (buffer.size() > 0)
     {
@@ -34,7 +276,9 @@ std::size_t COBSEncoding::encode(const ByteBuffer& buffer,
         encodedBuffer.resize(encodedMax);
         std::size_t size = encode(buffer.getPtr(),
                                   buffer.size(),
-                                  encodedBuffer.getPtr());
+                                  encodedBuffer.getPtr(),
+                                  _isReduced,
+                                  _delimiter);
         encodedBuffer.resize(size);
         return encodedBuffer.size();
     }
@@ -45,7 +289,7 @@ std::size_t COBSEncoding::encode(const ByteBuffer& buffer,
 }
 
 
-std::size_t COBSEncoding::decode(const ByteBuffer& buffer,
+std::size_t COBSEncoding::decode(const ByteBufferView& buffer,
                                  ByteBuffer& decodedBuffer)
 {
     if (buffer.size() > 0)
@@ -53,7 +297,9 @@ std::size_t COBSEncoding::decode(const ByteBuffer& buffer,
         decodedBuffer.resize(buffer.size());
         std::size_t size = decode(buffer.getPtr(),
                                   buffer.size(),
-                                  decodedBuffer.getPtr());
+                                  decodedBuffer.getPtr(),
+                                  _isReduced,
+                                  _delimiter);
         decodedBuffer.resize(size);
         return decodedBuffer.size();
     }
@@ -64,81 +310,138 @@ std::size_t COBSEncoding::decode(const ByteBuffer& buffer,
 }
 
 
+std::unique_ptr<AbstractByteTransform> COBSEncoding::createStreamEncoder()
+{
+    return std::make_unique<COBSTransformEncoder>(_isReduced, _delimiter);
+}
+
+
+std::unique_ptr<AbstractByteTransform> COBSEncoding::createStreamDecoder()
+{
+    return std::make_unique<COBSTransformDecoder>(_isReduced, _delimiter);
+}
+
+
 std::size_t COBSEncoding::encode(const uint8_t* buffer,
                                  std::size_t size,
-                                 uint8_t* encoded)
+                                 uint8_t* encoded,
+                                 bool isReduced,
+                                 uint8_t delimiter)
 {
     if (size == 0)
         return 0;
 
-    std::size_t read_index  = 0;
-    std::size_t write_index = 1;
-    std::size_t code_index  = 0;
-    uint8_t code = 1;
+    const uint8_t* in = buffer;
+    const uint8_t* end = buffer + size;
+    uint8_t* out = encoded;
 
-    while (read_index < size)
+    while (true)
     {
-        if (buffer[read_index] == 0)
+        // Each block holds the run of up to 254 bytes before the next
+        // delimiter, which is implied by any block shorter than 254 bytes.
+        std::size_t room = std::min(std::size_t(end - in), std::size_t(0xFE));
+        const uint8_t* next = static_cast<const uint8_t*>(std::memchr(in, delimiter, room));
+        std::size_t run = next ? static_cast<std::size_t>(next - in) : room;
+
+        uint8_t* code = out++;
+        std::memcpy(out, in, run);
+        out += run;
+        in += run;
+
+        if (next)
+        {
+            *code = uint8_t(run + 1) ^ delimiter;
+            ++in;
+        }
+        else if (in < end)
         {
-            encoded[code_index] = code;
-            code = 1;
-            code_index = write_index++;
-            read_index++;
+            *code = uint8_t(0xFF ^ delimiter);
         }
         else
         {
-            encoded[write_index++] = buffer[read_index++];
-            code++;
-
-            if (code == 0xFF)
+            // COBS/R replaces the final code with a larger final byte.
+            if (isReduced && run > 0 && out[-1] > run + 1)
+            {
+                *code = out[-1] ^ delimiter;
+                --out;
+            }
+            else
             {
-                encoded[code_index] = code;
-                code = 1;
-                code_index = write_index++;
+                *code = uint8_t(run + 1) ^ delimiter;
             }
+
+            break;
         }
     }
 
-    encoded[code_index] = code;
-
-    return write_index;
+    return static_cast<std::size_t>(out - encoded);
 }
 
+
 std::size_t COBSEncoding::decode(const uint8_t* buffer,
                                  std::size_t size,
-                                 uint8_t* decoded)
+                                 uint8_t* decoded,
+                                 bool isReduced,
+                                 uint8_t delimiter)
 {
     if (size == 0)
         return 0;
 
-    size_t read_index  = 0;
-    size_t write_index = 0;
-    uint8_t code;
-    uint8_t i;
+    const uint8_t* in = buffer;
+    const uint8_t* end = buffer + size;
+    uint8_t* out = decoded;
 
-    while (read_index < size)
+    while (in < end)
     {
-        code = buffer[read_index];
+        uint8_t code = *in++ ^ delimiter;
 
-        if (read_index + code > size && code != 1)
+        // A delimiter ends the frame.
+        if (code == 0)
         {
-            return 0;
+            break;
         }
 
-        read_index++;
+        std::size_t run = code - 1u;
+        std::size_t available = static_cast<std::size_t>(end - in);
 
-        for (i = 1; i < code; i++)
+        if (run > available)
         {
-            decoded[write_index++] = buffer[read_index++];
+            if (!isReduced)
+            {
+                return 0;
+            }
+
+            // A COBS/R final block is shorter than its code, which is its
+            // final byte.
+            std::memcpy(out, in, available);
+            out += available;
+            *out++ = code;
+            break;
         }
 
-        if (code != 0xFF && read_index != size)
+        std::memcpy(out, in, run);
+        out += run;
+        in += run;
+
+        if (code != 0xFF && in != end)
         {
-            decoded[write_index++] = '\0';
+            *out++ = delimiter;
         }
     }
-    
-    return write_index;
+
+    return static_cast<std::size_t>(out - decoded);
+}
+
+
+bool COBSEncoding::isReduced() const
+{
+    return _isReduced;
+}
+
+
+uint8_t COBSEncoding::delimiter() const
+{
+    return _delimiter;
 }
 
 
@@ -0,0 +1,264 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/IO/COBSStreamDecoder.h"
+#include <algorithm>
+#include <cstring>
+
+
+namespace ofx {
+namespace IO {
+
+
+COBSStreamDecoder::COBSStreamDecoder(std::size_t maximumFrameSize,
+                                     std::size_t frameCount,
+                                     bool isReduced,
+                                     uint8_t delimiter):
+    _maximumFrameSize(std::max(maximumFrameSize, std::size_t(1))),
+    _frameCount(std::max(frameCount, std::size_t(1))),
+    _isReduced(isReduced),
+    _delimiter(delimiter),
+    _storage(_maximumFrameSize * (_frameCount + 1)),
+    _sizes(_frameCount + 1, 0)
+{
+    _beginFrame();
+}
+
+
+COBSStreamDecoder::~COBSStreamDecoder()
+{
+}
+
+
+std::size_t COBSStreamDecoder::update(const uint8_t* buffer, std::size_t size)
+{
+    std::size_t frames = 0;
+
+    const uint8_t* in = buffer;
+    const uint8_t* end = buffer + size;
+
+    while (in < end)
+    {
+        if (_isDiscarding)
+        {
+            const uint8_t* next = static_cast<const uint8_t*>(std::memchr(in, _delimiter, std::size_t(end - in)));
+
+            if (next == nullptr)
+            {
+                break;
+            }
+
+            in = next + 1;
+            _isDiscarding = false;
+            _beginFrame();
+        }
+        else if (_remaining == 0)
+        {
+            uint8_t byte = *in++;
+
+            if (byte == _delimiter)
+            {
+                if (_endFrame())
+                {
+                    ++frames;
+                }
+
+                continue;
+            }
+
+            if (_hasPendingDelimiter && !_append(&_delimiter, 1))
+            {
+                continue;
+            }
+
+            _code = byte ^ _delimiter;
+            _hasCode = true;
+            _remaining = _code - 1u;
+            _hasPendingDelimiter = (_code != 0xFF);
+        }
+        else
+        {
+            std::size_t run = std::min(std::size_t(end - in), _remaining);
+            const uint8_t* next = static_cast<const uint8_t*>(std::memchr(in, _delimiter, run));
+
+            if (next == nullptr)
+            {
+                if (_append(in, run))
+                {
+                    _remaining -= run;
+                }
+
+                in += run;
+            }
+            else if (_isReduced)
+            {
+                // A COBS/R final block is shorter than its code, which is
+                // its final byte.
+                std::size_t count = static_cast<std::size_t>(next - in);
+                in = next + 1;
+
+                if (_append(next - count, count) && _append(&_code, 1))
+                {
+                    _remaining = 0;
+
+                    if (_endFrame())
+                    {
+                        ++frames;
+                    }
+                }
+                else
+                {
+                    // The delimiter already ended the discarded frame.
+                    _isDiscarding = false;
+                    _beginFrame();
+                }
+            }
+            else
+            {
+                // The delimiter cut the block short. It still ends the
+                // frame, so the next frame starts right after it.
+                ++_statistics.invalidFrames;
+                in = next + 1;
+                _beginFrame();
+            }
+        }
+    }
+
+    return frames;
+}
+
+
+std::size_t COBSStreamDecoder::update(const ByteBufferView& buffer)
+{
+    return update(buffer.getPtr(), buffer.size());
+}
+
+
+bool COBSStreamDecoder::empty() const
+{
+    return _size == 0;
+}
+
+
+std::size_t COBSStreamDecoder::size() const
+{
+    return _size;
+}
+
+
+ByteBufferView COBSStreamDecoder::front() const
+{
+    if (_size == 0)
+    {
+        return ByteBufferView();
+    }
+
+    return ByteBufferView(_storage.data() + _head * _maximumFrameSize, _sizes[_head]);
+}
+
+
+void COBSStreamDecoder::pop()
+{
+    if (_size > 0)
+    {
+        _head = (_head + 1) % (_frameCount + 1);
+        --_size;
+    }
+}
+
+
+void COBSStreamDecoder::reset()
+{
+    _head = 0;
+    _size = 0;
+    _beginFrame();
+    _isDiscarding = true;
+}
+
+
+const COBSStreamDecoder::Statistics& COBSStreamDecoder::statistics() const
+{
+    return _statistics;
+}
+
+
+std::size_t COBSStreamDecoder::maximumFrameSize() const
+{
+    return _maximumFrameSize;
+}
+
+
+std::size_t COBSStreamDecoder::frameCount() const
+{
+    return _frameCount;
+}
+
+
+bool COBSStreamDecoder::isReduced() const
+{
+    return _isReduced;
+}
+
+
+uint8_t COBSStreamDecoder::delimiter() const
+{
+    return _delimiter;
+}
+
+
+bool COBSStreamDecoder::_endFrame()
+{
+    bool isAdded = false;
+
+    if (!_hasCode)
+    {
+        // A bare delimiter.
+    }
+    else if (_size == _frameCount)
+    {
+        ++_statistics.droppedFrames;
+    }
+    else
+    {
+        _sizes[(_head + _size) % (_frameCount + 1)] = _frameSize;
+        ++_size;
+        ++_statistics.frames;
+        isAdded = true;
+    }
+
+    _beginFrame();
+    return isAdded;
+}
+
+
+bool COBSStreamDecoder::_append(const uint8_t* buffer, std::size_t size)
+{
+    if (_frameSize + size > _maximumFrameSize)
+    {
+        ++_statistics.oversizedFrames;
+        _isDiscarding = true;
+        return false;
+    }
+
+    std::memcpy(_frame + _frameSize, buffer, size);
+    _frameSize += size;
+    return true;
+}
+
+
+void COBSStreamDecoder::_beginFrame()
+{
+    _frame = _storage.data() + ((_head + _size) % (_frameCount + 1)) * _maximumFrameSize;
+    _frameSize = 0;
+    _code = 0;
+    _remaining = 0;
+    _hasPendingDelimiter = false;
+    _hasCode = false;
+}
+
+
+} }  // namespace ofx::IO
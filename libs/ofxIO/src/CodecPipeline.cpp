@@ -0,0 +1,286 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/IO/CodecPipeline.h"
+#include <algorithm>
+#include "ofx/IO/ByteBuffer.h"
+#include "ofx/IO/ByteBufferView.h"
+#include "ofx/IO/StreamFilters.h"
+#include "Poco/Exception.h"
+#include "Poco/String.h"
+#include "ofLog.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+namespace {
+
+
+/// \brief A transform that passes its input through a chain of transforms.
+class PipelineTransform: public AbstractByteTransform
+{
+public:
+    PipelineTransform(const std::vector<std::shared_ptr<AbstractByteEncoderDecoder>>& stages,
+                      std::vector<std::unique_ptr<AbstractByteTransform>> transforms,
+                      std::size_t chunkSize):
+        _stages(stages),
+        _transforms(std::move(transforms)),
+        _buffers(_transforms.size()),
+        _chunkSize(chunkSize)
+    {
+    }
+
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        const std::size_t offset = outputBuffer.size();
+        _push(0, buffer, outputBuffer);
+        return outputBuffer.size() - offset;
+    }
+
+    std::size_t finish(ByteBuffer& outputBuffer) override
+    {
+        const std::size_t offset = outputBuffer.size();
+
+        // Finishing a stage may flush output into the next one, so the
+        // stages are finished in order.
+        for (std::size_t i = 0; i < _transforms.size(); ++i)
+        {
+            if (i + 1 == _transforms.size())
+            {
+                _transforms[i]->finish(outputBuffer);
+            }
+            else
+            {
+                _buffers[i].clear();
+                _transforms[i]->finish(_buffers[i]);
+                _push(i + 1, _buffers[i], outputBuffer);
+            }
+        }
+
+        return outputBuffer.size() - offset;
+    }
+
+    void reset() override
+    {
+        for (auto& transform: _transforms)
+        {
+            transform->reset();
+        }
+    }
+
+private:
+    /// \brief Pass bytes through a stage and every stage after it, one
+    /// chunk at a time.
+    void _push(std::size_t stage, const ByteBufferView& buffer, ByteBuffer& outputBuffer)
+    {
+        if (stage == _transforms.size())
+        {
+            outputBuffer.writeBytes(buffer.getPtr(), buffer.size());
+            return;
+        }
+
+        for (std::size_t offset = 0; offset < buffer.size(); offset += _chunkSize)
+        {
+            ByteBufferView chunk(buffer.getPtr() + offset,
+                                 std::min(_chunkSize, buffer.size() - offset));
+
+            if (stage + 1 == _transforms.size())
+            {
+                _transforms[stage]->update(chunk, outputBuffer);
+            }
+            else
+            {
+                _buffers[stage].clear();
+                _transforms[stage]->update(chunk, _buffers[stage]);
+                _push(stage + 1, _buffers[stage], outputBuffer);
+            }
+        }
+    }
+
+    /// \brief Keeps the codecs alive, as their transforms may refer to them.
+    std::vector<std::shared_ptr<AbstractByteEncoderDecoder>> _stages;
+
+    /// \brief The transform of each stage.
+    std::vector<std::unique_ptr<AbstractByteTransform>> _transforms;
+
+    /// \brief The output of each stage but the last, reused for each chunk.
+    std::vector<ByteBuffer> _buffers;
+
+    /// \brief The largest number of bytes passed to a stage at once.
+    std::size_t _chunkSize = CodecPipeline::DEFAULT_CHUNK_SIZE;
+
+};
+
+
+} // namespace
+
+
+CodecPipeline::CodecPipeline(std::size_t chunkSize):
+    _chunkSize(std::max(chunkSize, std::size_t(1)))
+{
+}
+
+
+CodecPipeline::CodecPipeline(const std::string& stages,
+                             const CodecRegistry& registry,
+                             std::size_t chunkSize):
+    CodecPipeline(chunkSize)
+{
+    std::size_t begin = 0;
+
+    while (begin <= stages.size())
+    {
+        std::size_t end = std::min(stages.find('|', begin), stages.size());
+        std::string name = Poco::trim(stages.substr(begin, end - begin));
+
+        if (!name.empty())
+        {
+            add(name, registry);
+        }
+
+        begin = end + 1;
+    }
+}
+
+
+CodecPipeline::~CodecPipeline()
+{
+}
+
+
+CodecPipeline& CodecPipeline::add(std::shared_ptr<AbstractByteEncoderDecoder> codec)
+{
+    _stages.push_back(codec);
+    return *this;
+}
+
+
+CodecPipeline& CodecPipeline::add(const std::string& name,
+                                  const CodecRegistry& registry)
+{
+    return add(registry.create(name));
+}
+
+
+std::size_t CodecPipeline::encode(const ByteBuffer& buffer,
+                                  ByteBuffer& encodedBuffer)
+{
+    return encode(ByteBufferView(buffer), encodedBuffer);
+}
+
+
+std::size_t CodecPipeline::decode(const ByteBuffer& buffer,
+                                  ByteBuffer& decodedBuffer)
+{
+    return decode(ByteBufferView(buffer), decodedBuffer);
+}
+
+
+std::size_t CodecPipeline::encode(const ByteBufferView& buffer,
+                                  ByteBuffer& encodedBuffer)
+{
+    if (_stages.size() == 1)
+    {
+        return _stages.front()->encode(buffer, encodedBuffer);
+    }
+
+    return _transform(createStreamEncoder(), buffer, encodedBuffer);
+}
+
+
+std::size_t CodecPipeline::decode(const ByteBufferView& buffer,
+                                  ByteBuffer& decodedBuffer)
+{
+    if (_stages.size() == 1)
+    {
+        return _stages.front()->decode(buffer, decodedBuffer);
+    }
+
+    return _transform(createStreamDecoder(), buffer, decodedBuffer);
+}
+
+
+std::unique_ptr<AbstractByteTransform> CodecPipeline::createStreamEncoder()
+{
+    std::vector<std::unique_ptr<AbstractByteTransform>> transforms;
+
+    for (auto& stage: _stages)
+    {
+        transforms.push_back(stage->createStreamEncoder());
+    }
+
+    return std::make_unique<PipelineTransform>(_stages, std::move(transforms), _chunkSize);
+}
+
+
+std::unique_ptr<AbstractByteTransform> CodecPipeline::createStreamDecoder()
+{
+    std::vector<std::unique_ptr<AbstractByteTransform>> transforms;
+
+    for (auto iter = _stages.rbegin(); iter != _stages.rend(); ++iter)
+    {
+        transforms.push_back((*iter)->createStreamDecoder());
+    }
+
+    return std::make_unique<PipelineTransform>(_stages, std::move(transforms), _chunkSize);
+}
+
+
+std::unique_ptr<AbstractOutputStreamFilter> CodecPipeline::createOutputStreamFilter()
+{
+    return std::make_unique<ByteTransformOutputStreamFilter>(createStreamEncoder());
+}
+
+
+std::unique_ptr<AbstractInputStreamFilter> CodecPipeline::createInputStreamFilter()
+{
+    return std::make_unique<ByteTransformInputStreamFilter>(createStreamDecoder());
+}
+
+
+std::size_t CodecPipeline::size() const
+{
+    return _stages.size();
+}
+
+
+bool CodecPipeline::empty() const
+{
+    return _stages.empty();
+}
+
+
+std::size_t CodecPipeline::chunkSize() const
+{
+    return _chunkSize;
+}
+
+
+std::size_t CodecPipeline::_transform(std::unique_ptr<AbstractByteTransform> transform,
+                                      const ByteBufferView& buffer,
+                                      ByteBuffer& outputBuffer) const
+{
+    outputBuffer.clear();
+
+    try
+    {
+        transform->update(buffer, outputBuffer);
+        transform->finish(outputBuffer);
+        return outputBuffer.size();
+    }
+    catch (const Poco::Exception& exc)
+    {
+        ofLogError("CodecPipeline::_transform") << exc.displayText();
+        outputBuffer.clear();
+        return 0;
+    }
+}
+
+
+} }  // namespace ofx::IO
@@ -0,0 +1,129 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/IO/CodecRegistry.h"
+#include "ofx/IO/Base64Encoding.h"
+#include "ofx/IO/COBSEncoding.h"
+#include "ofx/IO/CompressionEncoding.h"
+#include "ofx/IO/HexBinaryEncoding.h"
+#include "ofx/IO/SLIPEncoding.h"
+#include "ofx/IO/URIEncoding.h"
+#include "Poco/Exception.h"
+#include "Poco/String.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+CodecRegistry::CodecRegistry()
+{
+}
+
+
+CodecRegistry::~CodecRegistry()
+{
+}
+
+
+void CodecRegistry::add(const std::string& name, Factory factory)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _factories[_key(name)] = factory;
+}
+
+
+bool CodecRegistry::remove(const std::string& name)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _factories.erase(_key(name)) > 0;
+}
+
+
+bool CodecRegistry::has(const std::string& name) const
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _factories.find(_key(name)) != _factories.end();
+}
+
+
+std::shared_ptr<AbstractByteEncoderDecoder> CodecRegistry::create(const std::string& name) const
+{
+    Factory factory;
+
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        auto iter = _factories.find(_key(name));
+
+        if (iter == _factories.end())
+        {
+            throw Poco::NotFoundException("CodecRegistry: no codec named", name);
+        }
+
+        factory = iter->second;
+    }
+
+    // The factory may be slow, or use the registry itself.
+    return factory();
+}
+
+
+std::vector<std::string> CodecRegistry::names() const
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    std::vector<std::string> names;
+
+    for (const auto& entry: _factories)
+    {
+        names.push_back(entry.first);
+    }
+
+    return names;
+}
+
+
+CodecRegistry& CodecRegistry::defaultRegistry()
+{
+    static CodecRegistry registry;
+    static std::once_flag once;
+
+    std::call_once(once, []() {
+        const Compression::Type types[] = {
+            Compression::ZLIB,
+            Compression::GZIP,
+            Compression::SNAPPY,
+            Compression::LZ4,
+            Compression::BR
+        };
+
+        for (Compression::Type type: types)
+        {
+            registry.add(type == Compression::BR ? "BR" : Compression::toString(type), [type]() {
+                return std::make_shared<CompressionEncoding>(type);
+            });
+        }
+
+        registry.add("BASE64", []() { return std::make_shared<Base64Encoding>(); });
+        registry.add("BASE64URL", []() { return std::make_shared<Base64Encoding>(true); });
+        registry.add("HEX", []() { return std::make_shared<HexBinaryEncoding>(); });
+        registry.add("COBS", []() { return std::make_shared<COBSEncoding>(); });
+        registry.add("COBSR", []() { return std::make_shared<COBSEncoding>(true); });
+        registry.add("SLIP", []() { return std::make_shared<SLIPEncoding>(); });
+        registry.add("URI", []() { return std::make_shared<URIEncoding>(); });
+    });
+
+    return registry;
+}
+
+
+std::string CodecRegistry::_key(const std::string& name)
+{
+    return Poco::toUpper(Poco::trim(name));
+}
+
+
+} }  // namespace ofx::IO
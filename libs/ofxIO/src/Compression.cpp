@@ -6,18 +6,21 @@
 
 
 #include "ofx/IO/Compression.h"
-#include "ofx/IO/ByteBufferStream.h"
-#include "Poco/Buffer.h"
-#include "Poco/DeflatingStream.h"
-#include "Poco/InflatingStream.h"
+#include "ofx/IO/Compressor.h"
+#include "ofx/IO/Decompressor.h"
+#include <sstream>
+#include "Poco/Exception.h"
+#include "Poco/Foundation.h"
 #include "Poco/Version.h"
+#if defined(POCO_UNBUNDLED)
+#include <zlib.h>
+#else
+#include "Poco/zlib.h"
+#endif
 #include "snappy.h"
 #include "lz4.h"
 #include "ofLog.h"
 
-#include "dec/decode.h"
-#include "enc/encode.h"
-#include "enc/compressor.h"
 #include "tools/version.h"
 
 
@@ -162,239 +165,124 @@ namespace IO {
 //
 
 
-std::size_t Compression::uncompress(const ByteBuffer& compressedBuffer,
-                                    ByteBuffer& uncompressedBuffer,
-                                    Type type)
+namespace {
+
+
+/// \returns the calling thread's Compressor for the settings.
+Compressor& threadCompressor(Compression::Type type,
+                             int level,
+                             int windowBits,
+                             const CompressionDictionary& dictionary)
 {
-    switch (type)
+    static thread_local std::unique_ptr<Compressor> compressors[Compression::BR + 1];
+
+    std::unique_ptr<Compressor>& compressor = compressors[type];
+
+    if (compressor == nullptr
+    || compressor->level() != level
+    || compressor->windowBits() != windowBits
+    || compressor->dictionary() != dictionary)
     {
-        case GZIP:
-        case ZLIB:
-        {
-            Poco::InflatingStreamBuf::StreamType streamType;
-
-            if (type == GZIP)
-            {
-                streamType = Poco::InflatingStreamBuf::StreamType::STREAM_GZIP;
-            }
-            else
-            {
-                streamType = Poco::InflatingStreamBuf::StreamType::STREAM_ZLIB;
-            }
-
-            try
-            {
-                uncompressedBuffer.clear();
-                uncompressedBuffer.reserve(compressedBuffer.size() * 4);
-                ByteBufferInputStream istr(compressedBuffer);
-                Poco::InflatingInputStream inflater(istr, streamType);
-                inflater >> uncompressedBuffer;
-                return uncompressedBuffer.size();
-            }
-            catch (const Poco::Exception& exc)
-            {
-                ofLogError("Compression::uncompress") << exc.displayText();
-                return 0;
-            }
-        }
-        case SNAPPY:
-        {
-            std::size_t size = 0;
-
-            if (snappy::GetUncompressedLength(compressedBuffer.getCharPtr(),
-                                              compressedBuffer.size(),
-                                              &size))
-            {
-                uncompressedBuffer.resize(size);
-
-                if (snappy::RawUncompress(compressedBuffer.getCharPtr(),
-                                          compressedBuffer.size(),
-                                          uncompressedBuffer.getCharPtr()))
-                {
-                    return size;
-                }
-                else
-                {
-                    return 0;
-                }
-            }
-            else
-            {
-                return 0;
-            }
-        }
-        case LZ4:
-        {
-            // TODO: Abritrary 4 x buffer.
-            uncompressedBuffer.resize(compressedBuffer.size() * 4);
-
-            int result = LZ4_decompress_safe(compressedBuffer.getCharPtr(),
-                                             uncompressedBuffer.getCharPtr(),
-                                             compressedBuffer.size(),
-                                             uncompressedBuffer.size());
-
-            if (result >= 0)
-            {
-                uncompressedBuffer.resize(result);
-                return result;
-            }
-            else
-            {
-                return 0;
-            }
-        }
-        case BR:
-        {
-            size_t decodedSize = 0;
-
-            if (!BrotliDecompressedSize(compressedBuffer.size(), compressedBuffer.getPtr(), &decodedSize))
-            {
-                decodedSize = compressedBuffer.size() * 4;
-            }
-
-            uncompressedBuffer.resize(decodedSize);
-
-            BrotliResult result = BrotliDecompressBuffer(compressedBuffer.size(),
-                                                         compressedBuffer.getPtr(),
-                                                         &decodedSize,
-                                                         uncompressedBuffer.getPtr());
-
-            
-            if (result == BROTLI_RESULT_SUCCESS)
-            {
-                uncompressedBuffer.resize(decodedSize);
-                return decodedSize;
-            }
-            else
-            {
-                return 0;
-            }
+        compressor = std::make_unique<Compressor>(type, level, windowBits, dictionary);
+    }
 
-        }
-        case NONE:
-        {
-            uncompressedBuffer.clear();
-            uncompressedBuffer.writeBytes(compressedBuffer);
-        }
+    return *compressor;
+}
+
+
+/// \returns the calling thread's Decompressor for the settings.
+Decompressor& threadDecompressor(Compression::Type type,
+                                 int windowBits,
+                                 const CompressionDictionary& dictionary)
+{
+    static thread_local std::unique_ptr<Decompressor> decompressors[Compression::BR + 1];
+
+    std::unique_ptr<Decompressor>& decompressor = decompressors[type];
+
+    if (decompressor == nullptr
+    || decompressor->windowBits() != windowBits
+    || decompressor->dictionary() != dictionary)
+    {
+        decompressor = std::make_unique<Decompressor>(type, windowBits, dictionary);
     }
 
-    return 0;
+    return *decompressor;
 }
 
 
-std::size_t Compression::uncompress(const ByteBuffer& compressedBuffer,
+} // namespace
+
+
+std::size_t Compression::uncompress(const ByteBufferView& compressedBuffer,
                                     ByteBuffer& uncompressedBuffer,
-                                    int windowBits)
+                                    Type type)
+{
+    return threadDecompressor(type,
+                              MAX_WBITS,
+                              CompressionDictionary()).uncompress(compressedBuffer,
+                                                                  uncompressedBuffer);
+}
+
+
+std::size_t Compression::uncompress(const ByteBufferView& compressedBuffer,
+                                    ByteBuffer& uncompressedBuffer,
+                                    Type type,
+                                    const CompressionDictionary& dictionary)
 {
     try
     {
-        uncompressedBuffer.clear();
-        uncompressedBuffer.reserve(compressedBuffer.size() * 4);
-        ByteBufferInputStream istr(compressedBuffer);
-        Poco::InflatingInputStream inflater(istr, windowBits);
-        inflater >> uncompressedBuffer;
-        return uncompressedBuffer.size();
+        return threadDecompressor(type,
+                                  MAX_WBITS,
+                                  dictionary).uncompress(compressedBuffer,
+                                                         uncompressedBuffer);
     }
     catch (const Poco::Exception& exc)
     {
         ofLogError("Compression::uncompress") << exc.displayText();
+        uncompressedBuffer.clear();
         return 0;
     }
 }
 
 
-std::size_t Compression::compress(const ByteBuffer& uncompressedBuffer,
-                                  ByteBuffer& compressedBuffer,
-                                  Type type)
+std::size_t Compression::uncompress(const ByteBufferView& compressedBuffer,
+                                    ByteBuffer& uncompressedBuffer,
+                                    int windowBits)
 {
-    switch (type)
+    try
     {
-        case ZLIB:
-        case GZIP:
-        {
-            return compress(uncompressedBuffer,
-                            compressedBuffer,
-                            type,
-                            Z_DEFAULT_COMPRESSION);
-        }
-        case SNAPPY:
-        {
-            std::size_t size = 0;
-            // Allocate as many as needed.
-            compressedBuffer.resize(uncompressedBuffer.size() * 2);
-            snappy::RawCompress(uncompressedBuffer.getCharPtr(),
-                                uncompressedBuffer.size(),
-                                compressedBuffer.getCharPtr(),
-                                &size);
-            compressedBuffer.resize(size);
-            return size;
-        }
-        case LZ4:
-        {
-            std::size_t inputSize = uncompressedBuffer.size();
-            std::size_t size = 0;
-            // Allocate as many as needed.
-            compressedBuffer.resize(inputSize);
-            size = LZ4_compress_default(uncompressedBuffer.getCharPtr(),
-                                        compressedBuffer.getCharPtr(),
-                                        inputSize,
-                                        LZ4_compressBound(inputSize));
-
-            compressedBuffer.resize(size);
-            return size;
-        }
-        case BR:
-        {
-            brotli::BrotliParams params;
-
-            std::size_t encodedSize = BrotliEncoderMaxCompressedSize(uncompressedBuffer.size());
-
-            compressedBuffer.resize(encodedSize);
-
-            int result = brotli::BrotliCompressBuffer(params,
-                                                      uncompressedBuffer.size(),
-                                                      uncompressedBuffer.getPtr(),
-                                                      &encodedSize,
-                                                      compressedBuffer.getPtr());
-
-            if (result == 1)
-            {
-                compressedBuffer.resize(encodedSize);
-                return encodedSize;
-            }
-            else
-            {
-                ofLogError("Compression::compress") << "brotli::BrotliCompressBuffer compression error.";
-                return 0;
-            }
-        }
-        case NONE:
-        {
-            compressedBuffer.clear();
-            compressedBuffer.writeBytes(uncompressedBuffer);
-        }
+        return threadDecompressor(ZLIB,
+                                  windowBits,
+                                  CompressionDictionary()).uncompress(compressedBuffer,
+                                                                      uncompressedBuffer);
+    }
+    catch (const Poco::Exception& exc)
+    {
+        ofLogError("Compression::uncompress") << exc.displayText();
+        uncompressedBuffer.clear();
+        return 0;
     }
+}
+
 
-    return 0;
+std::size_t Compression::compress(const ByteBufferView& uncompressedBuffer,
+                                  ByteBuffer& compressedBuffer,
+                                  Type type)
+{
+    return threadCompressor(type,
+                            Compressor::defaultLevel(type),
+                            Compressor::defaultWindowBits(type),
+                            CompressionDictionary()).compress(uncompressedBuffer,
+                                                              compressedBuffer);
 }
 
 
-std::size_t Compression::compress(const ByteBuffer& uncompressedBuffer,
+std::size_t Compression::compress(const ByteBufferView& uncompressedBuffer,
                                   ByteBuffer& compressedBuffer,
                                   Type type,
                                   int level)
 {
-    Poco::DeflatingStreamBuf::StreamType streamType;
-
-    if (type == ZLIB)
-    {
-        streamType = Poco::DeflatingStreamBuf::STREAM_ZLIB;
-    }
-    else if (type == GZIP)
-    {
-        streamType = Poco::DeflatingStreamBuf::STREAM_GZIP;
-    }
-    else
+    if (type == SNAPPY || type == NONE)
     {
         ofLogWarning("Compression::compress") << "Ignoring 'level' for type: " << toString(type);
         return compress(uncompressedBuffer, compressedBuffer, type);
@@ -402,42 +290,74 @@ std::size_t Compression::compress(const ByteBuffer& uncompressedBuffer,
 
     try
     {
+        return threadCompressor(type,
+                                level,
+                                Compressor::defaultWindowBits(type),
+                                CompressionDictionary()).compress(uncompressedBuffer,
+                                                                  compressedBuffer);
+    }
+    catch (const Poco::Exception& exc)
+    {
+        ofLogError("Compression::compress") << exc.displayText();
         compressedBuffer.clear();
-        compressedBuffer.reserve(uncompressedBuffer.size());
+        return 0;
+    }
+}
 
-        ByteBufferOutputStream ostr(compressedBuffer);
-        Poco::DeflatingOutputStream deflater(ostr, streamType, level);
-        deflater << uncompressedBuffer;
-        deflater.close();
 
-        return compressedBuffer.size();
+std::size_t Compression::compress(const ByteBufferView& uncompressedBuffer,
+                                  ByteBuffer& compressedBuffer,
+                                  Type type,
+                                  const CompressionDictionary& dictionary)
+{
+    return compress(uncompressedBuffer,
+                    compressedBuffer,
+                    type,
+                    Compressor::defaultLevel(type),
+                    dictionary);
+}
+
+
+std::size_t Compression::compress(const ByteBufferView& uncompressedBuffer,
+                                  ByteBuffer& compressedBuffer,
+                                  Type type,
+                                  int level,
+                                  const CompressionDictionary& dictionary)
+{
+    try
+    {
+        return threadCompressor(type,
+                                level,
+                                Compressor::defaultWindowBits(type),
+                                dictionary).compress(uncompressedBuffer,
+                                                     compressedBuffer);
     }
     catch (const Poco::Exception& exc)
     {
         ofLogError("Compression::compress") << exc.displayText();
+        compressedBuffer.clear();
         return 0;
     }
 }
 
 
-std::size_t Compression::compress(const ByteBuffer& uncompressedBuffer,
+std::size_t Compression::compress(const ByteBufferView& uncompressedBuffer,
                                   ByteBuffer& compressedBuffer,
                                   int windowBits,
                                   int level)
 {
     try
     {
-        compressedBuffer.clear();
-        compressedBuffer.reserve(uncompressedBuffer.size());
-        ByteBufferOutputStream ostr(compressedBuffer);
-        Poco::DeflatingOutputStream deflater(ostr, windowBits, level);
-        deflater << uncompressedBuffer;
-        deflater.close();
-        return compressedBuffer.size();
+        return threadCompressor(ZLIB,
+                                level,
+                                windowBits,
+                                CompressionDictionary()).compress(uncompressedBuffer,
+                                                                  compressedBuffer);
     }
     catch (const Poco::Exception& exc)
     {
-        ofLogError("Compression::uncompress") << exc.displayText();
+        ofLogError("Compression::compress") << exc.displayText();
+        compressedBuffer.clear();
         return 0;
     }
 }
@@ -0,0 +1,356 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/IO/CompressionDictionary.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include "Poco/Foundation.h"
+#if defined(POCO_UNBUNDLED)
+#include <zlib.h>
+#else
+#include "Poco/zlib.h"
+#endif
+#include "ofLog.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+namespace {
+
+
+enum
+{
+    /// \brief The length of the substrings counted between samples.
+    DMER_SIZE = 8,
+
+    /// \brief The length of the segment chosen from each epoch.
+    SEGMENT_SIZE = 64,
+
+    /// \brief The log2 of the number of substring counters.
+    HASH_BITS = 20
+};
+
+
+/// \returns the hash of the substring at p.
+inline uint32_t hashDmer(const uint8_t* p)
+{
+    uint64_t value = 0;
+    std::memcpy(&value, p, DMER_SIZE);
+    return uint32_t((value * 0xCF1BBCDCB7A56463ULL) >> (64 - HASH_BITS));
+}
+
+
+/// \returns the Adler-32 of a buffer.
+uint32_t adler(const uint8_t* buffer, std::size_t size)
+{
+    uLong checksum = adler32(0, Z_NULL, 0);
+
+    while (size > 0)
+    {
+        uInt chunk = uInt(std::min(size, std::size_t(UINT_MAX)));
+        checksum = adler32(checksum, buffer, chunk);
+        buffer += chunk;
+        size -= chunk;
+    }
+
+    return uint32_t(checksum);
+}
+
+
+inline uint32_t read32(const uint8_t* p)
+{
+    return uint32_t(p[0])
+         | uint32_t(p[1]) << 8
+         | uint32_t(p[2]) << 16
+         | uint32_t(p[3]) << 24;
+}
+
+
+inline void write32(uint8_t* p, uint32_t value)
+{
+    p[0] = uint8_t(value);
+    p[1] = uint8_t(value >> 8);
+    p[2] = uint8_t(value >> 16);
+    p[3] = uint8_t(value >> 24);
+}
+
+
+/// \brief A run of the training corpus chosen for the dictionary.
+struct Segment
+{
+    /// \brief The first byte in the corpus.
+    std::size_t begin;
+
+    /// \brief One past the last byte in the corpus.
+    std::size_t end;
+
+    /// \brief The sum of the sample counts of the substrings it covered.
+    uint64_t score;
+};
+
+
+} // namespace
+
+
+CompressionDictionary::CompressionDictionary()
+{
+}
+
+
+CompressionDictionary::CompressionDictionary(const ByteBufferView& content):
+    _content(content.getPtr(), content.size()),
+    _id(content.size() > 0 ? adler(content.getPtr(), content.size()) : 0)
+{
+}
+
+
+const ByteBuffer& CompressionDictionary::content() const
+{
+    return _content;
+}
+
+
+uint32_t CompressionDictionary::id() const
+{
+    return _id;
+}
+
+
+std::size_t CompressionDictionary::size() const
+{
+    return _content.size();
+}
+
+
+bool CompressionDictionary::empty() const
+{
+    return _content.empty();
+}
+
+
+bool CompressionDictionary::operator == (const CompressionDictionary& other) const
+{
+    if (_id != other._id || _content.size() != other._content.size())
+    {
+        return false;
+    }
+
+    // Empty content may have no storage to compare.
+    if (_content.size() == 0)
+    {
+        return true;
+    }
+
+    return std::memcmp(_content.getPtr(), other._content.getPtr(), _content.size()) == 0;
+}
+
+
+bool CompressionDictionary::operator != (const CompressionDictionary& other) const
+{
+    return !(*this == other);
+}
+
+
+ByteBuffer CompressionDictionary::toByteBuffer() const
+{
+    uint8_t header[8];
+    write32(header, MAGIC_NUMBER);
+    write32(header + 4, _id);
+
+    ByteBuffer buffer;
+    buffer.reserve(sizeof(header) + _content.size());
+    buffer.writeBytes(header, sizeof(header));
+    buffer.writeBytes(_content.getPtr(), _content.size());
+    return buffer;
+}
+
+
+bool CompressionDictionary::fromByteBuffer(const ByteBufferView& buffer,
+                                           CompressionDictionary& dictionary)
+{
+    const uint8_t* p = buffer.getPtr();
+
+    if (buffer.size() < 8 || read32(p) != MAGIC_NUMBER)
+    {
+        ofLogError("CompressionDictionary::fromByteBuffer") << "Not a compression dictionary.";
+        return false;
+    }
+
+    CompressionDictionary result(ByteBufferView(p + 8, buffer.size() - 8));
+
+    if (result.id() != read32(p + 4))
+    {
+        ofLogError("CompressionDictionary::fromByteBuffer") << "Compression dictionary ID mismatch.";
+        return false;
+    }
+
+    dictionary = std::move(result);
+    return true;
+}
+
+
+CompressionDictionary CompressionDictionary::train(const std::vector<ByteBuffer>& samples)
+{
+    return train(samples, DEFAULT_SIZE);
+}
+
+
+CompressionDictionary CompressionDictionary::train(const std::vector<ByteBuffer>& samples,
+                                                   std::size_t maximumSize)
+{
+    ByteBuffer corpus;
+    std::vector<std::size_t> sampleEnds;
+
+    for (const auto& sample: samples)
+    {
+        corpus.writeBytes(sample.getPtr(), sample.size());
+        sampleEnds.push_back(corpus.size());
+    }
+
+    if (corpus.size() < DMER_SIZE || maximumSize == 0)
+    {
+        return CompressionDictionary();
+    }
+
+    const std::size_t dmerCount = corpus.size() - DMER_SIZE + 1;
+    const uint8_t* data = corpus.getPtr();
+
+    std::vector<uint32_t> hashes(dmerCount);
+
+    // The number of samples each substring appears in.
+    std::vector<uint32_t> frequencies(std::size_t(1) << HASH_BITS, 0);
+    std::vector<uint32_t> lastSamples(std::size_t(1) << HASH_BITS, UINT32_MAX);
+
+    std::size_t sample = 0;
+
+    for (std::size_t i = 0; i < dmerCount; ++i)
+    {
+        while (i >= sampleEnds[sample])
+        {
+            ++sample;
+        }
+
+        uint32_t hash = hashDmer(data + i);
+        hashes[i] = hash;
+
+        if (lastSamples[hash] != sample)
+        {
+            lastSamples[hash] = uint32_t(sample);
+            ++frequencies[hash];
+        }
+    }
+
+    // A substring in one sample does not help the others.
+    for (auto& frequency: frequencies)
+    {
+        frequency = frequency > 1 ? frequency : 0;
+    }
+
+    const std::size_t dmersPerSegment = SEGMENT_SIZE - DMER_SIZE + 1;
+    const std::size_t epochCount = std::max(maximumSize / SEGMENT_SIZE, std::size_t(1));
+    const std::size_t epochSize = std::max(dmerCount / epochCount, std::size_t(SEGMENT_SIZE));
+
+    // The number of times each substring is in the sliding window.
+    std::vector<uint8_t> active(std::size_t(1) << HASH_BITS, 0);
+
+    std::vector<Segment> segments;
+    std::size_t total = 0;
+    bool isAdded = true;
+
+    // Each pass takes the best segment of each epoch. Chosen substrings no
+    // longer score, so later passes find what the earlier ones missed.
+    while (isAdded && total < maximumSize)
+    {
+        isAdded = false;
+
+        for (std::size_t epoch = 0; epoch < dmerCount && total < maximumSize; epoch += epochSize)
+        {
+            const std::size_t epochEnd = std::min(epoch + epochSize, dmerCount);
+
+            Segment best = { 0, 0, 0 };
+            uint64_t score = 0;
+            std::size_t begin = epoch;
+
+            for (std::size_t end = epoch; end < epochEnd; ++end)
+            {
+                if (active[hashes[end]]++ == 0)
+                {
+                    score += frequencies[hashes[end]];
+                }
+
+                if (end + 1 - begin > dmersPerSegment)
+                {
+                    if (--active[hashes[begin]] == 0)
+                    {
+                        score -= frequencies[hashes[begin]];
+                    }
+
+                    ++begin;
+                }
+
+                if (score > best.score)
+                {
+                    best = { begin, end + 1, score };
+                }
+            }
+
+            for (; begin < epochEnd; ++begin)
+            {
+                --active[hashes[begin]];
+            }
+
+            if (best.score == 0)
+            {
+                continue;
+            }
+
+            // Drop the substrings at either end that no longer score.
+            while (frequencies[hashes[best.begin]] == 0)
+            {
+                ++best.begin;
+            }
+
+            while (frequencies[hashes[best.end - 1]] == 0)
+            {
+                --best.end;
+            }
+
+            for (std::size_t i = best.begin; i < best.end; ++i)
+            {
+                frequencies[hashes[i]] = 0;
+            }
+
+            // From dmer positions to bytes.
+            best.end = std::min(best.end - 1 + DMER_SIZE, best.begin + (maximumSize - total));
+            total += best.end - best.begin;
+
+            segments.push_back(best);
+            isAdded = true;
+        }
+    }
+
+    // The nearest content is the cheapest to refer to, so the best is last.
+    std::stable_sort(segments.begin(), segments.end(), [](const Segment& a, const Segment& b) {
+        return a.score < b.score;
+    });
+
+    ByteBuffer content;
+    content.reserve(total);
+
+    for (const auto& segment: segments)
+    {
+        content.writeBytes(data + segment.begin, segment.end - segment.begin);
+    }
+
+    return CompressionDictionary(content);
+}
+
+
+} }  // namespace ofx::IO
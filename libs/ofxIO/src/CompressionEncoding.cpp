@@ -0,0 +1,73 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/IO/CompressionEncoding.h"
+#include "ofx/IO/Compressor.h"
+#include "ofx/IO/Decompressor.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+CompressionEncoding::CompressionEncoding(Compression::Type type): _type(type)
+{
+}
+
+
+CompressionEncoding::~CompressionEncoding()
+{
+}
+
+
+std::size_t CompressionEncoding::encode(const ByteBuffer& buffer,
+                                        ByteBuffer& encodedBuffer)
+{
+    return encode(ByteBufferView(buffer), encodedBuffer);
+}
+
+
+std::size_t CompressionEncoding::decode(const ByteBuffer& buffer,
+                                        ByteBuffer& decodedBuffer)
+{
+    return decode(ByteBufferView(buffer), decodedBuffer);
+}
+
+
+std::size_t CompressionEncoding::encode(const ByteBufferView& buffer,
+                                        ByteBuffer& encodedBuffer)
+{
+    return Compression::compress(buffer, encodedBuffer, _type);
+}
+
+
+std::size_t CompressionEncoding::decode(const ByteBufferView& buffer,
+                                        ByteBuffer& decodedBuffer)
+{
+    return Compression::uncompress(buffer, decodedBuffer, _type);
+}
+
+
+std::unique_ptr<AbstractByteTransform> CompressionEncoding::createStreamEncoder()
+{
+    return std::make_unique<Compressor>(_type);
+}
+
+
+std::unique_ptr<AbstractByteTransform> CompressionEncoding::createStreamDecoder()
+{
+    return std::make_unique<Decompressor>(_type);
+}
+
+
+Compression::Type CompressionEncoding::type() const
+{
+    return _type;
+}
+
+
+} }  // namespace ofx::IO
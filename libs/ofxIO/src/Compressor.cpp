@@ -0,0 +1,734 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/IO/Compressor.h"
+#include "ofx/IO/LZ4Frame.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <vector>
+#include "Poco/Exception.h"
+#include "Poco/Foundation.h"
+#if defined(POCO_UNBUNDLED)
+#include <zlib.h>
+#else
+#include "Poco/zlib.h"
+#endif
+#include "snappy.h"
+#include "ofLog.h"
+
+#include "enc/encode.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+class Compressor::Context: public AbstractByteTransform
+{
+public:
+    /// \brief Compress a whole message into an empty buffer.
+    ///
+    /// The default implementation calls update() and finish(). Codecs that
+    /// can do better with the whole message override it.
+    virtual void compress(const ByteBufferView& buffer,
+                          ByteBuffer& outputBuffer)
+    {
+        update(buffer, outputBuffer);
+        finish(outputBuffer);
+    }
+
+};
+
+
+namespace {
+
+
+/// \brief A deflate stream, reset rather than rebuilt for each message.
+///
+/// A dictionary is set again after each reset, and zlib records its
+/// Adler-32 in the header.
+class ZlibContext: public Compressor::Context
+{
+public:
+    ZlibContext(int level, int windowBits, const CompressionDictionary& dictionary):
+        _dictionary(dictionary)
+    {
+        if (!dictionary.empty() && windowBits > MAX_WBITS)
+        {
+            throw Poco::InvalidArgumentException("gzip streams do not support dictionaries.");
+        }
+
+        if (deflateInit2(&_stream, level, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            throw Poco::InvalidArgumentException("Invalid zlib window bits: " + std::to_string(windowBits) + " or level: " + std::to_string(level));
+        }
+
+        _setDictionary();
+    }
+
+    ~ZlibContext() override
+    {
+        deflateEnd(&_stream);
+    }
+
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        return _deflate(buffer.getPtr(), buffer.size(), outputBuffer, Z_NO_FLUSH);
+    }
+
+    std::size_t finish(ByteBuffer& outputBuffer) override
+    {
+        std::size_t written = _deflate(nullptr, 0, outputBuffer, Z_FINISH);
+        reset();
+        return written;
+    }
+
+    void reset() override
+    {
+        // A reset clears the hash table, so skip it if nothing was added.
+        if (_isUsed)
+        {
+            deflateReset(&_stream);
+            _setDictionary();
+            _isUsed = false;
+        }
+    }
+
+    void compress(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        _deflate(buffer.getPtr(), buffer.size(), outputBuffer, Z_FINISH);
+        reset();
+    }
+
+private:
+    void _setDictionary()
+    {
+        if (!_dictionary.empty())
+        {
+            deflateSetDictionary(&_stream,
+                                 _dictionary.content().getPtr(),
+                                 uInt(_dictionary.size()));
+        }
+    }
+
+    std::size_t _deflate(const uint8_t* in,
+                         std::size_t size,
+                         ByteBuffer& outputBuffer,
+                         int flush)
+    {
+        const std::size_t offset = outputBuffer.size();
+
+        // The bound includes the header and trailer, so one deflate() call
+        // normally finishes a whole message.
+        outputBuffer.resize(offset + deflateBound(&_stream, uLong(std::min(size, std::size_t(ULONG_MAX)))));
+
+        std::size_t written = offset;
+
+        _isUsed = true;
+
+        while (true)
+        {
+            if (written == outputBuffer.size())
+            {
+                outputBuffer.resize(offset + (outputBuffer.size() - offset) * 2);
+            }
+
+            uInt inChunk = uInt(std::min(size, std::size_t(UINT_MAX)));
+            uInt outChunk = uInt(std::min(outputBuffer.size() - written, std::size_t(UINT_MAX)));
+
+            _stream.next_in = const_cast<Bytef*>(in);
+            _stream.avail_in = inChunk;
+            _stream.next_out = outputBuffer.getPtr() + written;
+            _stream.avail_out = outChunk;
+
+            int result = deflate(&_stream, inChunk == size ? flush : Z_NO_FLUSH);
+
+            if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+            {
+                outputBuffer.resize(offset);
+                reset();
+                throw Poco::IOException(std::string("zlib error: ") + (_stream.msg ? _stream.msg : "unknown"));
+            }
+
+            in += inChunk - _stream.avail_in;
+            size -= inChunk - _stream.avail_in;
+            written += outChunk - _stream.avail_out;
+
+            if (flush == Z_FINISH ? result == Z_STREAM_END : (size == 0 && _stream.avail_out != 0))
+            {
+                break;
+            }
+        }
+
+        outputBuffer.resize(written);
+        return written - offset;
+    }
+
+    const CompressionDictionary& _dictionary;
+
+    z_stream _stream = z_stream();
+
+    /// \brief True if the stream has taken input since its last reset.
+    bool _isUsed = false;
+
+};
+
+
+/// \brief An LZ4 frame compressor.
+class LZ4Context: public Compressor::Context
+{
+public:
+    LZ4Context(int level, const CompressionDictionary& dictionary):
+        _hasDictionary(!dictionary.empty())
+    {
+        // Negative levels are the fast compressor's acceleration. LZ4Frame
+        // takes levels from 3 up as LZ4HC levels.
+        _settings.acceleration = std::max(-level, 1);
+        _settings.level = level;
+        _encoder = LZ4Frame::createStreamEncoder(_settings, dictionary);
+    }
+
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        return _encoder->update(buffer, outputBuffer);
+    }
+
+    std::size_t finish(ByteBuffer& outputBuffer) override
+    {
+        return _encoder->finish(outputBuffer);
+    }
+
+    void reset() override
+    {
+        _encoder->reset();
+    }
+
+    void compress(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        if (_hasDictionary)
+        {
+            // The stream encoder keeps its loaded dictionary.
+            _encoder->update(buffer, outputBuffer);
+            _encoder->finish(outputBuffer);
+        }
+        else
+        {
+            // Records the content size of any message, and reads whole
+            // blocks straight from it.
+            LZ4Frame::compress(buffer, outputBuffer, _settings);
+        }
+    }
+
+private:
+    LZ4Frame::Settings _settings;
+    bool _hasDictionary = false;
+    std::unique_ptr<AbstractByteTransform> _encoder;
+
+};
+
+
+/// \brief A snappy compressor.
+///
+/// Snappy compresses whole buffers, so a message in pieces is collected.
+/// The collection buffer keeps its capacity for the next message.
+class SnappyContext: public Compressor::Context
+{
+public:
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer&) override
+    {
+        // Snappy is not a streaming format, so nothing is written until finish().
+        _input.writeBytes(buffer.getPtr(), buffer.size());
+        return 0;
+    }
+
+    std::size_t finish(ByteBuffer& outputBuffer) override
+    {
+        std::size_t written = _compress(_input.getPtr(), _input.size(), outputBuffer);
+        _input.clear();
+        return written;
+    }
+
+    void reset() override
+    {
+        _input.clear();
+    }
+
+    void compress(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        _compress(buffer.getPtr(), buffer.size(), outputBuffer);
+    }
+
+private:
+    static std::size_t _compress(const uint8_t* buffer,
+                                 std::size_t size,
+                                 ByteBuffer& outputBuffer)
+    {
+        const std::size_t offset = outputBuffer.size();
+        std::size_t written = 0;
+
+        outputBuffer.resize(offset + snappy::MaxCompressedLength(size));
+
+        snappy::RawCompress(reinterpret_cast<const char*>(buffer),
+                            size,
+                            outputBuffer.getCharPtr() + offset,
+                            &written);
+
+        outputBuffer.resize(offset + written);
+        return written;
+    }
+
+    /// \brief The message collected so far.
+    ByteBuffer _input;
+
+};
+
+
+/// \brief Brotli memory that is kept for the next message.
+///
+/// The brotli encoder cannot be reset, so each message creates and destroys
+/// one. Its state, ring buffer and hash tables are the same sizes each
+/// time, so freed blocks are kept and handed out again.
+class BrotliMemory
+{
+public:
+    ~BrotliMemory()
+    {
+        for (auto& block: _blocks)
+        {
+            std::free(block.address);
+        }
+    }
+
+    static void* allocate(void* opaque, std::size_t size)
+    {
+        BrotliMemory* memory = static_cast<BrotliMemory*>(opaque);
+        Block* best = nullptr;
+
+        for (auto& block: memory->_blocks)
+        {
+            if (!block.isUsed
+            && block.size >= size
+            && block.size / 2 <= size
+            && (best == nullptr || block.size < best->size))
+            {
+                best = &block;
+            }
+        }
+
+        if (best == nullptr)
+        {
+            void* address = std::malloc(size);
+
+            if (address == nullptr)
+            {
+                return nullptr;
+            }
+
+            memory->_blocks.push_back({ address, size, false });
+            best = &memory->_blocks.back();
+        }
+
+        best->isUsed = true;
+        return best->address;
+    }
+
+    static void release(void* opaque, void* address)
+    {
+        if (address == nullptr)
+        {
+            return;
+        }
+
+        BrotliMemory* memory = static_cast<BrotliMemory*>(opaque);
+
+        for (std::size_t i = 0; i < memory->_blocks.size(); ++i)
+        {
+            Block& block = memory->_blocks[i];
+
+            if (block.address == address)
+            {
+                if (memory->_blocks.size() > MAXIMUM_BLOCKS)
+                {
+                    std::free(block.address);
+                    block = memory->_blocks.back();
+                    memory->_blocks.pop_back();
+                }
+                else
+                {
+                    block.isUsed = false;
+                }
+
+                return;
+            }
+        }
+    }
+
+private:
+    enum
+    {
+        /// \brief The most blocks kept. An encoder uses about a dozen.
+        MAXIMUM_BLOCKS = 64
+    };
+
+    struct Block
+    {
+        void* address;
+        std::size_t size;
+        bool isUsed;
+    };
+
+    std::vector<Block> _blocks;
+
+};
+
+
+/// \brief A brotli compressor.
+///
+/// The fast qualities 0 and 1 ignore a custom dictionary, so a dictionary
+/// raises the quality to 2.
+class BrotliContext: public Compressor::Context
+{
+public:
+    BrotliContext(int quality, int windowBits, const CompressionDictionary& dictionary):
+        _quality(std::min(std::max(quality, dictionary.empty() ? BROTLI_MIN_QUALITY : 2), BROTLI_MAX_QUALITY)),
+        _windowBits(std::min(std::max(windowBits, kBrotliMinWindowBits), kBrotliMaxWindowBits)),
+        _dictionary(dictionary)
+    {
+    }
+
+    ~BrotliContext() override
+    {
+        reset();
+    }
+
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        _begin(_windowBits);
+        return _compress(buffer.getPtr(), buffer.size(), outputBuffer, BROTLI_OPERATION_PROCESS);
+    }
+
+    std::size_t finish(ByteBuffer& outputBuffer) override
+    {
+        _begin(_windowBits);
+        std::size_t written = _compress(nullptr, 0, outputBuffer, BROTLI_OPERATION_FINISH);
+        reset();
+        return written;
+    }
+
+    void reset() override
+    {
+        if (_state != nullptr)
+        {
+            BrotliEncoderDestroyInstance(_state);
+            _state = nullptr;
+        }
+    }
+
+    void compress(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        // A window larger than the message and dictionary costs memory and
+        // time, and gains nothing.
+        const std::size_t size = buffer.size() + _dictionary.size();
+        int windowBits = kBrotliMinWindowBits;
+
+        while (windowBits < _windowBits
+           && (std::size_t(1) << windowBits) - 16 < size)
+        {
+            ++windowBits;
+        }
+
+        _begin(windowBits);
+        _compress(buffer.getPtr(), buffer.size(), outputBuffer, BROTLI_OPERATION_FINISH);
+        reset();
+    }
+
+private:
+    void _begin(int windowBits)
+    {
+        if (_state != nullptr)
+        {
+            return;
+        }
+
+        _state = BrotliEncoderCreateInstance(&BrotliMemory::allocate,
+                                             &BrotliMemory::release,
+                                             &_memory);
+
+        if (_state == nullptr)
+        {
+            throw Poco::OutOfMemoryException("Unable to create a brotli encoder.");
+        }
+
+        BrotliEncoderSetParameter(_state, BROTLI_PARAM_QUALITY, uint32_t(_quality));
+        BrotliEncoderSetParameter(_state, BROTLI_PARAM_LGWIN, uint32_t(windowBits));
+
+        if (!_dictionary.empty())
+        {
+            BrotliEncoderSetCustomDictionary(_state,
+                                             _dictionary.size(),
+                                             _dictionary.content().getPtr());
+        }
+    }
+
+    std::size_t _compress(const uint8_t* in,
+                          std::size_t size,
+                          ByteBuffer& outputBuffer,
+                          BrotliEncoderOperation operation)
+    {
+        const std::size_t offset = outputBuffer.size();
+
+        outputBuffer.resize(offset + std::max(BrotliEncoderMaxCompressedSize(size), std::size_t(1024)));
+
+        std::size_t written = offset;
+
+        while (true)
+        {
+            if (written == outputBuffer.size())
+            {
+                outputBuffer.resize(offset + (outputBuffer.size() - offset) * 2);
+            }
+
+            std::size_t availableIn = size;
+            std::size_t availableOut = outputBuffer.size() - written;
+            uint8_t* out = outputBuffer.getPtr() + written;
+
+            if (!BrotliEncoderCompressStream(_state, operation, &availableIn, &in, &availableOut, &out, nullptr))
+            {
+                outputBuffer.resize(offset);
+                reset();
+                throw Poco::IOException("brotli compression error.");
+            }
+
+            size = availableIn;
+            written = std::size_t(out - outputBuffer.getPtr());
+
+            if (operation == BROTLI_OPERATION_FINISH
+                ? BrotliEncoderIsFinished(_state)
+                : (size == 0 && !BrotliEncoderHasMoreOutput(_state)))
+            {
+                break;
+            }
+        }
+
+        outputBuffer.resize(written);
+        return written - offset;
+    }
+
+    int _quality = BROTLI_DEFAULT_QUALITY;
+    int _windowBits = BROTLI_DEFAULT_WINDOW;
+
+    const CompressionDictionary& _dictionary;
+
+    BrotliMemory _memory;
+    BrotliEncoderState* _state = nullptr;
+
+};
+
+
+/// \brief Copies the input.
+class NoneContext: public Compressor::Context
+{
+public:
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        return outputBuffer.writeBytes(buffer.getPtr(), buffer.size());
+    }
+
+    std::size_t finish(ByteBuffer&) override
+    {
+        return 0;
+    }
+
+    void reset() override
+    {
+    }
+
+};
+
+
+} // namespace
+
+
+Compressor::Compressor(Compression::Type type):
+    Compressor(type, defaultLevel(type), defaultWindowBits(type))
+{
+}
+
+
+Compressor::Compressor(Compression::Type type, int level):
+    Compressor(type, level, defaultWindowBits(type))
+{
+}
+
+
+Compressor::Compressor(Compression::Type type, int level, int windowBits):
+    Compressor(type, level, windowBits, CompressionDictionary())
+{
+}
+
+
+Compressor::Compressor(Compression::Type type,
+                       const CompressionDictionary& dictionary):
+    Compressor(type, defaultLevel(type), defaultWindowBits(type), dictionary)
+{
+}
+
+
+Compressor::Compressor(Compression::Type type,
+                       int level,
+                       const CompressionDictionary& dictionary):
+    Compressor(type, level, defaultWindowBits(type), dictionary)
+{
+}
+
+
+Compressor::Compressor(Compression::Type type,
+                       int level,
+                       int windowBits,
+                       const CompressionDictionary& dictionary):
+    _type(type),
+    _level(level),
+    _windowBits(windowBits),
+    _dictionary(dictionary)
+{
+    switch (type)
+    {
+        case Compression::ZLIB:
+            _context = std::make_unique<ZlibContext>(level, windowBits, _dictionary);
+            break;
+        case Compression::GZIP:
+            _context = std::make_unique<ZlibContext>(level, windowBits + 16, _dictionary);
+            break;
+        case Compression::LZ4:
+            _context = std::make_unique<LZ4Context>(level, _dictionary);
+            break;
+        case Compression::SNAPPY:
+            if (!_dictionary.empty())
+            {
+                throw Poco::InvalidArgumentException("snappy does not support dictionaries.");
+            }
+
+            _context = std::make_unique<SnappyContext>();
+            break;
+        case Compression::BR:
+            _context = std::make_unique<BrotliContext>(level, windowBits, _dictionary);
+            break;
+        case Compression::NONE:
+            _context = std::make_unique<NoneContext>();
+            break;
+    }
+}
+
+
+Compressor::~Compressor()
+{
+}
+
+
+std::size_t Compressor::update(const ByteBufferView& buffer,
+                               ByteBuffer& outputBuffer)
+{
+    return _context->update(buffer, outputBuffer);
+}
+
+
+std::size_t Compressor::finish(ByteBuffer& outputBuffer)
+{
+    return _context->finish(outputBuffer);
+}
+
+
+void Compressor::reset()
+{
+    _context->reset();
+}
+
+
+std::size_t Compressor::compress(const ByteBufferView& uncompressedBuffer,
+                                 ByteBuffer& compressedBuffer)
+{
+    compressedBuffer.clear();
+
+    try
+    {
+        _context->reset();
+        _context->compress(uncompressedBuffer, compressedBuffer);
+        return compressedBuffer.size();
+    }
+    catch (const Poco::Exception& exc)
+    {
+        ofLogError("Compressor::compress") << exc.displayText();
+        compressedBuffer.clear();
+        return 0;
+    }
+}
+
+
+Compression::Type Compressor::type() const
+{
+    return _type;
+}
+
+
+int Compressor::level() const
+{
+    return _level;
+}
+
+
+int Compressor::windowBits() const
+{
+    return _windowBits;
+}
+
+
+const CompressionDictionary& Compressor::dictionary() const
+{
+    return _dictionary;
+}
+
+
+int Compressor::defaultLevel(Compression::Type type)
+{
+    switch (type)
+    {
+        case Compression::ZLIB:
+        case Compression::GZIP:
+            return Z_DEFAULT_COMPRESSION;
+        case Compression::BR:
+            return BROTLI_DEFAULT_QUALITY;
+        case Compression::LZ4:
+        case Compression::SNAPPY:
+        case Compression::NONE:
+            return 0;
+    }
+
+    return 0;
+}
+
+
+int Compressor::defaultWindowBits(Compression::Type type)
+{
+    switch (type)
+    {
+        case Compression::ZLIB:
+        case Compression::GZIP:
+            return MAX_WBITS;
+        case Compression::BR:
+            return BROTLI_DEFAULT_WINDOW;
+        case Compression::LZ4:
+        case Compression::SNAPPY:
+        case Compression::NONE:
+            return 0;
+    }
+
+    return 0;
+}
+
+
+} }  // namespace ofx::IO
@@ -0,0 +1,748 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/IO/Decompressor.h"
+#include "ofx/IO/LZ4Frame.h"
+#include <algorithm>
+#include <climits>
+#include "Poco/Exception.h"
+#include "Poco/Foundation.h"
+#if defined(POCO_UNBUNDLED)
+#include <zlib.h>
+#else
+#include "Poco/zlib.h"
+#endif
+#include "snappy.h"
+#include "lz4.h"
+#include "ofLog.h"
+
+#include "dec/decode.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+class Decompressor::Context: public AbstractByteTransform
+{
+public:
+    /// \brief Uncompress a whole message into an empty buffer.
+    ///
+    /// The default implementation calls update() and finish(). Codecs that
+    /// can do better with the whole message override it.
+    virtual void uncompress(const ByteBufferView& buffer,
+                            ByteBuffer& outputBuffer)
+    {
+        update(buffer, outputBuffer);
+        finish(outputBuffer);
+    }
+
+};
+
+
+namespace {
+
+
+/// \brief The largest ratio of uncompressed to deflated bytes.
+const std::size_t MAXIMUM_DEFLATE_RATIO = 1032;
+
+
+/// \returns true if the bytes may begin a gzip member.
+bool isGzip(const uint8_t* buffer, std::size_t size)
+{
+    return size >= 1 && buffer[0] == 0x1f && (size < 2 || buffer[1] == 0x8b);
+}
+
+
+/// \brief An inflate stream, reset rather than rebuilt for each message.
+///
+/// A zlib stream asks for its dictionary by ID. A raw deflate stream does
+/// not, so its dictionary is set after each reset.
+class ZlibContext: public Decompressor::Context
+{
+public:
+    ZlibContext(int windowBits, const CompressionDictionary& dictionary):
+        _isGzip(windowBits > MAX_WBITS),
+        _isRaw(windowBits < 0),
+        _dictionary(dictionary)
+    {
+        if (!dictionary.empty() && windowBits > MAX_WBITS && windowBits <= MAX_WBITS + 16)
+        {
+            throw Poco::InvalidArgumentException("gzip streams do not support dictionaries.");
+        }
+
+        if (inflateInit2(&_stream, windowBits) != Z_OK)
+        {
+            throw Poco::InvalidArgumentException("Invalid zlib window bits: " + std::to_string(windowBits));
+        }
+
+        _setRawDictionary();
+    }
+
+    ~ZlibContext() override
+    {
+        inflateEnd(&_stream);
+    }
+
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        return _inflate(buffer.getPtr(), buffer.size(), outputBuffer, buffer.size() * 4);
+    }
+
+    std::size_t finish(ByteBuffer&) override
+    {
+        bool isEnded = _isEnded;
+
+        reset();
+
+        if (!isEnded)
+        {
+            throw Poco::DataFormatException("zlib error: unexpected end of input");
+        }
+
+        return 0;
+    }
+
+    void reset() override
+    {
+        if (_isUsed)
+        {
+            inflateReset(&_stream);
+            _setRawDictionary();
+            _isUsed = false;
+            _isEnded = false;
+        }
+    }
+
+    void uncompress(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        const uint8_t* in = buffer.getPtr();
+        const std::size_t size = buffer.size();
+
+        // A gzip member ends with its uncompressed size modulo 2^32. Without
+        // one, start at 4 x and grow.
+        std::size_t capacity = size * 4;
+
+        if (size >= 18 && isGzip(in, size))
+        {
+            const uint8_t* trailer = in + size - 4;
+            capacity = std::size_t(trailer[0])
+                     | std::size_t(trailer[1]) << 8
+                     | std::size_t(trailer[2]) << 16
+                     | std::size_t(trailer[3]) << 24;
+            capacity = std::min(capacity, size * MAXIMUM_DEFLATE_RATIO);
+        }
+
+        _inflate(in, size, outputBuffer, capacity);
+        finish(outputBuffer);
+    }
+
+private:
+    void _setRawDictionary()
+    {
+        if (_isRaw && !_dictionary.empty())
+        {
+            inflateSetDictionary(&_stream,
+                                 _dictionary.content().getPtr(),
+                                 uInt(_dictionary.size()));
+        }
+    }
+
+    std::size_t _inflate(const uint8_t* in,
+                         std::size_t size,
+                         ByteBuffer& outputBuffer,
+                         std::size_t capacity)
+    {
+        if (_isEnded)
+        {
+            // Concatenated gzip members decode as one, like gunzip. Anything
+            // else after the end of the stream is ignored.
+            if (!_isGzip || !isGzip(in, size) || inflateReset(&_stream) != Z_OK)
+            {
+                return 0;
+            }
+
+            _isEnded = false;
+        }
+
+        const std::size_t offset = outputBuffer.size();
+
+        outputBuffer.resize(offset + std::max(capacity, std::size_t(64)));
+
+        std::size_t written = offset;
+
+        _isUsed = true;
+
+        while (true)
+        {
+            if (written == outputBuffer.size())
+            {
+                outputBuffer.resize(offset + (outputBuffer.size() - offset) * 2);
+            }
+
+            uInt inChunk = uInt(std::min(size, std::size_t(UINT_MAX)));
+            uInt outChunk = uInt(std::min(outputBuffer.size() - written, std::size_t(UINT_MAX)));
+
+            _stream.next_in = const_cast<Bytef*>(in);
+            _stream.avail_in = inChunk;
+            _stream.next_out = outputBuffer.getPtr() + written;
+            _stream.avail_out = outChunk;
+
+            int result = inflate(&_stream, Z_NO_FLUSH);
+
+            in += inChunk - _stream.avail_in;
+            size -= inChunk - _stream.avail_in;
+            written += outChunk - _stream.avail_out;
+
+            if (result == Z_NEED_DICT)
+            {
+                // The stream records the Adler-32 of its dictionary.
+                std::string message = "zlib dictionary ID mismatch.";
+
+                if (_dictionary.empty())
+                {
+                    message = "zlib stream needs dictionary " + std::to_string(_stream.adler) + ".";
+                }
+                else if (inflateSetDictionary(&_stream,
+                                              _dictionary.content().getPtr(),
+                                              uInt(_dictionary.size())) == Z_OK)
+                {
+                    continue;
+                }
+
+                outputBuffer.resize(offset);
+                reset();
+                throw Poco::DataFormatException(message);
+            }
+            else if (result == Z_STREAM_END)
+            {
+                if (_isGzip && isGzip(in, size) && inflateReset(&_stream) == Z_OK)
+                {
+                    continue;
+                }
+
+                _isEnded = true;
+                break;
+            }
+            else if (result != Z_OK && result != Z_BUF_ERROR)
+            {
+                std::string message = _stream.msg ? _stream.msg : "unknown";
+                outputBuffer.resize(offset);
+                reset();
+                throw Poco::DataFormatException("zlib error: " + message);
+            }
+            else if (_stream.avail_out != 0 && (size == 0 || result == Z_BUF_ERROR))
+            {
+                // All input is used.
+                break;
+            }
+        }
+
+        outputBuffer.resize(written);
+        return written - offset;
+    }
+
+    z_stream _stream = z_stream();
+
+    /// \brief True if gzip members may follow each other.
+    bool _isGzip = false;
+
+    /// \brief True if the stream is raw deflate, without a header.
+    bool _isRaw = false;
+
+    const CompressionDictionary& _dictionary;
+
+    /// \brief True if the stream has taken input since its last reset.
+    bool _isUsed = false;
+
+    /// \brief True if the end of the stream was reached.
+    bool _isEnded = false;
+
+};
+
+
+/// \brief An LZ4 frame uncompressor that also reads raw LZ4 blocks.
+class LZ4Context: public Decompressor::Context
+{
+public:
+    LZ4Context(const CompressionDictionary& dictionary):
+        _dictionary(dictionary),
+        _decoder(LZ4Frame::createStreamDecoder(dictionary))
+    {
+    }
+
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        if (_mode == MODE_FRAME)
+        {
+            return _decoder->update(buffer, outputBuffer);
+        }
+
+        _input.writeBytes(buffer.getPtr(), buffer.size());
+
+        if (_mode == MODE_UNKNOWN && _input.size() >= 4)
+        {
+            if (_isFrame(_input))
+            {
+                _mode = MODE_FRAME;
+                std::size_t written = _decoder->update(_input, outputBuffer);
+                _input.clear();
+                return written;
+            }
+
+            _mode = MODE_BLOCK;
+        }
+
+        return 0;
+    }
+
+    std::size_t finish(ByteBuffer& outputBuffer) override
+    {
+        Mode mode = _mode;
+        _mode = MODE_UNKNOWN;
+
+        if (mode == MODE_FRAME)
+        {
+            return _decoder->finish(outputBuffer);
+        }
+
+        std::size_t written = _uncompressBlock(_input, outputBuffer);
+        _input.clear();
+        return written;
+    }
+
+    void reset() override
+    {
+        _mode = MODE_UNKNOWN;
+        _input.clear();
+        _decoder->reset();
+    }
+
+    void uncompress(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        if (_isFrame(buffer))
+        {
+            _decoder->update(buffer, outputBuffer);
+            _decoder->finish(outputBuffer);
+        }
+        else
+        {
+            _uncompressBlock(buffer, outputBuffer);
+        }
+    }
+
+private:
+    enum Mode
+    {
+        MODE_UNKNOWN,
+        MODE_FRAME,
+        MODE_BLOCK
+    };
+
+    /// \returns true if the buffer starts with a frame or skippable frame.
+    static bool _isFrame(const ByteBufferView& buffer)
+    {
+        const uint8_t* p = buffer.getPtr();
+
+        return LZ4Frame::isFrame(buffer)
+            || (buffer.size() >= 4 && (p[0] & 0xF0) == 0x50 && p[1] == 0x2A && p[2] == 0x4D && p[3] == 0x18);
+    }
+
+    /// \brief Uncompress a raw LZ4 block.
+    ///
+    /// A raw LZ4 block, as written before frames were used, does not record
+    /// its size. Grow until it fits, up to the largest ratio.
+    std::size_t _uncompressBlock(const ByteBufferView& buffer,
+                                 ByteBuffer& outputBuffer) const
+    {
+        const std::size_t offset = outputBuffer.size();
+        const std::size_t limit = buffer.size() * 256 + 64;
+        std::size_t capacity = std::min(buffer.size() * 4 + 64, limit);
+
+        while (capacity <= std::size_t(LZ4_MAX_INPUT_SIZE))
+        {
+            outputBuffer.resize(offset + capacity);
+
+            int result = LZ4_decompress_safe_usingDict(buffer.getCharPtr(),
+                                                       outputBuffer.getCharPtr() + offset,
+                                                       int(buffer.size()),
+                                                       int(capacity),
+                                                       _dictionary.content().getCharPtr(),
+                                                       int(_dictionary.size()));
+
+            if (result >= 0)
+            {
+                outputBuffer.resize(offset + std::size_t(result));
+                return std::size_t(result);
+            }
+            else if (capacity == limit)
+            {
+                break;
+            }
+
+            capacity = std::min(capacity * 2, limit);
+        }
+
+        outputBuffer.resize(offset);
+        throw Poco::DataFormatException("Corrupt LZ4 block.");
+    }
+
+    Mode _mode = MODE_UNKNOWN;
+
+    /// \brief The input collected until its format is known, or all of a
+    /// raw block.
+    ByteBuffer _input;
+
+    const CompressionDictionary& _dictionary;
+
+    std::unique_ptr<AbstractByteTransform> _decoder;
+
+};
+
+
+/// \brief A snappy uncompressor.
+///
+/// Snappy uncompresses whole buffers, so a message in pieces is collected.
+class SnappyContext: public Decompressor::Context
+{
+public:
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer&) override
+    {
+        // Snappy is not a streaming format, so nothing is written until finish().
+        _input.writeBytes(buffer.getPtr(), buffer.size());
+        return 0;
+    }
+
+    std::size_t finish(ByteBuffer& outputBuffer) override
+    {
+        std::size_t written = _uncompress(_input, outputBuffer);
+        _input.clear();
+        return written;
+    }
+
+    void reset() override
+    {
+        _input.clear();
+    }
+
+    void uncompress(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        _uncompress(buffer, outputBuffer);
+    }
+
+private:
+    static std::size_t _uncompress(const ByteBufferView& buffer,
+                                   ByteBuffer& outputBuffer)
+    {
+        const std::size_t offset = outputBuffer.size();
+        std::size_t size = 0;
+
+        if (!snappy::GetUncompressedLength(buffer.getCharPtr(), buffer.size(), &size))
+        {
+            throw Poco::DataFormatException("Corrupt snappy data.");
+        }
+
+        outputBuffer.resize(offset + size);
+
+        if (!snappy::RawUncompress(buffer.getCharPtr(),
+                                   buffer.size(),
+                                   outputBuffer.getCharPtr() + offset))
+        {
+            outputBuffer.resize(offset);
+            throw Poco::DataFormatException("Corrupt snappy data.");
+        }
+
+        return size;
+    }
+
+    /// \brief The message collected so far.
+    ByteBuffer _input;
+
+};
+
+
+/// \brief A brotli uncompressor.
+///
+/// The brotli decoder cannot be reset, so each message creates one. Unlike
+/// the encoder, it sizes its ring buffer to small messages, so there is
+/// little to keep.
+class BrotliContext: public Decompressor::Context
+{
+public:
+    BrotliContext(const CompressionDictionary& dictionary):
+        _dictionary(dictionary)
+    {
+    }
+
+    ~BrotliContext() override
+    {
+        reset();
+    }
+
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        return _decompress(buffer.getPtr(), buffer.size(), outputBuffer, buffer.size() * 4);
+    }
+
+    std::size_t finish(ByteBuffer&) override
+    {
+        bool isFinished = _state != nullptr && BrotliDecoderIsFinished(_state);
+
+        reset();
+
+        if (!isFinished)
+        {
+            throw Poco::DataFormatException("brotli error: unexpected end of input");
+        }
+
+        return 0;
+    }
+
+    void reset() override
+    {
+        if (_state != nullptr)
+        {
+            BrotliDecoderDestroyInstance(_state);
+            _state = nullptr;
+        }
+    }
+
+    void uncompress(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        std::size_t capacity = 0;
+
+        if (!BrotliDecompressedSize(buffer.size(), buffer.getPtr(), &capacity))
+        {
+            capacity = buffer.size() * 4;
+        }
+
+        _decompress(buffer.getPtr(), buffer.size(), outputBuffer, capacity);
+        finish(outputBuffer);
+    }
+
+private:
+    std::size_t _decompress(const uint8_t* in,
+                            std::size_t size,
+                            ByteBuffer& outputBuffer,
+                            std::size_t capacity)
+    {
+        if (_state == nullptr)
+        {
+            _state = BrotliDecoderCreateInstance(nullptr, nullptr, nullptr);
+
+            if (_state == nullptr)
+            {
+                throw Poco::OutOfMemoryException("Unable to create a brotli decoder.");
+            }
+
+            if (!_dictionary.empty())
+            {
+                BrotliDecoderSetCustomDictionary(_state,
+                                                 _dictionary.size(),
+                                                 _dictionary.content().getPtr());
+            }
+        }
+
+        if (BrotliDecoderIsFinished(_state))
+        {
+            // Anything after the end of the stream is ignored.
+            return 0;
+        }
+
+        const std::size_t offset = outputBuffer.size();
+
+        outputBuffer.resize(offset + std::max(capacity, std::size_t(1024)));
+
+        std::size_t written = offset;
+
+        while (true)
+        {
+            if (written == outputBuffer.size())
+            {
+                outputBuffer.resize(offset + (outputBuffer.size() - offset) * 2);
+            }
+
+            std::size_t availableIn = size;
+            std::size_t availableOut = outputBuffer.size() - written;
+            uint8_t* out = outputBuffer.getPtr() + written;
+
+            BrotliDecoderResult result = BrotliDecoderDecompressStream(_state,
+                                                                       &availableIn,
+                                                                       &in,
+                                                                       &availableOut,
+                                                                       &out,
+                                                                       nullptr);
+
+            size = availableIn;
+            written = std::size_t(out - outputBuffer.getPtr());
+
+            if (result == BROTLI_DECODER_RESULT_ERROR)
+            {
+                std::string message = BrotliDecoderErrorString(BrotliDecoderGetErrorCode(_state));
+                outputBuffer.resize(offset);
+                reset();
+                throw Poco::DataFormatException("brotli error: " + message);
+            }
+            else if (result != BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT)
+            {
+                break;
+            }
+        }
+
+        outputBuffer.resize(written);
+        return written - offset;
+    }
+
+    const CompressionDictionary& _dictionary;
+
+    BrotliDecoderState* _state = nullptr;
+
+};
+
+
+/// \brief Copies the input.
+class NoneContext: public Decompressor::Context
+{
+public:
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        return outputBuffer.writeBytes(buffer.getPtr(), buffer.size());
+    }
+
+    std::size_t finish(ByteBuffer&) override
+    {
+        return 0;
+    }
+
+    void reset() override
+    {
+    }
+
+};
+
+
+} // namespace
+
+
+Decompressor::Decompressor(Compression::Type type):
+    Decompressor(type, MAX_WBITS)
+{
+}
+
+
+Decompressor::Decompressor(Compression::Type type, int windowBits):
+    Decompressor(type, windowBits, CompressionDictionary())
+{
+}
+
+
+Decompressor::Decompressor(Compression::Type type,
+                           const CompressionDictionary& dictionary):
+    Decompressor(type, MAX_WBITS, dictionary)
+{
+}
+
+
+Decompressor::Decompressor(Compression::Type type,
+                           int windowBits,
+                           const CompressionDictionary& dictionary):
+    _type(type),
+    _windowBits(windowBits),
+    _dictionary(dictionary)
+{
+    switch (type)
+    {
+        case Compression::ZLIB:
+            _context = std::make_unique<ZlibContext>(windowBits, _dictionary);
+            break;
+        case Compression::GZIP:
+            _context = std::make_unique<ZlibContext>(windowBits + 16, _dictionary);
+            break;
+        case Compression::LZ4:
+            _context = std::make_unique<LZ4Context>(_dictionary);
+            break;
+        case Compression::SNAPPY:
+            if (!_dictionary.empty())
+            {
+                throw Poco::InvalidArgumentException("snappy does not support dictionaries.");
+            }
+
+            _context = std::make_unique<SnappyContext>();
+            break;
+        case Compression::BR:
+            _context = std::make_unique<BrotliContext>(_dictionary);
+            break;
+        case Compression::NONE:
+            _context = std::make_unique<NoneContext>();
+            break;
+    }
+}
+
+
+Decompressor::~Decompressor()
+{
+}
+
+
+std::size_t Decompressor::update(const ByteBufferView& buffer,
+                                 ByteBuffer& outputBuffer)
+{
+    return _context->update(buffer, outputBuffer);
+}
+
+
+std::size_t Decompressor::finish(ByteBuffer& outputBuffer)
+{
+    return _context->finish(outputBuffer);
+}
+
+
+void Decompressor::reset()
+{
+    _context->reset();
+}
+
+
+std::size_t Decompressor::uncompress(const ByteBufferView& compressedBuffer,
+                                     ByteBuffer& uncompressedBuffer)
+{
+    uncompressedBuffer.clear();
+
+    try
+    {
+        _context->reset();
+        _context->uncompress(compressedBuffer, uncompressedBuffer);
+        return uncompressedBuffer.size();
+    }
+    catch (const Poco::Exception& exc)
+    {
+        ofLogError("Decompressor::uncompress") << exc.displayText();
+        uncompressedBuffer.clear();
+        return 0;
+    }
+}
+
+
+Compression::Type Decompressor::type() const
+{
+    return _type;
+}
+
+
+int Decompressor::windowBits() const
+{
+    return _windowBits;
+}
+
+
+const CompressionDictionary& Decompressor::dictionary() const
+{
+    return _dictionary;
+}
+
+
+} }  // namespace ofx::IO
@@ -49,6 +49,11 @@ FilteredOutputStream::FilteredOutputStream(std::ostream& stream): _stream(stream
 
 FilteredOutputStream::~FilteredOutputStream()
 {
+    // Outer filters write into inner ones as they close, so close them first.
+    while (!_filters.empty())
+    {
+        _filters.pop_back();
+    }
 }
 
 
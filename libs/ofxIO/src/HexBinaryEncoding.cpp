@@ -6,18 +6,571 @@
 
 
 #include "ofx/IO/HexBinaryEncoding.h"
-#include <stdint.h>
-#include "Poco/HexBinaryEncoder.h"
-#include "Poco/HexBinaryDecoder.h"
+#include <algorithm>
+#include <cstring>
 #include "ofx/IO/ByteBuffer.h"
-#include "ofx/IO/ByteBufferStream.h"
+#include "ofx/IO/ByteSet.h"
+
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define OFX_IO_HEX_AVX2 1
+#define OFX_IO_HEX_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && defined(__AVX2__)
+#include <immintrin.h>
+#define OFX_IO_HEX_AVX2 1
+#define OFX_IO_HEX_AVX2_TARGET
+#elif defined(__aarch64__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define OFX_IO_HEX_NEON 1
+#endif
 
 
 namespace ofx {
 namespace IO {
 
 
-HexBinaryEncoding::HexBinaryEncoding()
+namespace {
+
+
+const char LOWER_DIGITS[] = "0123456789abcdef";
+const char UPPER_DIGITS[] = "0123456789ABCDEF";
+
+/// \brief Decode table value for characters that end decoding.
+const uint8_t INVALID = 0xFF;
+
+/// \brief Decode table value for whitespace, which is skipped.
+const uint8_t SKIP = 0xFE;
+
+
+/// \brief Lookup tables for the scalar codec.
+struct Tables
+{
+    Tables()
+    {
+        for (std::size_t i = 0; i < 256; ++i)
+        {
+            lowerPairs[i][0] = LOWER_DIGITS[i >> 4];
+            lowerPairs[i][1] = LOWER_DIGITS[i & 0xF];
+            upperPairs[i][0] = UPPER_DIGITS[i >> 4];
+            upperPairs[i][1] = UPPER_DIGITS[i & 0xF];
+        }
+
+        std::memset(decode, INVALID, sizeof(decode));
+
+        for (uint8_t i = 0; i < 16; ++i)
+        {
+            decode[uint8_t(LOWER_DIGITS[i])] = i;
+            decode[uint8_t(UPPER_DIGITS[i])] = i;
+        }
+
+        for (uint8_t c: { ' ', '\t', '\n', '\v', '\f', '\r' })
+        {
+            decode[c] = SKIP;
+        }
+    }
+
+    /// \brief Two digits for each byte.
+    uint8_t lowerPairs[256][2];
+    uint8_t upperPairs[256][2];
+
+    /// \brief The 4 bit value of each character, INVALID or SKIP.
+    uint8_t decode[256];
+};
+
+
+const Tables& tables()
+{
+    static const Tables tables;
+    return tables;
+}
+
+
+#if defined(OFX_IO_HEX_AVX2)
+
+
+bool hasAVX2()
+{
+#if defined(__GNUC__)
+    static const bool supported = []() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return supported;
+#else
+    return true;
+#endif
+}
+
+
+/// \brief Encode bytes 32 at a time, returning the number encoded.
+OFX_IO_HEX_AVX2_TARGET
+std::size_t encodeAVX2(const uint8_t* in,
+                       std::size_t size,
+                       uint8_t* out,
+                       bool isUpperCase)
+{
+    const __m256i digits = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(isUpperCase ? UPPER_DIGITS : LOWER_DIGITS)));
+
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+
+    std::size_t i = 0;
+
+    for (; i + 32 <= size; i += 32, out += 64)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+        __m256i low = _mm256_and_si256(v, nibble);
+
+        // Interleave the nibbles within each lane, then put the lanes back
+        // in order.
+        __m256i a = _mm256_unpacklo_epi8(high, low);
+        __m256i b = _mm256_unpackhi_epi8(high, low);
+        __m256i first = _mm256_permute2x128_si256(a, b, 0x20);
+        __m256i second = _mm256_permute2x128_si256(a, b, 0x31);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_shuffle_epi8(digits, first));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 32), _mm256_shuffle_epi8(digits, second));
+    }
+
+    return i;
+}
+
+
+/// \brief Convert 32 hex digits to their 4 bit values.
+/// \returns false if any character is not a hex digit.
+OFX_IO_HEX_AVX2_TARGET
+inline bool valuesAVX2(__m256i c, __m256i& values)
+{
+    __m256i digit = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    __m256i letter = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+
+    __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+    __m256i isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+
+    values = _mm256_blendv_epi8(_mm256_add_epi8(letter, _mm256_set1_epi8(10)), digit, isDigit);
+
+    return _mm256_movemask_epi8(_mm256_or_si256(isDigit, isLetter)) == -1;
+}
+
+
+/// \brief Decode characters 64 at a time, returning the number consumed.
+///
+/// Decoding stops at the first block that is not entirely made of hex
+/// digits.
+OFX_IO_HEX_AVX2_TARGET
+std::size_t decodeAVX2(const uint8_t* in, std::size_t size, uint8_t* out)
+{
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+
+    std::size_t i = 0;
+
+    for (; i + 64 <= size; i += 64, out += 32)
+    {
+        __m256i v0;
+        __m256i v1;
+
+        if (!valuesAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)), v0)
+         || !valuesAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 32)), v1))
+        {
+            break;
+        }
+
+        // Merge each pair of nibbles into a 16-bit lane, then pack the lanes
+        // back to bytes in order.
+        __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(v0, weights),
+                                             _mm256_maddubs_epi16(v1, weights));
+        packed = _mm256_permute4x64_epi64(packed, 0xD8);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), packed);
+    }
+
+    return i;
+}
+
+
+#elif defined(OFX_IO_HEX_NEON)
+
+
+/// \brief Encode bytes 16 at a time, returning the number encoded.
+std::size_t encodeNEON(const uint8_t* in,
+                       std::size_t size,
+                       uint8_t* out,
+                       bool isUpperCase)
+{
+    const uint8x16_t digits = vld1q_u8(reinterpret_cast<const uint8_t*>(isUpperCase ? UPPER_DIGITS : LOWER_DIGITS));
+    const uint8x16_t nibble = vdupq_n_u8(0x0F);
+
+    std::size_t i = 0;
+
+    for (; i + 16 <= size; i += 16, out += 32)
+    {
+        uint8x16_t v = vld1q_u8(in + i);
+        uint8x16x2_t chars;
+        chars.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(v, 4));
+        chars.val[1] = vqtbl1q_u8(digits, vandq_u8(v, nibble));
+        vst2q_u8(out, chars);
+    }
+
+    return i;
+}
+
+
+/// \brief Convert 16 hex digits to their 4 bit values.
+///
+/// Lanes that are not hex digits are cleared in valid.
+inline uint8x16_t valuesNEON(uint8x16_t c, uint8x16_t& valid)
+{
+    uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+    uint8x16_t letter = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+
+    uint8x16_t isDigit = vcleq_u8(digit, vdupq_n_u8(9));
+    uint8x16_t isLetter = vcleq_u8(letter, vdupq_n_u8(5));
+
+    valid = vandq_u8(valid, vorrq_u8(isDigit, isLetter));
+    return vbslq_u8(isDigit, digit, vaddq_u8(letter, vdupq_n_u8(10)));
+}
+
+
+/// \brief Decode characters 32 at a time, returning the number consumed.
+///
+/// Decoding stops at the first block that is not entirely made of hex
+/// digits.
+std::size_t decodeNEON(const uint8_t* in, std::size_t size, uint8_t* out)
+{
+    std::size_t i = 0;
+
+    for (; i + 32 <= size; i += 32, out += 16)
+    {
+        uint8x16x2_t chars = vld2q_u8(in + i);
+        uint8x16_t valid = vdupq_n_u8(0xFF);
+        uint8x16_t high = valuesNEON(chars.val[0], valid);
+        uint8x16_t low = valuesNEON(chars.val[1], valid);
+
+        if (vminvq_u8(valid) != 0xFF)
+        {
+            break;
+        }
+
+        vst1q_u8(out, vorrq_u8(vshlq_n_u8(high, 4), low));
+    }
+
+    return i;
+}
+
+
+#endif
+
+
+/// \brief Encode bytes without separators or line breaks.
+/// \returns a pointer past the last encoded character.
+uint8_t* encodeRun(const uint8_t* in,
+                   std::size_t size,
+                   uint8_t* out,
+                   bool isUpperCase)
+{
+    std::size_t i = 0;
+
+#if defined(OFX_IO_HEX_AVX2)
+    if (hasAVX2())
+    {
+        i = encodeAVX2(in, size, out, isUpperCase);
+    }
+#elif defined(OFX_IO_HEX_NEON)
+    i = encodeNEON(in, size, out, isUpperCase);
+#endif
+
+    out += i * 2;
+
+    const uint8_t (*pairs)[2] = isUpperCase ? tables().upperPairs : tables().lowerPairs;
+
+    for (; i < size; ++i, out += 2)
+    {
+        std::memcpy(out, pairs[in[i]], 2);
+    }
+
+    return out;
+}
+
+
+/// \brief Decode pairs of hex digits, returning the number of characters
+/// consumed.
+///
+/// Decoding stops at the first pair that is not made of two hex digits,
+/// which is then left for the caller.
+std::size_t decodeRun(const uint8_t* in, std::size_t size, uint8_t* out)
+{
+    std::size_t i = 0;
+
+#if defined(OFX_IO_HEX_AVX2)
+    if (hasAVX2())
+    {
+        i = decodeAVX2(in, size, out);
+    }
+#elif defined(OFX_IO_HEX_NEON)
+    i = decodeNEON(in, size, out);
+#endif
+
+    out += i / 2;
+
+    const uint8_t* decode = tables().decode;
+
+    for (; i + 2 <= size; i += 2)
+    {
+        uint8_t high = decode[in[i]];
+        uint8_t low = decode[in[i + 1]];
+
+        // INVALID and SKIP both have high bits set.
+        if ((high | low) & 0xF0)
+        {
+            break;
+        }
+
+        *out++ = uint8_t((high << 4) | low);
+    }
+
+    return i;
+}
+
+
+/// \brief The formatting options of the encoder.
+struct EncodeOptions
+{
+    bool isUpperCase;
+    const std::string& separator;
+    std::size_t bytesPerLine;
+};
+
+
+/// \brief Encode bytes, continuing a line of lineBytes bytes.
+/// \returns a pointer past the last encoded character.
+uint8_t* encodeLines(const uint8_t* in,
+                     std::size_t size,
+                     uint8_t* out,
+                     const EncodeOptions& options,
+                     std::size_t& lineBytes)
+{
+    const std::string& separator = options.separator;
+    const uint8_t (*pairs)[2] = options.isUpperCase ? tables().upperPairs : tables().lowerPairs;
+
+    while (size > 0)
+    {
+        // A line break precedes the first byte of each new line.
+        if (options.bytesPerLine > 0 && lineBytes == options.bytesPerLine)
+        {
+            *out++ = '\n';
+            lineBytes = 0;
+        }
+
+        std::size_t n = size;
+
+        if (options.bytesPerLine > 0)
+        {
+            n = std::min(n, options.bytesPerLine - lineBytes);
+        }
+
+        if (separator.empty())
+        {
+            out = encodeRun(in, n, out, options.isUpperCase);
+        }
+        else
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (lineBytes + i > 0)
+                {
+                    std::memcpy(out, separator.data(), separator.size());
+                    out += separator.size();
+                }
+
+                std::memcpy(out, pairs[in[i]], 2);
+                out += 2;
+            }
+        }
+
+        lineBytes += n;
+        in += n;
+        size -= n;
+    }
+
+    return out;
+}
+
+
+/// \brief The state of a decoder between chunks.
+struct DecodeState
+{
+    /// \brief The first digit of a pair.
+    uint8_t high = 0;
+
+    /// \brief True if high holds a digit.
+    bool hasHigh = false;
+
+    /// \brief True once an invalid character has been read.
+    bool isDone = false;
+};
+
+
+/// \brief Decode a chunk of characters, continuing from state.
+///
+/// Whitespace and separator characters are skipped. Decoding ends at the
+/// first other character that is not a hex digit.
+///
+/// \returns a pointer past the last decoded byte.
+uint8_t* decodeChunk(const uint8_t* in,
+                     std::size_t size,
+                     uint8_t* out,
+                     DecodeState& state,
+                     const ByteSet& separators)
+{
+    const uint8_t* decode = tables().decode;
+    const uint8_t* end = in + size;
+
+    while (in < end && !state.isDone)
+    {
+        if (!state.hasHigh)
+        {
+            std::size_t consumed = decodeRun(in, static_cast<std::size_t>(end - in), out);
+            in += consumed;
+            out += consumed / 2;
+
+            if (in == end)
+            {
+                break;
+            }
+        }
+
+        uint8_t c = *in++;
+        uint8_t value = decode[c];
+
+        if (value < 16)
+        {
+            if (state.hasHigh)
+            {
+                *out++ = uint8_t((state.high << 4) | value);
+                state.hasHigh = false;
+            }
+            else
+            {
+                state.high = value;
+                state.hasHigh = true;
+            }
+        }
+        else if (value != SKIP && !separators.contains(c))
+        {
+            state.isDone = true;
+        }
+    }
+
+    return out;
+}
+
+
+/// \brief An incremental hex encoder with the same output as encode().
+class HexBinaryStreamEncoder: public AbstractByteTransform
+{
+public:
+    HexBinaryStreamEncoder(bool isUpperCase,
+                           const std::string& separator,
+                           std::size_t bytesPerLine):
+        _isUpperCase(isUpperCase),
+        _separator(separator),
+        _bytesPerLine(bytesPerLine)
+    {
+    }
+
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        // Each byte is preceded by at most one separator or line break.
+        const std::size_t offset = outputBuffer.size();
+        outputBuffer.resize(offset + buffer.size() * (2 + std::max<std::size_t>(_separator.size(), 1)));
+
+        uint8_t* begin = outputBuffer.getPtr() + offset;
+        uint8_t* out = encodeLines(buffer.getPtr(),
+                                   buffer.size(),
+                                   begin,
+                                   { _isUpperCase, _separator, _bytesPerLine },
+                                   _lineBytes);
+
+        std::size_t written = static_cast<std::size_t>(out - begin);
+        outputBuffer.resize(offset + written);
+        return written;
+    }
+
+    std::size_t finish(ByteBuffer&) override
+    {
+        reset();
+        return 0;
+    }
+
+    void reset() override
+    {
+        _lineBytes = 0;
+    }
+
+private:
+    bool _isUpperCase = false;
+    std::string _separator;
+    std::size_t _bytesPerLine = 0;
+
+    /// \brief The number of bytes on the current line.
+    std::size_t _lineBytes = 0;
+
+};
+
+
+/// \brief An incremental hex decoder.
+///
+/// Whitespace and separator characters are skipped. Decoding stops at the
+/// first invalid character and a trailing half byte is dropped.
+class HexBinaryStreamDecoder: public AbstractByteTransform
+{
+public:
+    HexBinaryStreamDecoder(const std::string& separator): _separators(separator)
+    {
+    }
+
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        const std::size_t offset = outputBuffer.size();
+        outputBuffer.resize(offset + buffer.size() / 2 + 1);
+
+        uint8_t* begin = outputBuffer.getPtr() + offset;
+        uint8_t* out = decodeChunk(buffer.getPtr(), buffer.size(), begin, _state, _separators);
+
+        std::size_t written = static_cast<std::size_t>(out - begin);
+        outputBuffer.resize(offset + written);
+        return written;
+    }
+
+    std::size_t finish(ByteBuffer&) override
+    {
+        reset();
+        return 0;
+    }
+
+    void reset() override
+    {
+        _state = DecodeState();
+    }
+
+private:
+    ByteSet _separators;
+    DecodeState _state;
+
+};
+
+
+} // namespace
+
+
+HexBinaryEncoding::HexBinaryEncoding(bool isUpperCase,
+                                     const std::string& separator,
+                                     std::size_t bytesPerLine):
+    _isUpperCase(isUpperCase),
+    _separator(separator),
+    _bytesPerLine(bytesPerLine)
 {
 }
 
@@ -29,22 +582,135 @@ HexBinaryEncoding::~HexBinaryEncoding()
 
 std::size_t HexBinaryEncoding::encode(const ByteBuffer& buffer,
                                       ByteBuffer& encodedBuffer)
+{
+    return encode(ByteBufferView(buffer), encodedBuffer);
+}
+
+
+std::size_t HexBinaryEncoding::decode(const ByteBuffer& buffer,
+                                      ByteBuffer& decodedBuffer)
+{
+    return decode(ByteBufferView(buffer), decodedBuffer);
+}
+
+
+std::size_t HexBinaryEncoding::encode(const ByteBufferView& buffer,
+                                      ByteBuffer& encodedBuffer)
 {
     encodedBuffer.clear();
-    ByteBufferOutputStream os(encodedBuffer);
-    Poco::HexBinaryEncoder _encoder(os);
-    ByteBufferUtils::copyBufferToStream(buffer, _encoder);
-    _encoder.close(); // Flush bytes.
+    encodedBuffer.resize(encodedSize(buffer.size(), _separator.size(), _bytesPerLine));
+
+    if (buffer.size() > 0)
+    {
+        encode(buffer.getPtr(),
+               buffer.size(),
+               encodedBuffer.getPtr(),
+               _isUpperCase,
+               _separator,
+               _bytesPerLine);
+    }
+
     return encodedBuffer.size();
 }
 
-std::size_t HexBinaryEncoding::decode(const ByteBuffer& buffer,
+
+std::size_t HexBinaryEncoding::decode(const ByteBufferView& buffer,
                                       ByteBuffer& decodedBuffer)
 {
     decodedBuffer.clear();
-    ByteBufferInputStream is(buffer);
-    Poco::HexBinaryDecoder _decoder(is);
-    return ByteBufferUtils::copyStreamToBuffer(_decoder, decodedBuffer);
+
+    if (buffer.size() > 0)
+    {
+        decodedBuffer.resize(maximumDecodedSize(buffer.size()));
+        std::size_t size = decode(buffer.getPtr(),
+                                  buffer.size(),
+                                  decodedBuffer.getPtr(),
+                                  _separator);
+        decodedBuffer.resize(size);
+    }
+
+    return decodedBuffer.size();
+}
+
+
+std::unique_ptr<AbstractByteTransform> HexBinaryEncoding::createStreamEncoder()
+{
+    return std::make_unique<HexBinaryStreamEncoder>(_isUpperCase, _separator, _bytesPerLine);
+}
+
+
+std::unique_ptr<AbstractByteTransform> HexBinaryEncoding::createStreamDecoder()
+{
+    return std::make_unique<HexBinaryStreamDecoder>(_separator);
+}
+
+
+std::size_t HexBinaryEncoding::encode(const uint8_t* buffer,
+                                      std::size_t size,
+                                      uint8_t* encodedBuffer,
+                                      bool isUpperCase,
+                                      const std::string& separator,
+                                      std::size_t bytesPerLine)
+{
+    std::size_t lineBytes = 0;
+    uint8_t* out = encodeLines(buffer,
+                               size,
+                               encodedBuffer,
+                               { isUpperCase, separator, bytesPerLine },
+                               lineBytes);
+    return static_cast<std::size_t>(out - encodedBuffer);
+}
+
+
+std::size_t HexBinaryEncoding::decode(const uint8_t* buffer,
+                                      std::size_t size,
+                                      uint8_t* decodedBuffer,
+                                      const std::string& separator)
+{
+    DecodeState state;
+    uint8_t* out = decodeChunk(buffer, size, decodedBuffer, state, ByteSet(separator));
+    return static_cast<std::size_t>(out - decodedBuffer);
+}
+
+
+std::size_t HexBinaryEncoding::encodedSize(std::size_t size,
+                                           std::size_t separatorSize,
+                                           std::size_t bytesPerLine)
+{
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    const std::size_t lines = bytesPerLine > 0 ? (size + bytesPerLine - 1) / bytesPerLine : 1;
+
+    // Separators fall between the bytes of a line and line breaks between
+    // lines.
+    return size * 2 + (size - lines) * separatorSize + (lines - 1);
+}
+
+
+std::size_t HexBinaryEncoding::maximumDecodedSize(std::size_t size)
+{
+    return size / 2;
+}
+
+
+bool HexBinaryEncoding::isUpperCase() const
+{
+    return _isUpperCase;
+}
+
+
+std::string HexBinaryEncoding::separator() const
+{
+    return _separator;
+}
+
+
+std::size_t HexBinaryEncoding::bytesPerLine() const
+{
+    return _bytesPerLine;
 }
 
 
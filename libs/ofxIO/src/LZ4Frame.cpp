@@ -0,0 +1,1266 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/IO/LZ4Frame.h"
+#include <algorithm>
+#include <cstring>
+#include "Poco/Exception.h"
+#include "lz4.h"
+#include "lz4hc.h"
+#include "ofLog.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+namespace {
+
+
+const uint32_t PRIME32_1 = 2654435761U;
+const uint32_t PRIME32_2 = 2246822519U;
+const uint32_t PRIME32_3 = 3266489917U;
+const uint32_t PRIME32_4 = 668265263U;
+const uint32_t PRIME32_5 = 374761393U;
+
+
+/// \brief The first of the 16 skippable frame magic numbers.
+const uint32_t SKIPPABLE_MAGIC_NUMBER = 0x184D2A50;
+
+
+/// \brief The bit of a block size that marks an uncompressed block.
+const uint32_t UNCOMPRESSED_BLOCK = 0x80000000;
+
+
+/// \brief The furthest back an LZ4 match can refer.
+const std::size_t WINDOW_SIZE = 64 * 1024;
+
+
+/// \brief The largest ratio of content to compressed bytes.
+const std::size_t MAXIMUM_RATIO = 256;
+
+
+/// \brief The frame descriptor flags.
+enum
+{
+    FLAG_VERSION = 0x40,
+    FLAG_VERSION_MASK = 0xC0,
+    FLAG_BLOCK_INDEPENDENCE = 0x20,
+    FLAG_BLOCK_CHECKSUM = 0x10,
+    FLAG_CONTENT_SIZE = 0x08,
+    FLAG_CONTENT_CHECKSUM = 0x04,
+    FLAG_RESERVED = 0x02,
+    FLAG_DICTIONARY_ID = 0x01
+};
+
+
+inline uint32_t read32(const uint8_t* p)
+{
+    return uint32_t(p[0])
+         | uint32_t(p[1]) << 8
+         | uint32_t(p[2]) << 16
+         | uint32_t(p[3]) << 24;
+}
+
+
+inline uint64_t read64(const uint8_t* p)
+{
+    return uint64_t(read32(p)) | uint64_t(read32(p + 4)) << 32;
+}
+
+
+inline void write32(uint8_t* p, uint32_t value)
+{
+    p[0] = uint8_t(value);
+    p[1] = uint8_t(value >> 8);
+    p[2] = uint8_t(value >> 16);
+    p[3] = uint8_t(value >> 24);
+}
+
+
+inline void write64(uint8_t* p, uint64_t value)
+{
+    write32(p, uint32_t(value));
+    write32(p + 4, uint32_t(value >> 32));
+}
+
+
+inline uint32_t rotl32(uint32_t value, int bits)
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+
+inline uint32_t xxh32Round(uint32_t accumulator, uint32_t input)
+{
+    accumulator += input * PRIME32_2;
+    accumulator = rotl32(accumulator, 13);
+    return accumulator * PRIME32_1;
+}
+
+
+/// \returns the number of bytes in a block of a block size.
+std::size_t blockBytes(int blockSize)
+{
+    return std::size_t(1) << (8 + 2 * blockSize);
+}
+
+
+/// \brief An XXH32 hash calculated in pieces.
+class XXH32State
+{
+public:
+    XXH32State(uint32_t seed = 0)
+    {
+        reset(seed);
+    }
+
+    void reset(uint32_t seed = 0)
+    {
+        _seed = seed;
+        _v[0] = seed + PRIME32_1 + PRIME32_2;
+        _v[1] = seed + PRIME32_2;
+        _v[2] = seed;
+        _v[3] = seed - PRIME32_1;
+        _memorySize = 0;
+        _totalSize = 0;
+    }
+
+    void update(const uint8_t* buffer, std::size_t size)
+    {
+        const uint8_t* p = buffer;
+        const uint8_t* end = buffer + size;
+
+        _totalSize += size;
+
+        if (_memorySize + size < 16)
+        {
+            if (size > 0)
+            {
+                std::memcpy(_memory + _memorySize, p, size);
+                _memorySize += size;
+            }
+
+            return;
+        }
+
+        if (_memorySize > 0)
+        {
+            std::size_t count = 16 - _memorySize;
+            std::memcpy(_memory + _memorySize, p, count);
+            _round(_memory);
+            p += count;
+            _memorySize = 0;
+        }
+
+        for (; p + 16 <= end; p += 16)
+        {
+            _round(p);
+        }
+
+        _memorySize = std::size_t(end - p);
+
+        if (_memorySize > 0)
+        {
+            std::memcpy(_memory, p, _memorySize);
+        }
+    }
+
+    uint32_t digest() const
+    {
+        uint32_t hash = 0;
+
+        if (_totalSize >= 16)
+        {
+            hash = rotl32(_v[0], 1) + rotl32(_v[1], 7) + rotl32(_v[2], 12) + rotl32(_v[3], 18);
+        }
+        else
+        {
+            hash = _seed + PRIME32_5;
+        }
+
+        hash += uint32_t(_totalSize);
+
+        const uint8_t* p = _memory;
+        const uint8_t* end = _memory + _memorySize;
+
+        for (; p + 4 <= end; p += 4)
+        {
+            hash += read32(p) * PRIME32_3;
+            hash = rotl32(hash, 17) * PRIME32_4;
+        }
+
+        for (; p < end; ++p)
+        {
+            hash += *p * PRIME32_5;
+            hash = rotl32(hash, 11) * PRIME32_1;
+        }
+
+        hash ^= hash >> 15;
+        hash *= PRIME32_2;
+        hash ^= hash >> 13;
+        hash *= PRIME32_3;
+        hash ^= hash >> 16;
+
+        return hash;
+    }
+
+private:
+    void _round(const uint8_t* p)
+    {
+        _v[0] = xxh32Round(_v[0], read32(p));
+        _v[1] = xxh32Round(_v[1], read32(p + 4));
+        _v[2] = xxh32Round(_v[2], read32(p + 8));
+        _v[3] = xxh32Round(_v[3], read32(p + 12));
+    }
+
+    uint32_t _seed = 0;
+    uint32_t _v[4];
+
+    /// \brief Input that does not yet fill a 16 byte stripe.
+    uint8_t _memory[16];
+    std::size_t _memorySize = 0;
+
+    uint64_t _totalSize = 0;
+
+};
+
+
+/// \brief A frame descriptor.
+struct Descriptor
+{
+    uint8_t flags = 0;
+    std::size_t blockMaximum = 0;
+    uint64_t contentSize = 0;
+    uint32_t dictionaryId = 0;
+
+    /// \brief The size of the magic number and descriptor.
+    std::size_t headerSize = 0;
+
+    bool has(int flag) const
+    {
+        return (flags & flag) != 0;
+    }
+};
+
+
+/// \brief Parse the descriptor of the frame at the start of a buffer.
+/// \returns an error message, or nullptr if the descriptor is valid.
+const char* parseDescriptor(const uint8_t* buffer,
+                            std::size_t size,
+                            Descriptor& descriptor)
+{
+    if (size < 7 || read32(buffer) != LZ4Frame::MAGIC_NUMBER)
+    {
+        return "Not an LZ4 frame.";
+    }
+
+    descriptor.flags = buffer[4];
+
+    if ((descriptor.flags & FLAG_VERSION_MASK) != FLAG_VERSION
+    || (descriptor.flags & FLAG_RESERVED) != 0
+    || (buffer[5] & 0x8F) != 0
+    || ((buffer[5] >> 4) & 0x7) < LZ4Frame::BLOCK_SIZE_64KB)
+    {
+        return "Unsupported LZ4 frame descriptor.";
+    }
+
+    descriptor.blockMaximum = blockBytes((buffer[5] >> 4) & 0x7);
+
+    std::size_t descriptorSize = 2;
+    descriptorSize += descriptor.has(FLAG_CONTENT_SIZE) ? 8 : 0;
+    descriptorSize += descriptor.has(FLAG_DICTIONARY_ID) ? 4 : 0;
+
+    if (size < 4 + descriptorSize + 1)
+    {
+        return "Truncated LZ4 frame descriptor.";
+    }
+
+    if (uint8_t(LZ4Frame::xxh32(buffer + 4, descriptorSize) >> 8) != buffer[4 + descriptorSize])
+    {
+        return "LZ4 frame descriptor checksum mismatch.";
+    }
+
+    if (descriptor.has(FLAG_CONTENT_SIZE))
+    {
+        descriptor.contentSize = read64(buffer + 6);
+    }
+
+    if (descriptor.has(FLAG_DICTIONARY_ID))
+    {
+        descriptor.dictionaryId = read32(buffer + 6 + (descriptor.has(FLAG_CONTENT_SIZE) ? 8 : 0));
+    }
+
+    descriptor.headerSize = 4 + descriptorSize + 1;
+    return nullptr;
+}
+
+
+/// \brief An incremental LZ4 frame compressor.
+///
+/// Whole blocks are compressed straight from the input. Only the remainder
+/// of each update() is copied, to be completed by the next one. The header
+/// waits for the first block, so content that fits in one block records
+/// its size.
+class StreamEncoder: public AbstractByteTransform
+{
+public:
+    /// \param settings The frame options.
+    /// \param hasContentSize True if the content size is known.
+    /// \param contentSize The content size, recorded if the settings ask.
+    /// \param dictionary The dictionary, or an empty one for none.
+    StreamEncoder(const LZ4Frame::Settings& settings,
+                  bool hasContentSize,
+                  uint64_t contentSize,
+                  const CompressionDictionary& dictionary):
+        _settings(settings),
+        _blockMaximum(blockBytes(settings.blockSize)),
+        _hasContentSize(hasContentSize),
+        _contentSize(contentSize),
+        _hasDictionary(!dictionary.empty()),
+        _dictionaryId(dictionary.id())
+    {
+        if (settings.level >= LZ4HC_CLEVEL_MIN)
+        {
+            // LZ4HC streams are large, so they are only made when used.
+            _streamHC = std::make_unique<LZ4_streamHC_t>();
+        }
+
+        if (_hasDictionary)
+        {
+            // Loaded once, and copied for each frame or independent block.
+            const std::size_t size = std::min(dictionary.size(), WINDOW_SIZE);
+            _dictionaryContent.writeBytes(dictionary.content().getPtr() + dictionary.size() - size, size);
+
+            if (_streamHC)
+            {
+                _dictionaryStreamHC = std::make_unique<LZ4_streamHC_t>();
+                LZ4_resetStreamHC(_dictionaryStreamHC.get(), _settings.level);
+                LZ4_loadDictHC(_dictionaryStreamHC.get(), _dictionaryContent.getCharPtr(), int(size));
+            }
+            else
+            {
+                LZ4_resetStream(&_dictionaryStream);
+                LZ4_loadDict(&_dictionaryStream, _dictionaryContent.getCharPtr(), int(size));
+            }
+        }
+    }
+
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        const std::size_t offset = outputBuffer.size();
+        const uint8_t* in = buffer.getPtr();
+        std::size_t size = buffer.size();
+
+        if (_settings.hasContentChecksum)
+        {
+            _checksum.update(in, size);
+        }
+
+        _consumed += size;
+
+        if (_pending.size() > 0)
+        {
+            std::size_t count = std::min(size, _blockMaximum - _pending.size());
+            _pending.writeBytes(in, count);
+            in += count;
+            size -= count;
+
+            if (_pending.size() == _blockMaximum)
+            {
+                _compressBlock(_pending.getPtr(), _pending.size(), outputBuffer);
+                _pending.clear();
+            }
+        }
+
+        // The end of an input of known size need not wait for finish().
+        while (size >= _blockMaximum
+           || (size > 0 && _hasContentSize && _consumed == _contentSize))
+        {
+            std::size_t count = std::min(size, _blockMaximum);
+            _compressBlock(in, count, outputBuffer);
+            in += count;
+            size -= count;
+        }
+
+        if (size > 0)
+        {
+            _pending.writeBytes(in, size);
+        }
+
+        return outputBuffer.size() - offset;
+    }
+
+    std::size_t finish(ByteBuffer& outputBuffer) override
+    {
+        const std::size_t offset = outputBuffer.size();
+
+        if (!_isStarted)
+        {
+            _begin(outputBuffer, true);
+        }
+
+        if (_pending.size() > 0)
+        {
+            _compressBlock(_pending.getPtr(), _pending.size(), outputBuffer);
+            _pending.clear();
+        }
+
+        if (_hasContentSize && _consumed != _contentSize)
+        {
+            reset();
+            throw Poco::InvalidArgumentException("LZ4 frame content does not match its content size.");
+        }
+
+        uint8_t trailer[8];
+        write32(trailer, 0);
+        write32(trailer + 4, _checksum.digest());
+        outputBuffer.writeBytes(trailer, _settings.hasContentChecksum ? 8 : 4);
+
+        reset();
+        return outputBuffer.size() - offset;
+    }
+
+    void reset() override
+    {
+        _isStarted = false;
+        _consumed = 0;
+        _pending.clear();
+        _checksum.reset();
+    }
+
+private:
+    /// \brief Write the magic number and descriptor.
+    /// \param isComplete True if all of the content has been given.
+    void _begin(ByteBuffer& outputBuffer, bool isComplete)
+    {
+        const bool hasContentSize = _settings.hasContentSize && (_hasContentSize || isComplete);
+
+        uint8_t header[19];
+        uint8_t* p = header;
+
+        write32(p, LZ4Frame::MAGIC_NUMBER);
+        p += 4;
+
+        uint8_t* descriptor = p;
+
+        *p++ = uint8_t(FLAG_VERSION
+                     | (_settings.isBlockIndependent ? FLAG_BLOCK_INDEPENDENCE : 0)
+                     | (_settings.hasBlockChecksum ? FLAG_BLOCK_CHECKSUM : 0)
+                     | (hasContentSize ? FLAG_CONTENT_SIZE : 0)
+                     | (_settings.hasContentChecksum ? FLAG_CONTENT_CHECKSUM : 0)
+                     | (_hasDictionary ? FLAG_DICTIONARY_ID : 0));
+        *p++ = uint8_t(_settings.blockSize << 4);
+
+        if (hasContentSize)
+        {
+            write64(p, _hasContentSize ? _contentSize : _consumed);
+            p += 8;
+        }
+
+        if (_hasDictionary)
+        {
+            write32(p, _dictionaryId);
+            p += 4;
+        }
+
+        *p = uint8_t(LZ4Frame::xxh32(descriptor, std::size_t(p - descriptor)) >> 8);
+        ++p;
+
+        outputBuffer.writeBytes(header, std::size_t(p - header));
+
+        if (_streamHC && _hasDictionary)
+        {
+            *_streamHC = *_dictionaryStreamHC;
+        }
+        else if (_streamHC)
+        {
+            LZ4_resetStreamHC(_streamHC.get(), _settings.level);
+        }
+        else if (_hasDictionary)
+        {
+            _stream = _dictionaryStream;
+        }
+        else
+        {
+            LZ4_resetStream(&_stream);
+        }
+
+        _isStarted = true;
+    }
+
+    /// \brief Compress one block, or store it if it does not compress.
+    void _compressBlock(const uint8_t* buffer,
+                        std::size_t size,
+                        ByteBuffer& outputBuffer)
+    {
+        if (!_isStarted)
+        {
+            _begin(outputBuffer, false);
+        }
+
+        const std::size_t offset = outputBuffer.size();
+        const int bound = LZ4_compressBound(int(size));
+
+        outputBuffer.resize(offset + 4 + std::size_t(bound) + 4);
+
+        uint8_t* p = outputBuffer.getPtr() + offset;
+        const char* source = reinterpret_cast<const char*>(buffer);
+        char* destination = reinterpret_cast<char*>(p + 4);
+
+        int compressedSize = 0;
+
+        if (_streamHC)
+        {
+            compressedSize = _compressHC(source, destination, int(size), bound);
+        }
+        else if (!_settings.isBlockIndependent)
+        {
+            compressedSize = LZ4_compress_fast_continue(&_stream, source, destination, int(size), bound, _settings.acceleration);
+        }
+        else if (_hasDictionary)
+        {
+            // Each independent block refers back to the dictionary only.
+            _stream = _dictionaryStream;
+            compressedSize = LZ4_compress_fast_continue(&_stream, source, destination, int(size), bound, _settings.acceleration);
+        }
+        else
+        {
+            compressedSize = LZ4_compress_fast_extState(&_stream, source, destination, int(size), bound, _settings.acceleration);
+        }
+
+        if (!_settings.isBlockIndependent)
+        {
+            // The next block may not follow this one in memory, so keep the
+            // window it refers back to.
+            _dictionary.resize(WINDOW_SIZE);
+
+            if (_streamHC)
+            {
+                LZ4_saveDictHC(_streamHC.get(), _dictionary.getCharPtr(), int(WINDOW_SIZE));
+            }
+            else
+            {
+                LZ4_saveDict(&_stream, _dictionary.getCharPtr(), int(WINDOW_SIZE));
+            }
+        }
+
+        if (compressedSize <= 0 || std::size_t(compressedSize) >= size)
+        {
+            std::memcpy(destination, source, size);
+            write32(p, uint32_t(size) | UNCOMPRESSED_BLOCK);
+            compressedSize = int(size);
+        }
+        else
+        {
+            write32(p, uint32_t(compressedSize));
+        }
+
+        p += 4 + compressedSize;
+
+        if (_settings.hasBlockChecksum)
+        {
+            write32(p, LZ4Frame::xxh32(p - compressedSize, std::size_t(compressedSize)));
+            p += 4;
+        }
+
+        outputBuffer.resize(std::size_t(p - outputBuffer.getPtr()));
+    }
+
+    /// \brief Compress one block with LZ4HC.
+    /// \returns the compressed size, or 0 if it does not fit.
+    int _compressHC(const char* source,
+                    char* destination,
+                    int size,
+                    int capacity)
+    {
+        if (!_settings.isBlockIndependent)
+        {
+            return LZ4_compress_HC_continue(_streamHC.get(), source, destination, size, capacity);
+        }
+
+        if (_hasDictionary)
+        {
+            // Each independent block refers back to the dictionary only.
+            *_streamHC = *_dictionaryStreamHC;
+            return LZ4_compress_HC_continue(_streamHC.get(), source, destination, size, capacity);
+        }
+
+        return LZ4_compress_HC_extStateHC(_streamHC.get(), source, destination, size, capacity, _settings.level);
+    }
+
+    LZ4Frame::Settings _settings;
+    std::size_t _blockMaximum = 0;
+
+    bool _hasContentSize = false;
+    uint64_t _contentSize = 0;
+
+    /// \brief True once the header is written.
+    bool _isStarted = false;
+
+    /// \brief The number of input bytes so far.
+    uint64_t _consumed = 0;
+
+    /// \brief Input that does not yet fill a block.
+    ByteBuffer _pending;
+
+    /// \brief The window of the previous dependent block.
+    ByteBuffer _dictionary;
+
+    bool _hasDictionary = false;
+    uint32_t _dictionaryId = 0;
+
+    /// \brief The end of the dictionary that fits in the window.
+    ByteBuffer _dictionaryContent;
+
+    /// \brief A stream with the dictionary loaded.
+    LZ4_stream_t _dictionaryStream;
+
+    XXH32State _checksum;
+
+    LZ4_stream_t _stream;
+
+    /// \brief The LZ4HC stream, or nullptr below the LZ4HC levels.
+    std::unique_ptr<LZ4_streamHC_t> _streamHC;
+
+    /// \brief An LZ4HC stream with the dictionary loaded.
+    std::unique_ptr<LZ4_streamHC_t> _dictionaryStreamHC;
+
+};
+
+
+/// \brief An incremental LZ4 frame uncompressor.
+///
+/// Headers and blocks that are split between calls to update() are
+/// collected first. Everything else is read straight from the input.
+class StreamDecoder: public AbstractByteTransform
+{
+public:
+    /// \param dictionary The dictionary, or an empty one for none.
+    StreamDecoder(const CompressionDictionary& dictionary):
+        _hasDictionary(!dictionary.empty()),
+        _dictionaryId(dictionary.id())
+    {
+        const std::size_t size = std::min(dictionary.size(), WINDOW_SIZE);
+        _dictionaryContent.writeBytes(dictionary.content().getPtr() + dictionary.size() - size, size);
+    }
+
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        const std::size_t offset = outputBuffer.size();
+        const uint8_t* in = buffer.getPtr();
+        const uint8_t* end = in + buffer.size();
+
+        while (in < end)
+        {
+            switch (_state)
+            {
+                case STATE_MAGIC:
+                {
+                    const uint8_t* unit = _take(in, end, 4);
+
+                    if (unit != nullptr)
+                    {
+                        uint32_t magic = read32(unit);
+                        _unit.clear();
+
+                        if ((magic & 0xFFFFFFF0) == SKIPPABLE_MAGIC_NUMBER)
+                        {
+                            _state = STATE_SKIP_SIZE;
+                        }
+                        else if (magic == LZ4Frame::MAGIC_NUMBER)
+                        {
+                            write32(_header, magic);
+                            _state = STATE_FLAGS;
+                        }
+                        else
+                        {
+                            throw Poco::DataFormatException("Not an LZ4 frame.");
+                        }
+                    }
+
+                    break;
+                }
+                case STATE_FLAGS:
+                {
+                    _header[4] = *in++;
+                    _state = STATE_DESCRIPTOR;
+                    break;
+                }
+                case STATE_DESCRIPTOR:
+                {
+                    // The block size byte, optional fields and checksum.
+                    const std::size_t size = 2
+                                           + ((_header[4] & FLAG_CONTENT_SIZE) ? 8 : 0)
+                                           + ((_header[4] & FLAG_DICTIONARY_ID) ? 4 : 0);
+
+                    const uint8_t* unit = _take(in, end, size);
+
+                    if (unit != nullptr)
+                    {
+                        std::memcpy(_header + 5, unit, size);
+                        _unit.clear();
+                        _beginFrame(5 + size, std::size_t(end - in), outputBuffer);
+                    }
+
+                    break;
+                }
+                case STATE_BLOCK_SIZE:
+                {
+                    const uint8_t* unit = _take(in, end, 4);
+
+                    if (unit != nullptr)
+                    {
+                        _blockHeader = read32(unit);
+                        _unit.clear();
+
+                        if (_blockHeader == 0)
+                        {
+                            _endFrame();
+                        }
+                        else if ((_blockHeader & ~UNCOMPRESSED_BLOCK) > _descriptor.blockMaximum)
+                        {
+                            throw Poco::DataFormatException("LZ4 block is larger than the block maximum.");
+                        }
+                        else
+                        {
+                            _state = STATE_BLOCK;
+                        }
+                    }
+
+                    break;
+                }
+                case STATE_BLOCK:
+                {
+                    const std::size_t blockSize = _blockHeader & ~UNCOMPRESSED_BLOCK;
+                    const std::size_t checksumSize = _descriptor.has(FLAG_BLOCK_CHECKSUM) ? 4 : 0;
+
+                    const uint8_t* unit = _take(in, end, blockSize + checksumSize);
+
+                    if (unit != nullptr)
+                    {
+                        if (checksumSize > 0 && LZ4Frame::xxh32(unit, blockSize) != read32(unit + blockSize))
+                        {
+                            throw Poco::DataFormatException("LZ4 block checksum mismatch.");
+                        }
+
+                        _decodeBlock(unit, blockSize, outputBuffer);
+                        _unit.clear();
+                        _state = STATE_BLOCK_SIZE;
+                    }
+
+                    break;
+                }
+                case STATE_CONTENT_CHECKSUM:
+                {
+                    const uint8_t* unit = _take(in, end, 4);
+
+                    if (unit != nullptr)
+                    {
+                        if (_checksum.digest() != read32(unit))
+                        {
+                            throw Poco::DataFormatException("LZ4 content checksum mismatch.");
+                        }
+
+                        _unit.clear();
+                        _state = STATE_MAGIC;
+                    }
+
+                    break;
+                }
+                case STATE_SKIP_SIZE:
+                {
+                    const uint8_t* unit = _take(in, end, 4);
+
+                    if (unit != nullptr)
+                    {
+                        _skip = read32(unit);
+                        _unit.clear();
+                        _state = _skip > 0 ? STATE_SKIP : STATE_MAGIC;
+                    }
+
+                    break;
+                }
+                case STATE_SKIP:
+                {
+                    std::size_t count = std::min(_skip, std::size_t(end - in));
+                    in += count;
+                    _skip -= count;
+
+                    if (_skip == 0)
+                    {
+                        _state = STATE_MAGIC;
+                    }
+
+                    break;
+                }
+            }
+        }
+
+        return outputBuffer.size() - offset;
+    }
+
+    std::size_t finish(ByteBuffer&) override
+    {
+        bool isComplete = _state == STATE_MAGIC && _unit.empty();
+
+        reset();
+
+        if (!isComplete)
+        {
+            throw Poco::DataFormatException("Truncated LZ4 frame.");
+        }
+
+        return 0;
+    }
+
+    void reset() override
+    {
+        _state = STATE_MAGIC;
+        _unit.clear();
+        _history.clear();
+        _skip = 0;
+    }
+
+private:
+    enum State
+    {
+        STATE_MAGIC,
+        STATE_FLAGS,
+        STATE_DESCRIPTOR,
+        STATE_BLOCK_SIZE,
+        STATE_BLOCK,
+        STATE_CONTENT_CHECKSUM,
+        STATE_SKIP_SIZE,
+        STATE_SKIP
+    };
+
+    /// \brief Take the next unit of the input.
+    ///
+    /// A unit that is split between calls is collected in _unit, which the
+    /// caller clears once the unit is used.
+    ///
+    /// \returns the unit, or nullptr if the input ran out first.
+    const uint8_t* _take(const uint8_t*& in, const uint8_t* end, std::size_t size)
+    {
+        if (_unit.empty() && std::size_t(end - in) >= size)
+        {
+            const uint8_t* unit = in;
+            in += size;
+            return unit;
+        }
+
+        std::size_t count = std::min(size - _unit.size(), std::size_t(end - in));
+        _unit.writeBytes(in, count);
+        in += count;
+
+        return _unit.size() == size ? _unit.getPtr() : nullptr;
+    }
+
+    void _beginFrame(std::size_t headerSize,
+                     std::size_t available,
+                     ByteBuffer& outputBuffer)
+    {
+        const char* error = parseDescriptor(_header, headerSize, _descriptor);
+
+        if (error != nullptr)
+        {
+            throw Poco::DataFormatException(error);
+        }
+
+        if (_descriptor.has(FLAG_DICTIONARY_ID))
+        {
+            if (!_hasDictionary)
+            {
+                throw Poco::DataFormatException("LZ4 frame needs dictionary " + std::to_string(_descriptor.dictionaryId) + ".");
+            }
+            else if (_descriptor.dictionaryId != _dictionaryId)
+            {
+                throw Poco::DataFormatException("LZ4 frame dictionary ID mismatch.");
+            }
+        }
+
+        if (_descriptor.has(FLAG_CONTENT_SIZE))
+        {
+            // One allocation for the frame, if it is all here.
+            uint64_t size = std::min(_descriptor.contentSize, uint64_t(available) * MAXIMUM_RATIO);
+            outputBuffer.reserve(outputBuffer.size() + std::size_t(size));
+        }
+
+        _written = 0;
+        _history.clear();
+        _history.writeBytes(_dictionaryContent.getPtr(), _dictionaryContent.size());
+        _checksum.reset();
+        _state = STATE_BLOCK_SIZE;
+    }
+
+    void _endFrame()
+    {
+        if (_descriptor.has(FLAG_CONTENT_SIZE) && _written != _descriptor.contentSize)
+        {
+            throw Poco::DataFormatException("LZ4 frame content is smaller than its content size.");
+        }
+
+        _state = _descriptor.has(FLAG_CONTENT_CHECKSUM) ? STATE_CONTENT_CHECKSUM : STATE_MAGIC;
+    }
+
+    void _decodeBlock(const uint8_t* block,
+                      std::size_t size,
+                      ByteBuffer& outputBuffer)
+    {
+        std::size_t capacity = _descriptor.blockMaximum;
+
+        if (_descriptor.has(FLAG_CONTENT_SIZE))
+        {
+            capacity = std::size_t(std::min(uint64_t(capacity), _descriptor.contentSize - _written));
+        }
+
+        const std::size_t offset = outputBuffer.size();
+
+        if (_blockHeader & UNCOMPRESSED_BLOCK)
+        {
+            if (size > capacity)
+            {
+                throw Poco::DataFormatException("LZ4 frame content is larger than its content size.");
+            }
+
+            outputBuffer.writeBytes(block, size);
+        }
+        else
+        {
+            outputBuffer.resize(offset + std::min(capacity, size * MAXIMUM_RATIO + 64));
+
+            const char* source = reinterpret_cast<const char*>(block);
+            char* target = outputBuffer.getCharPtr() + offset;
+            int capacityLeft = int(outputBuffer.size() - offset);
+            int result = 0;
+
+            if (_descriptor.has(FLAG_BLOCK_INDEPENDENCE) && !_hasDictionary)
+            {
+                result = LZ4_decompress_safe(source, target, int(size), capacityLeft);
+            }
+            else if (_descriptor.has(FLAG_BLOCK_INDEPENDENCE))
+            {
+                result = LZ4_decompress_safe_usingDict(source,
+                                                       target,
+                                                       int(size),
+                                                       capacityLeft,
+                                                       _dictionaryContent.getCharPtr(),
+                                                       int(_dictionaryContent.size()));
+            }
+            else
+            {
+                result = LZ4_decompress_safe_usingDict(source,
+                                                       target,
+                                                       int(size),
+                                                       capacityLeft,
+                                                       _history.getCharPtr(),
+                                                       int(_history.size()));
+            }
+
+            if (result < 0)
+            {
+                outputBuffer.resize(offset);
+                throw Poco::DataFormatException("Corrupt LZ4 block.");
+            }
+
+            outputBuffer.resize(offset + std::size_t(result));
+        }
+
+        const uint8_t* decoded = outputBuffer.getPtr() + offset;
+        const std::size_t decodedSize = outputBuffer.size() - offset;
+
+        if (_descriptor.has(FLAG_CONTENT_CHECKSUM))
+        {
+            _checksum.update(decoded, decodedSize);
+        }
+
+        if (!_descriptor.has(FLAG_BLOCK_INDEPENDENCE))
+        {
+            _remember(decoded, decodedSize);
+        }
+
+        _written += decodedSize;
+    }
+
+    /// \brief Keep the window the next dependent block refers back to.
+    ///
+    /// The output buffer may be emptied between calls, so the window is
+    /// copied.
+    void _remember(const uint8_t* buffer, std::size_t size)
+    {
+        if (size >= WINDOW_SIZE)
+        {
+            _history.clear();
+            _history.writeBytes(buffer + size - WINDOW_SIZE, WINDOW_SIZE);
+        }
+        else
+        {
+            std::size_t keep = std::min(_history.size(), WINDOW_SIZE - size);
+
+            if (keep > 0)
+            {
+                std::memmove(_history.getPtr(), _history.getPtr() + _history.size() - keep, keep);
+            }
+
+            _history.resize(keep);
+            _history.writeBytes(buffer, size);
+        }
+    }
+
+    State _state = STATE_MAGIC;
+
+    /// \brief A unit of input split between calls to update().
+    ByteBuffer _unit;
+
+    /// \brief The magic number and descriptor of the current frame.
+    uint8_t _header[19];
+
+    Descriptor _descriptor;
+
+    /// \brief The header of the current block.
+    uint32_t _blockHeader = 0;
+
+    /// \brief The number of bytes uncompressed in the current frame.
+    uint64_t _written = 0;
+
+    /// \brief The last window of a frame with dependent blocks.
+    ByteBuffer _history;
+
+    /// \brief The bytes left in the current skippable frame.
+    std::size_t _skip = 0;
+
+    bool _hasDictionary = false;
+    uint32_t _dictionaryId = 0;
+
+    /// \brief The end of the dictionary that fits in the window.
+    ByteBuffer _dictionaryContent;
+
+    XXH32State _checksum;
+
+};
+
+
+} // namespace
+
+
+std::size_t LZ4Frame::compress(const ByteBufferView& uncompressedBuffer,
+                               ByteBuffer& compressedBuffer)
+{
+    return compress(uncompressedBuffer, compressedBuffer, Settings());
+}
+
+
+std::size_t LZ4Frame::compress(const ByteBufferView& uncompressedBuffer,
+                               ByteBuffer& compressedBuffer,
+                               const Settings& settings)
+{
+    return compress(uncompressedBuffer, compressedBuffer, settings, CompressionDictionary());
+}
+
+
+std::size_t LZ4Frame::compress(const ByteBufferView& uncompressedBuffer,
+                               ByteBuffer& compressedBuffer,
+                               const Settings& settings,
+                               const CompressionDictionary& dictionary)
+{
+    StreamEncoder encoder(settings, true, uncompressedBuffer.size(), dictionary);
+
+    compressedBuffer.clear();
+    compressedBuffer.reserve(compressBound(uncompressedBuffer.size(), settings));
+
+    encoder.update(uncompressedBuffer, compressedBuffer);
+    encoder.finish(compressedBuffer);
+
+    return compressedBuffer.size();
+}
+
+
+std::size_t LZ4Frame::uncompress(const ByteBufferView& compressedBuffer,
+                                 ByteBuffer& uncompressedBuffer)
+{
+    return uncompress(compressedBuffer, uncompressedBuffer, CompressionDictionary());
+}
+
+
+std::size_t LZ4Frame::uncompress(const ByteBufferView& compressedBuffer,
+                                 ByteBuffer& uncompressedBuffer,
+                                 const CompressionDictionary& dictionary)
+{
+    StreamDecoder decoder(dictionary);
+
+    uncompressedBuffer.clear();
+
+    try
+    {
+        decoder.update(compressedBuffer, uncompressedBuffer);
+        decoder.finish(uncompressedBuffer);
+        return uncompressedBuffer.size();
+    }
+    catch (const Poco::Exception& exc)
+    {
+        ofLogError("LZ4Frame::uncompress") << exc.displayText();
+        uncompressedBuffer.clear();
+        return 0;
+    }
+}
+
+
+std::unique_ptr<AbstractByteTransform> LZ4Frame::createStreamEncoder()
+{
+    return createStreamEncoder(Settings());
+}
+
+
+std::unique_ptr<AbstractByteTransform> LZ4Frame::createStreamEncoder(const Settings& settings)
+{
+    return createStreamEncoder(settings, CompressionDictionary());
+}
+
+
+std::unique_ptr<AbstractByteTransform> LZ4Frame::createStreamEncoder(const Settings& settings,
+                                                                     const CompressionDictionary& dictionary)
+{
+    return std::make_unique<StreamEncoder>(settings, false, 0, dictionary);
+}
+
+
+std::unique_ptr<AbstractByteTransform> LZ4Frame::createStreamDecoder()
+{
+    return createStreamDecoder(CompressionDictionary());
+}
+
+
+std::unique_ptr<AbstractByteTransform> LZ4Frame::createStreamDecoder(const CompressionDictionary& dictionary)
+{
+    return std::make_unique<StreamDecoder>(dictionary);
+}
+
+
+std::size_t LZ4Frame::compressBound(std::size_t size, const Settings& settings)
+{
+    const std::size_t blockMaximum = blockBytes(settings.blockSize);
+    const std::size_t checksumSize = settings.hasBlockChecksum ? 4 : 0;
+    const std::size_t fullBlocks = size / blockMaximum;
+    const std::size_t lastBlock = size % blockMaximum;
+
+    // Magic number, descriptor, end mark and content checksum.
+    std::size_t bound = 4 + 15 + 4 + 4;
+
+    bound += fullBlocks * (4 + std::size_t(LZ4_compressBound(int(blockMaximum))) + checksumSize);
+
+    if (lastBlock > 0)
+    {
+        bound += 4 + std::size_t(LZ4_compressBound(int(lastBlock))) + checksumSize;
+    }
+
+    return bound;
+}
+
+
+bool LZ4Frame::isFrame(const ByteBufferView& buffer)
+{
+    return buffer.size() >= 4 && read32(buffer.getPtr()) == MAGIC_NUMBER;
+}
+
+
+bool LZ4Frame::getContentSize(const ByteBufferView& buffer,
+                              uint64_t& contentSize)
+{
+    Descriptor descriptor;
+
+    if (parseDescriptor(buffer.getPtr(), buffer.size(), descriptor) == nullptr
+    && descriptor.has(FLAG_CONTENT_SIZE))
+    {
+        contentSize = descriptor.contentSize;
+        return true;
+    }
+
+    return false;
+}
+
+
+bool LZ4Frame::getDictionaryId(const ByteBufferView& buffer,
+                               uint32_t& dictionaryId)
+{
+    Descriptor descriptor;
+
+    if (parseDescriptor(buffer.getPtr(), buffer.size(), descriptor) == nullptr
+    && descriptor.has(FLAG_DICTIONARY_ID))
+    {
+        dictionaryId = descriptor.dictionaryId;
+        return true;
+    }
+
+    return false;
+}
+
+
+bool LZ4Frame::getFrameSize(const ByteBufferView& buffer,
+                            std::size_t& frameSize)
+{
+    Descriptor descriptor;
+
+    if (parseDescriptor(buffer.getPtr(), buffer.size(), descriptor) != nullptr)
+    {
+        return false;
+    }
+
+    const uint8_t* p = buffer.getPtr();
+    const std::size_t checksumSize = descriptor.has(FLAG_BLOCK_CHECKSUM) ? 4 : 0;
+    std::size_t position = descriptor.headerSize;
+
+    while (true)
+    {
+        if (buffer.size() - position < 4)
+        {
+            return false;
+        }
+
+        const uint32_t blockHeader = read32(p + position);
+        position += 4;
+
+        if (blockHeader == 0)
+        {
+            break;
+        }
+
+        const std::size_t blockSize = blockHeader & ~UNCOMPRESSED_BLOCK;
+
+        if (blockSize > descriptor.blockMaximum
+        || buffer.size() - position < blockSize + checksumSize)
+        {
+            return false;
+        }
+
+        position += blockSize + checksumSize;
+    }
+
+    if (descriptor.has(FLAG_CONTENT_CHECKSUM))
+    {
+        if (buffer.size() - position < 4)
+        {
+            return false;
+        }
+
+        position += 4;
+    }
+
+    frameSize = position;
+    return true;
+}
+
+
+uint32_t LZ4Frame::xxh32(const uint8_t* buffer, std::size_t size, uint32_t seed)
+{
+    XXH32State state(seed);
+    state.update(buffer, size);
+    return state.digest();
+}
+
+
+} }  // namespace ofx::IO
@@ -0,0 +1,220 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/IO/MappedFileBuffer.h"
+#include <algorithm>
+#include <cstring>
+#include "Poco/File.h"
+#include "ofUtils.h"
+
+
+#if !defined(TARGET_WIN32)
+#include <sys/mman.h>
+#endif
+
+
+namespace ofx {
+namespace IO {
+
+
+MappedFileBuffer::MappedFileBuffer()
+{
+}
+
+
+MappedFileBuffer::MappedFileBuffer(const std::string& path,
+                                   Mode mode,
+                                   Advice advice)
+{
+    open(path, mode, advice);
+}
+
+
+MappedFileBuffer::~MappedFileBuffer()
+{
+}
+
+
+void MappedFileBuffer::open(const std::string& path,
+                            Mode mode,
+                            Advice advice)
+{
+    close();
+
+    Poco::File file(ofToDataPath(path, true));
+
+    std::size_t size = static_cast<std::size_t>(file.getSize());
+
+    _mode = mode;
+
+    // Empty files cannot be mapped, but are valid empty sources.
+    if (size > 0)
+    {
+        _memory.reset(new Poco::SharedMemory(file,
+                                             mode == Mode::READ_WRITE ? Poco::SharedMemory::AM_WRITE
+                                                                      : Poco::SharedMemory::AM_READ));
+        _size = size;
+        advise(advice);
+    }
+}
+
+
+void MappedFileBuffer::close()
+{
+    _memory.reset();
+    _size = 0;
+}
+
+
+bool MappedFileBuffer::isOpen() const
+{
+    return _memory != nullptr;
+}
+
+
+MappedFileBuffer::Mode MappedFileBuffer::mode() const
+{
+    return _mode;
+}
+
+
+void MappedFileBuffer::advise(Advice advice)
+{
+#if !defined(TARGET_WIN32)
+    if (_memory != nullptr)
+    {
+        int posixAdvice = POSIX_MADV_NORMAL;
+
+        switch (advice)
+        {
+            case Advice::NORMAL:
+                posixAdvice = POSIX_MADV_NORMAL;
+                break;
+            case Advice::SEQUENTIAL:
+                posixAdvice = POSIX_MADV_SEQUENTIAL;
+                break;
+            case Advice::RANDOM:
+                posixAdvice = POSIX_MADV_RANDOM;
+                break;
+            case Advice::WILL_NEED:
+                posixAdvice = POSIX_MADV_WILLNEED;
+                break;
+        }
+
+        posix_madvise(_memory->begin(), _size, posixAdvice);
+    }
+#else
+    (void)advice;
+#endif
+}
+
+
+bool MappedFileBuffer::flush()
+{
+#if !defined(TARGET_WIN32)
+    if (_memory != nullptr && _mode == Mode::READ_WRITE)
+    {
+        return msync(_memory->begin(), _size, MS_SYNC) == 0;
+    }
+#endif
+    return _memory != nullptr;
+}
+
+
+std::size_t MappedFileBuffer::readBytes(uint8_t* buffer, std::size_t size) const
+{
+    return view().readBytes(buffer, size);
+}
+
+
+std::size_t MappedFileBuffer::readBytes(std::vector<uint8_t>& buffer) const
+{
+    return view().readBytes(buffer);
+}
+
+
+std::size_t MappedFileBuffer::readBytes(std::string& buffer) const
+{
+    return view().readBytes(buffer);
+}
+
+
+std::size_t MappedFileBuffer::readBytes(AbstractByteSink& buffer) const
+{
+    return view().readBytes(buffer);
+}
+
+
+std::vector<uint8_t> MappedFileBuffer::readBytes() const
+{
+    return view().readBytes();
+}
+
+
+std::size_t MappedFileBuffer::size() const
+{
+    return _size;
+}
+
+
+bool MappedFileBuffer::empty() const
+{
+    return _size == 0;
+}
+
+
+const uint8_t* MappedFileBuffer::getPtr() const
+{
+    if (_memory != nullptr)
+    {
+        return reinterpret_cast<const uint8_t*>(_memory->begin());
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+
+uint8_t* MappedFileBuffer::getWritePtr()
+{
+    if (_memory != nullptr && _mode == Mode::READ_WRITE)
+    {
+        return reinterpret_cast<uint8_t*>(_memory->begin());
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+
+const char* MappedFileBuffer::getCharPtr() const
+{
+    return reinterpret_cast<const char*>(getPtr());
+}
+
+
+const char* MappedFileBuffer::getData() const
+{
+    return getCharPtr();
+}
+
+
+ByteBufferView MappedFileBuffer::view() const
+{
+    return ByteBufferView(getPtr(), _size);
+}
+
+
+MappedFileBuffer::operator ByteBufferView() const
+{
+    return view();
+}
+
+
+} }  // namespace ofx::IO
@@ -0,0 +1,764 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/IO/ParallelCompression.h"
+#include "ofx/IO/Compressor.h"
+#include "ofx/IO/Decompressor.h"
+#include "ofx/IO/LZ4Frame.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "Poco/Exception.h"
+#include "Poco/Foundation.h"
+#if defined(POCO_UNBUNDLED)
+#include <zlib.h>
+#else
+#include "Poco/zlib.h"
+#endif
+#include "ofLog.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+namespace {
+
+
+enum
+{
+    /// \brief The size of a gzip member header with the `IO` extra field.
+    GZIP_HEADER_SIZE = 20,
+
+    /// \brief The size of a gzip member trailer.
+    GZIP_TRAILER_SIZE = 8,
+
+    /// \brief The size of a zlib stream header.
+    ZLIB_HEADER_SIZE = 2,
+
+    /// \brief The size of a zlib stream trailer.
+    ZLIB_TRAILER_SIZE = 4,
+
+    /// \brief The gzip flag for an extra field.
+    GZIP_FLAG_EXTRA = 0x04,
+
+    /// \brief The size of the sizes before each block of a container.
+    CONTAINER_BLOCK_HEADER_SIZE = 8,
+
+    /// \brief The largest ratio of content to compressed bytes of deflate.
+    DEFLATE_MAXIMUM_RATIO = 1032,
+
+    /// \brief The largest ratio of content to compressed bytes of LZ4.
+    LZ4_MAXIMUM_RATIO = 256
+};
+
+
+inline uint32_t read16(const uint8_t* p)
+{
+    return uint32_t(p[0])
+         | uint32_t(p[1]) << 8;
+}
+
+
+inline uint32_t read32(const uint8_t* p)
+{
+    return uint32_t(p[0])
+         | uint32_t(p[1]) << 8
+         | uint32_t(p[2]) << 16
+         | uint32_t(p[3]) << 24;
+}
+
+
+inline void write32(uint8_t* p, uint32_t value)
+{
+    p[0] = uint8_t(value);
+    p[1] = uint8_t(value >> 8);
+    p[2] = uint8_t(value >> 16);
+    p[3] = uint8_t(value >> 24);
+}
+
+
+inline void write32BigEndian(uint8_t* p, uint32_t value)
+{
+    p[0] = uint8_t(value >> 24);
+    p[1] = uint8_t(value >> 16);
+    p[2] = uint8_t(value >> 8);
+    p[3] = uint8_t(value);
+}
+
+
+/// \brief Write the header of a zlib stream with a 32 KB window.
+/// \param level The zlib level, recorded as deflateInit() would.
+void writeZlibHeader(int level, ByteBuffer& buffer)
+{
+    if (level == Z_DEFAULT_COMPRESSION)
+    {
+        level = 6;
+    }
+
+    const uint32_t compressionLevel = level < 2 ? 0 : (level < 6 ? 1 : (level == 6 ? 2 : 3));
+
+    uint32_t header = (uint32_t(Z_DEFLATED + ((MAX_WBITS - 8) << 4)) << 8) | (compressionLevel << 6);
+    header += 31 - (header % 31);
+
+    const uint8_t bytes[ZLIB_HEADER_SIZE] = { uint8_t(header >> 8), uint8_t(header) };
+    buffer.writeBytes(bytes, sizeof(bytes));
+}
+
+
+/// \returns true if the type is written as a container of blocks.
+bool isContainer(Compression::Type type)
+{
+    return type == Compression::SNAPPY || type == Compression::BR;
+}
+
+
+/// \brief A compressed block and its place in the content.
+struct Block
+{
+    std::size_t compressedOffset;
+    std::size_t compressedSize;
+    std::size_t uncompressedOffset;
+    std::size_t uncompressedSize;
+};
+
+
+/// \brief Find the gzip members written by ParallelCompression.
+/// \returns false if any member does not record its size.
+bool findMembers(const ByteBufferView& buffer, std::vector<Block>& blocks)
+{
+    const uint8_t* p = buffer.getPtr();
+    std::size_t position = 0;
+    std::size_t uncompressedOffset = 0;
+
+    while (position < buffer.size())
+    {
+        const uint8_t* member = p + position;
+        const std::size_t remaining = buffer.size() - position;
+
+        if (remaining < GZIP_HEADER_SIZE + GZIP_TRAILER_SIZE
+        || member[0] != 0x1F
+        || member[1] != 0x8B
+        || member[2] != Z_DEFLATED
+        || (member[3] & GZIP_FLAG_EXTRA) == 0)
+        {
+            return false;
+        }
+
+        const std::size_t extraSize = read16(member + 10);
+
+        if (remaining < 12 + extraSize + GZIP_TRAILER_SIZE)
+        {
+            return false;
+        }
+
+        std::size_t memberSize = 0;
+
+        for (std::size_t i = 12; i + 4 <= 12 + extraSize; )
+        {
+            const std::size_t fieldSize = read16(member + i + 2);
+
+            if (member[i] == 'I' && member[i + 1] == 'O' && fieldSize == 4 && i + 8 <= 12 + extraSize)
+            {
+                memberSize = read32(member + i + 4);
+                break;
+            }
+
+            i += 4 + fieldSize;
+        }
+
+        if (memberSize < 12 + extraSize + GZIP_TRAILER_SIZE || memberSize > remaining)
+        {
+            return false;
+        }
+
+        const std::size_t uncompressedSize = read32(member + memberSize - 4);
+
+        if (uncompressedSize / DEFLATE_MAXIMUM_RATIO > memberSize)
+        {
+            return false;
+        }
+
+        blocks.push_back({ position, memberSize, uncompressedOffset, uncompressedSize });
+        position += memberSize;
+        uncompressedOffset += uncompressedSize;
+    }
+
+    return true;
+}
+
+
+/// \brief Find the LZ4 frames that record their content size.
+/// \returns false if any frame does not record its size.
+bool findFrames(const ByteBufferView& buffer, std::vector<Block>& blocks)
+{
+    std::size_t position = 0;
+    std::size_t uncompressedOffset = 0;
+
+    while (position < buffer.size())
+    {
+        const ByteBufferView frame(buffer.getPtr() + position, buffer.size() - position);
+
+        uint64_t contentSize = 0;
+        std::size_t frameSize = 0;
+
+        if (!LZ4Frame::getContentSize(frame, contentSize)
+        || !LZ4Frame::getFrameSize(frame, frameSize)
+        || contentSize > ParallelCompression::MAXIMUM_BLOCK_SIZE
+        || contentSize / LZ4_MAXIMUM_RATIO > frameSize)
+        {
+            return false;
+        }
+
+        blocks.push_back({ position, frameSize, uncompressedOffset, std::size_t(contentSize) });
+        position += frameSize;
+        uncompressedOffset += std::size_t(contentSize);
+    }
+
+    return true;
+}
+
+
+/// \brief Find the blocks of a container.
+/// \returns false if the buffer is not a container.
+/// \throws Poco::DataFormatException if the container is truncated.
+bool findContainerBlocks(const ByteBufferView& buffer, std::vector<Block>& blocks)
+{
+    const uint8_t* p = buffer.getPtr();
+
+    if (buffer.size() < 4 || read32(p) != ParallelCompression::MAGIC_NUMBER)
+    {
+        return false;
+    }
+
+    std::size_t position = 4;
+    std::size_t uncompressedOffset = 0;
+
+    while (position < buffer.size())
+    {
+        if (buffer.size() - position < CONTAINER_BLOCK_HEADER_SIZE)
+        {
+            throw Poco::DataFormatException("Truncated block header.");
+        }
+
+        const std::size_t compressedSize = read32(p + position);
+        const std::size_t uncompressedSize = read32(p + position + 4);
+        position += CONTAINER_BLOCK_HEADER_SIZE;
+
+        if (buffer.size() - position < compressedSize)
+        {
+            throw Poco::DataFormatException("Truncated block.");
+        }
+
+        if (uncompressedSize > ParallelCompression::MAXIMUM_BLOCK_SIZE)
+        {
+            throw Poco::DataFormatException("Invalid block size.");
+        }
+
+        blocks.push_back({ position, compressedSize, uncompressedOffset, uncompressedSize });
+        position += compressedSize;
+        uncompressedOffset += uncompressedSize;
+    }
+
+    return true;
+}
+
+
+/// \brief Compresses blocks on one thread.
+class BlockEncoder
+{
+public:
+    BlockEncoder(Compression::Type type, int level):
+        _type(type),
+        _level(level)
+    {
+        if (type == Compression::ZLIB)
+        {
+            // The blocks of a zlib stream end with a sync flush rather than
+            // finishing, which a Compressor does not do.
+            if (deflateInit2(&_stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            {
+                throw Poco::InvalidArgumentException("Invalid zlib level: " + std::to_string(level));
+            }
+        }
+        else
+        {
+            _compressor = std::make_unique<Compressor>(type == Compression::GZIP ? Compression::ZLIB : type,
+                                                       level,
+                                                       type == Compression::GZIP ? -MAX_WBITS : Compressor::defaultWindowBits(type));
+        }
+    }
+
+    ~BlockEncoder()
+    {
+        deflateEnd(&_stream);
+    }
+
+    /// \brief Compress a block as a complete stream, or for Type::ZLIB as
+    /// raw deflate that ends on a byte boundary.
+    /// \param buffer The bytes to compress.
+    /// \param block The buffer to fill with the block.
+    /// \param isLast True if the block is the last of the content.
+    /// \throws Poco::DataFormatException if the block does not compress.
+    void compress(const ByteBufferView& buffer, ByteBuffer& block, bool isLast)
+    {
+        switch (_type)
+        {
+            case Compression::ZLIB:
+            {
+                _deflate(buffer, block, isLast ? Z_FINISH : Z_SYNC_FLUSH);
+                break;
+            }
+            case Compression::GZIP:
+            {
+                _compress(buffer, _buffer);
+
+                const std::size_t memberSize = GZIP_HEADER_SIZE + _buffer.size() + GZIP_TRAILER_SIZE;
+
+                if (memberSize > UINT32_MAX)
+                {
+                    throw Poco::DataFormatException("gzip member too large.");
+                }
+
+                // No name or time, with the size of the member in an extra
+                // field and the zlib XFL and unknown OS.
+                uint8_t header[GZIP_HEADER_SIZE] = {
+                    0x1F, 0x8B, Z_DEFLATED, GZIP_FLAG_EXTRA,
+                    0, 0, 0, 0,
+                    uint8_t(_level == 9 ? 2 : (_level == 1 ? 4 : 0)), 255,
+                    8, 0,
+                    'I', 'O', 4, 0
+                };
+
+                write32(header + 16, uint32_t(memberSize));
+
+                uint8_t trailer[GZIP_TRAILER_SIZE];
+                write32(trailer, uint32_t(crc32(crc32(0, Z_NULL, 0), buffer.getPtr(), uInt(buffer.size()))));
+                write32(trailer + 4, uint32_t(buffer.size()));
+
+                block.reserve(memberSize);
+                block.writeBytes(header, sizeof(header));
+                block.writeBytes(_buffer.getPtr(), _buffer.size());
+                block.writeBytes(trailer, sizeof(trailer));
+                break;
+            }
+            case Compression::SNAPPY:
+            case Compression::BR:
+            {
+                _compress(buffer, _buffer);
+
+                if (_buffer.size() > UINT32_MAX)
+                {
+                    throw Poco::DataFormatException("Block too large.");
+                }
+
+                uint8_t header[CONTAINER_BLOCK_HEADER_SIZE];
+                write32(header, uint32_t(_buffer.size()));
+                write32(header + 4, uint32_t(buffer.size()));
+
+                block.reserve(sizeof(header) + _buffer.size());
+                block.writeBytes(header, sizeof(header));
+                block.writeBytes(_buffer.getPtr(), _buffer.size());
+                break;
+            }
+            default:
+            {
+                _compress(buffer, block);
+                break;
+            }
+        }
+    }
+
+private:
+    void _compress(const ByteBufferView& buffer, ByteBuffer& compressedBuffer)
+    {
+        if (_compressor->compress(buffer, compressedBuffer) == 0)
+        {
+            throw Poco::DataFormatException("Unable to compress block.");
+        }
+    }
+
+    /// \brief Deflate a block on its own, ending it with flush.
+    void _deflate(const ByteBufferView& buffer, ByteBuffer& block, int flush)
+    {
+        deflateReset(&_stream);
+
+        _stream.next_in = const_cast<Bytef*>(buffer.getPtr());
+        _stream.avail_in = uInt(buffer.size());
+
+        // The bound leaves room for the empty block of a sync flush.
+        block.resize(deflateBound(&_stream, uLong(buffer.size())) + 8);
+
+        std::size_t written = 0;
+
+        while (true)
+        {
+            _stream.next_out = block.getPtr() + written;
+            _stream.avail_out = uInt(block.size() - written);
+
+            const int result = deflate(&_stream, flush);
+
+            if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+            {
+                throw Poco::DataFormatException(std::string("zlib error: ") + (_stream.msg ? _stream.msg : "unknown"));
+            }
+
+            written = block.size() - _stream.avail_out;
+
+            if (flush == Z_FINISH ? result == Z_STREAM_END : _stream.avail_out != 0)
+            {
+                break;
+            }
+
+            block.resize(block.size() * 2);
+        }
+
+        block.resize(written);
+    }
+
+    Compression::Type _type;
+
+    int _level;
+
+    /// \brief The compressor of every type but Type::ZLIB.
+    std::unique_ptr<Compressor> _compressor;
+
+    /// \brief The raw deflate stream of Type::ZLIB.
+    z_stream _stream = z_stream();
+
+    /// \brief The stream of a block, before it is framed.
+    ByteBuffer _buffer;
+
+};
+
+
+/// \brief Uncompresses blocks on one thread.
+class BlockDecoder
+{
+public:
+    BlockDecoder(Compression::Type type): _decompressor(type)
+    {
+    }
+
+    /// \brief Uncompress a block into its place in the content.
+    /// \param buffer The compressed stream of the block.
+    /// \param uncompressedBuffer The place of the block in the content.
+    /// \param uncompressedSize The uncompressed size of the block.
+    /// \throws Poco::DataFormatException if the block is invalid.
+    void uncompress(const ByteBufferView& buffer,
+                    uint8_t* uncompressedBuffer,
+                    std::size_t uncompressedSize)
+    {
+        _decompressor.uncompress(buffer, _buffer);
+
+        if (_buffer.size() != uncompressedSize)
+        {
+            throw Poco::DataFormatException("Uncompressed block size mismatch.");
+        }
+
+        if (uncompressedSize > 0)
+        {
+            std::memcpy(uncompressedBuffer, _buffer.getPtr(), uncompressedSize);
+        }
+    }
+
+private:
+    Decompressor _decompressor;
+
+    ByteBuffer _buffer;
+
+};
+
+
+/// \returns the number of threads to use for count blocks.
+std::size_t threadCount(std::size_t numThreads, std::size_t count)
+{
+    if (numThreads == 0)
+    {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    return std::max(std::min(numThreads, count), std::size_t(1));
+}
+
+
+/// \brief Spread blocks over threads, including the calling thread.
+///
+/// Each thread calls makeWorker() once, then calls the worker it returns
+/// with the index of each block it takes. After an exception the remaining
+/// blocks are skipped.
+///
+/// \param count The number of blocks.
+/// \param numThreads The number of threads.
+/// \param makeWorker Creates the state of each thread.
+/// \throws the first exception of any thread, once all have finished.
+template <typename MakeWorker>
+void forEachBlock(std::size_t count,
+                  std::size_t numThreads,
+                  MakeWorker makeWorker)
+{
+    std::atomic<std::size_t> next(0);
+    std::exception_ptr error;
+    std::mutex mutex;
+
+    auto run = [&]() {
+        try
+        {
+            auto worker = makeWorker();
+            std::size_t index = 0;
+
+            while ((index = next++) < count)
+            {
+                worker(index);
+            }
+        }
+        catch (...)
+        {
+            next = count;
+            std::unique_lock<std::mutex> lock(mutex);
+
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 1; i < numThreads; ++i)
+    {
+        try
+        {
+            threads.emplace_back(run);
+        }
+        catch (const std::system_error& exc)
+        {
+            ofLogWarning("ParallelCompression") << "Using " << threads.size() + 1 << " threads: " << exc.what();
+            break;
+        }
+    }
+
+    run();
+
+    for (auto& thread: threads)
+    {
+        thread.join();
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+
+} // namespace
+
+
+std::size_t ParallelCompression::compress(const ByteBufferView& uncompressedBuffer,
+                                          ByteBuffer& compressedBuffer,
+                                          Compression::Type type)
+{
+    return compress(uncompressedBuffer,
+                    compressedBuffer,
+                    type,
+                    Compressor::defaultLevel(type),
+                    Settings());
+}
+
+
+std::size_t ParallelCompression::compress(const ByteBufferView& uncompressedBuffer,
+                                          ByteBuffer& compressedBuffer,
+                                          Compression::Type type,
+                                          int level)
+{
+    return compress(uncompressedBuffer,
+                    compressedBuffer,
+                    type,
+                    level,
+                    Settings());
+}
+
+
+std::size_t ParallelCompression::compress(const ByteBufferView& uncompressedBuffer,
+                                          ByteBuffer& compressedBuffer,
+                                          Compression::Type type,
+                                          int level,
+                                          const Settings& settings)
+{
+    compressedBuffer.clear();
+
+    try
+    {
+        if (type == Compression::NONE)
+        {
+            return Compressor(type, level).compress(uncompressedBuffer, compressedBuffer);
+        }
+
+        const std::size_t blockSize = std::min(std::max(settings.blockSize,
+                                                        std::size_t(MINIMUM_BLOCK_SIZE)),
+                                               std::size_t(MAXIMUM_BLOCK_SIZE));
+
+        // Empty content is one empty block, so the output is never empty.
+        const std::size_t count = std::max((uncompressedBuffer.size() + blockSize - 1) / blockSize,
+                                           std::size_t(1));
+
+        compressedBuffer.reserve(uncompressedBuffer.size() + count * 64 + 64);
+
+        if (isContainer(type))
+        {
+            uint8_t magic[4];
+            write32(magic, MAGIC_NUMBER);
+            compressedBuffer.writeBytes(magic, sizeof(magic));
+        }
+        else if (type == Compression::ZLIB)
+        {
+            writeZlibHeader(level, compressedBuffer);
+        }
+
+        // The Adler-32 of each block of a zlib stream, combined for its
+        // trailer.
+        std::vector<uLong> checksums(type == Compression::ZLIB ? count : 0);
+
+        // Blocks are written in order as they finish. A block that finishes
+        // early waits for those before it.
+        std::vector<ByteBuffer> blocks(count);
+        std::vector<bool> isFinished(count, false);
+        std::size_t nextToWrite = 0;
+        std::mutex mutex;
+
+        forEachBlock(count, threadCount(settings.numThreads, count), [&]() {
+            return [&, encoder = std::make_unique<BlockEncoder>(type, level)](std::size_t index) {
+                const std::size_t offset = index * blockSize;
+                const std::size_t size = std::min(blockSize, uncompressedBuffer.size() - offset);
+
+                ByteBuffer block;
+                encoder->compress(ByteBufferView(uncompressedBuffer.getPtr() + offset, size), block, index + 1 == count);
+
+                if (type == Compression::ZLIB)
+                {
+                    checksums[index] = adler32(adler32(0, Z_NULL, 0), uncompressedBuffer.getPtr() + offset, uInt(size));
+                }
+
+                std::unique_lock<std::mutex> lock(mutex);
+
+                blocks[index].swap(block);
+                isFinished[index] = true;
+
+                while (nextToWrite < count && isFinished[nextToWrite])
+                {
+                    compressedBuffer.writeBytes(blocks[nextToWrite].getPtr(),
+                                                blocks[nextToWrite].size());
+                    ByteBuffer().swap(blocks[nextToWrite]);
+                    ++nextToWrite;
+                }
+            };
+        });
+
+        if (type == Compression::ZLIB)
+        {
+            uLong checksum = adler32(0, Z_NULL, 0);
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const std::size_t size = std::min(blockSize, uncompressedBuffer.size() - i * blockSize);
+                checksum = adler32_combine(checksum, checksums[i], z_off_t(size));
+            }
+
+            uint8_t trailer[ZLIB_TRAILER_SIZE];
+            write32BigEndian(trailer, uint32_t(checksum));
+            compressedBuffer.writeBytes(trailer, sizeof(trailer));
+        }
+
+        return compressedBuffer.size();
+    }
+    catch (const Poco::Exception& exc)
+    {
+        ofLogError("ParallelCompression::compress") << exc.displayText();
+        compressedBuffer.clear();
+        return 0;
+    }
+}
+
+
+std::size_t ParallelCompression::uncompress(const ByteBufferView& compressedBuffer,
+                                            ByteBuffer& uncompressedBuffer,
+                                            Compression::Type type)
+{
+    return uncompress(compressedBuffer,
+                      uncompressedBuffer,
+                      type,
+                      Settings());
+}
+
+
+std::size_t ParallelCompression::uncompress(const ByteBufferView& compressedBuffer,
+                                            ByteBuffer& uncompressedBuffer,
+                                            Compression::Type type,
+                                            const Settings& settings)
+{
+    uncompressedBuffer.clear();
+
+    try
+    {
+        std::vector<Block> blocks;
+        bool isIndexed = false;
+
+        switch (type)
+        {
+            case Compression::GZIP:
+                isIndexed = findMembers(compressedBuffer, blocks);
+                break;
+            case Compression::LZ4:
+                isIndexed = findFrames(compressedBuffer, blocks);
+                break;
+            case Compression::SNAPPY:
+            case Compression::BR:
+                isIndexed = findContainerBlocks(compressedBuffer, blocks);
+                break;
+            default:
+                break;
+        }
+
+        if (!isIndexed || blocks.empty())
+        {
+            return Decompressor(type).uncompress(compressedBuffer, uncompressedBuffer);
+        }
+
+        uncompressedBuffer.resize(blocks.back().uncompressedOffset + blocks.back().uncompressedSize);
+
+        forEachBlock(blocks.size(), threadCount(settings.numThreads, blocks.size()), [&]() {
+            return [&, decoder = std::make_unique<BlockDecoder>(type)](std::size_t index) {
+                const Block& block = blocks[index];
+
+                decoder->uncompress(ByteBufferView(compressedBuffer.getPtr() + block.compressedOffset,
+                                                   block.compressedSize),
+                                    uncompressedBuffer.getPtr() + block.uncompressedOffset,
+                                    block.uncompressedSize);
+            };
+        });
+
+        return uncompressedBuffer.size();
+    }
+    catch (const Poco::Exception& exc)
+    {
+        ofLogError("ParallelCompression::uncompress") << exc.displayText();
+        uncompressedBuffer.clear();
+        return 0;
+    }
+}
+
+
+} }  // namespace ofx::IO
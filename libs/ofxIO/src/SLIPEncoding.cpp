@@ -9,12 +9,181 @@
 
 
 #include "ofx/IO/SLIPEncoding.h"
+#include <cstring>
+
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OFX_IO_SLIP_SSE2 1
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__aarch64__)
+#include <arm_neon.h>
+#define OFX_IO_SLIP_NEON 1
+#endif
+
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 
 namespace ofx {
 namespace IO {
 
 
+namespace {
+
+
+/// \brief Index of the lowest set bit of a non-zero mask.
+inline unsigned lowestBit(uint64_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
+
+
+/// \brief An incremental SLIP encoder with the same output as encode().
+class SLIPTransformEncoder: public AbstractByteTransform
+{
+public:
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        if (buffer.size() == 0)
+        {
+            return 0;
+        }
+
+        const std::size_t offset = outputBuffer.size();
+        outputBuffer.resize(offset + 2 * buffer.size() + 1);
+
+        uint8_t* out = outputBuffer.getPtr() + offset;
+
+        if (!_isStarted)
+        {
+            // Flush any line noise at the receiver, as encode() does.
+            *out++ = SLIPEncoding::END;
+            _isStarted = true;
+        }
+
+        for (std::size_t i = 0; i < buffer.size(); ++i)
+        {
+            uint8_t byte = buffer.getPtr()[i];
+
+            if (byte == SLIPEncoding::END)
+            {
+                *out++ = SLIPEncoding::ESC;
+                *out++ = SLIPEncoding::ESC_END;
+            }
+            else if (byte == SLIPEncoding::ESC)
+            {
+                *out++ = SLIPEncoding::ESC;
+                *out++ = SLIPEncoding::ESC_ESC;
+            }
+            else
+            {
+                *out++ = byte;
+            }
+        }
+
+        std::size_t written = static_cast<std::size_t>(out - (outputBuffer.getPtr() + offset));
+        outputBuffer.resize(offset + written);
+        return written;
+    }
+
+    std::size_t finish(ByteBuffer&) override
+    {
+        reset();
+        return 0;
+    }
+
+    void reset() override
+    {
+        _isStarted = false;
+    }
+
+private:
+    /// \brief True once the leading END has been written.
+    bool _isStarted = false;
+
+};
+
+
+/// \brief An incremental SLIP decoder.
+///
+/// END bytes are skipped, as in decode(). An ESC followed by anything other
+/// than ESC_END or ESC_ESC is a protocol violation, and the byte is kept as
+/// is, as RFC 1055 suggests.
+class SLIPTransformDecoder: public AbstractByteTransform
+{
+public:
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        const std::size_t offset = outputBuffer.size();
+        outputBuffer.resize(offset + buffer.size());
+
+        uint8_t* out = outputBuffer.getPtr() + offset;
+
+        for (std::size_t i = 0; i < buffer.size(); ++i)
+        {
+            uint8_t byte = buffer.getPtr()[i];
+
+            if (_isEscaped)
+            {
+                _isEscaped = false;
+
+                if (byte == SLIPEncoding::ESC_END)
+                {
+                    *out++ = SLIPEncoding::END;
+                }
+                else if (byte == SLIPEncoding::ESC_ESC)
+                {
+                    *out++ = SLIPEncoding::ESC;
+                }
+                else
+                {
+                    *out++ = byte;
+                }
+            }
+            else if (byte == SLIPEncoding::ESC)
+            {
+                _isEscaped = true;
+            }
+            else if (byte != SLIPEncoding::END)
+            {
+                *out++ = byte;
+            }
+        }
+
+        std::size_t written = static_cast<std::size_t>(out - (outputBuffer.getPtr() + offset));
+        outputBuffer.resize(offset + written);
+        return written;
+    }
+
+    std::size_t finish(ByteBuffer&) override
+    {
+        reset();
+        return 0;
+    }
+
+    void reset() override
+    {
+        _isEscaped = false;
+    }
+
+private:
+    /// \brief True if the last byte was an ESC.
+    bool _isEscaped = false;
+
+};
+
+
+} // namespace
+
+
 SLIPEncoding::SLIPEncoding()
 {
 }
@@ -27,6 +196,20 @@ SLIPEncoding::~SLIPEncoding()
 
 std::size_t SLIPEncoding::encode(const ByteBuffer& buffer,
                                  ByteBuffer& encodedBuffer)
+{
+    return encode(ByteBufferView(buffer), encodedBuffer);
+}
+
+
+std::size_t SLIPEncoding::decode(const ByteBuffer& buffer,
+                                 ByteBuffer& decodedBuffer)
+{
+    return decode(ByteBufferView(buffer), decodedBuffer);
+}
+
+
+std::size_t SLIPEncoding::encode(const ByteBufferView& buffer,
+                                 ByteBuffer& encodedBuffer)
 {
     if (buffer.size() > 0)
     {
@@ -45,7 +228,7 @@ std::size_t SLIPEncoding::encode(const ByteBuffer& buffer,
 }
 
 
-std::size_t SLIPEncoding::decode(const ByteBuffer& buffer,
+std::size_t SLIPEncoding::decode(const ByteBufferView& buffer,
                                  ByteBuffer& decodedBuffer)
 {
     if (buffer.size() > 0)
@@ -64,6 +247,18 @@ std::size_t SLIPEncoding::decode(const ByteBuffer& buffer,
 }
 
 
+std::unique_ptr<AbstractByteTransform> SLIPEncoding::createStreamEncoder()
+{
+    return std::make_unique<SLIPTransformEncoder>();
+}
+
+
+std::unique_ptr<AbstractByteTransform> SLIPEncoding::createStreamDecoder()
+{
+    return std::make_unique<SLIPTransformDecoder>();
+}
+
+
 std::size_t SLIPEncoding::encode(const uint8_t* buffer,
                                  std::size_t size,
                                  uint8_t* encoded)
@@ -71,35 +266,31 @@ std::size_t SLIPEncoding::encode(const uint8_t* buffer,
     if (size == 0)
         return 0;
 
-    std::size_t read_index  = 0;
-    std::size_t write_index = 0;
+    uint8_t* out = encoded;
 
     // double-ENDed, flush any data that may have accumulated due to line noise
-    encoded[write_index++] = END;
+    *out++ = END;
 
-    while (read_index < size)
+    while (size > 0)
     {
-        if(buffer[read_index] == END)
-        {
-            encoded[write_index++] = ESC;
-            encoded[write_index++] = ESC_END;
-            read_index++;
-        }
-        else if(buffer[read_index] == ESC)
-        {
-            encoded[write_index++] = ESC;
-            encoded[write_index++] = ESC_ESC;
-            read_index++;
-        }
-        else
+        std::size_t run = findSpecial(buffer, size);
+        std::memcpy(out, buffer, run);
+        out += run;
+        buffer += run;
+        size -= run;
+
+        if (size > 0)
         {
-            encoded[write_index++] = buffer[read_index++];
+            *out++ = ESC;
+            *out++ = (*buffer++ == END) ? ESC_END : ESC_ESC;
+            --size;
         }
     }
 
-    return write_index;
+    return static_cast<std::size_t>(out - encoded);
 }
 
+
 std::size_t SLIPEncoding::decode(const uint8_t* buffer,
                                  std::size_t size,
                                  uint8_t* decoded)
@@ -107,40 +298,97 @@ std::size_t SLIPEncoding::decode(const uint8_t* buffer,
     if (size == 0)
         return 0;
 
-    std::size_t read_index  = 0;
-    std::size_t write_index = 0;
+    const uint8_t* end = buffer + size;
+    uint8_t* out = decoded;
 
-    while (read_index < size)
+    while (buffer < end)
     {
-        if (buffer[read_index] == END)
+        std::size_t run = findSpecial(buffer, static_cast<std::size_t>(end - buffer));
+        std::memcpy(out, buffer, run);
+        out += run;
+        buffer += run;
+
+        if (buffer == end)
+        {
+            break;
+        }
+
+        if (*buffer++ == END)
         {
             // flush or done
-            read_index++;
         }
-        else if (buffer[read_index] == ESC)
+        else if (buffer < end)
         {
-            if (buffer[read_index+1] == ESC_END)
+            // An ESC followed by anything else is a protocol violation, and
+            // the byte is kept as is, as RFC 1055 suggests.
+            uint8_t byte = *buffer++;
+
+            if (byte == ESC_END)
             {
-                decoded[write_index++] = END;
-                read_index += 2;
+                *out++ = END;
             }
-            else if (buffer[read_index+1] == ESC_ESC)
+            else if (byte == ESC_ESC)
             {
-                decoded[write_index++] = ESC;
-                read_index += 2;
+                *out++ = ESC;
             }
             else
             {
-                // considered a protocol violation
+                *out++ = byte;
             }
         }
-        else
+    }
+
+    return static_cast<std::size_t>(out - decoded);
+}
+
+
+std::size_t SLIPEncoding::findSpecial(const uint8_t* buffer, std::size_t size)
+{
+    std::size_t i = 0;
+
+#if defined(OFX_IO_SLIP_SSE2)
+    const __m128i end = _mm_set1_epi8(static_cast<char>(END));
+    const __m128i esc = _mm_set1_epi8(static_cast<char>(ESC));
+
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + i));
+        uint64_t mask = static_cast<uint64_t>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, end),
+                                                                             _mm_cmpeq_epi8(v, esc))));
+
+        if (mask != 0)
+        {
+            return i + lowestBit(mask);
+        }
+    }
+#elif defined(OFX_IO_SLIP_NEON)
+    const uint8x16_t end = vdupq_n_u8(END);
+    const uint8x16_t esc = vdupq_n_u8(ESC);
+
+    for (; i + 16 <= size; i += 16)
+    {
+        uint8x16_t v = vld1q_u8(buffer + i);
+        uint8x16_t match = vorrq_u8(vceqq_u8(v, end), vceqq_u8(v, esc));
+
+        // Four bits per byte lane, via a narrowing shift.
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(match), 4)), 0);
+
+        if (mask != 0)
+        {
+            return i + lowestBit(mask) / 4;
+        }
+    }
+#endif
+
+    for (; i < size; ++i)
+    {
+        if (buffer[i] == END || buffer[i] == ESC)
         {
-            decoded[write_index++] = buffer[read_index++];
+            return i;
         }
     }
 
-    return write_index;
+    return size;
 }
 
 
@@ -0,0 +1,163 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/IO/SLIPStreamDecoder.h"
+#include <algorithm>
+#include <cstring>
+#include "ofx/IO/SLIPEncoding.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+SLIPStreamDecoder::SLIPStreamDecoder(std::size_t maximumFrameSize):
+    _maximumFrameSize(std::max(maximumFrameSize, std::size_t(1)))
+{
+}
+
+
+SLIPStreamDecoder::~SLIPStreamDecoder()
+{
+}
+
+
+std::size_t SLIPStreamDecoder::update(const ByteBufferView& buffer,
+                                      std::vector<ByteBuffer>& frames)
+{
+    std::size_t count = 0;
+
+    const uint8_t* in = buffer.getPtr();
+    const uint8_t* end = in + buffer.size();
+
+    while (in < end)
+    {
+        if (_isDiscarding)
+        {
+            const uint8_t* next = static_cast<const uint8_t*>(std::memchr(in, SLIPEncoding::END, std::size_t(end - in)));
+
+            if (next == nullptr)
+            {
+                break;
+            }
+
+            in = next + 1;
+            _frame.clear();
+            _isEscaped = false;
+            _isDiscarding = false;
+        }
+        else if (_isEscaped)
+        {
+            uint8_t byte = *in++;
+            _isEscaped = false;
+
+            if (byte == SLIPEncoding::ESC_END)
+            {
+                byte = SLIPEncoding::END;
+            }
+            else if (byte == SLIPEncoding::ESC_ESC)
+            {
+                byte = SLIPEncoding::ESC;
+            }
+            else
+            {
+                ++_statistics.invalidEscapes;
+            }
+
+            _append(&byte, 1);
+        }
+        else
+        {
+            std::size_t run = SLIPEncoding::findSpecial(in, std::size_t(end - in));
+            _append(in, run);
+            in += run;
+
+            if (in == end || _isDiscarding)
+            {
+                continue;
+            }
+
+            if (*in++ == SLIPEncoding::ESC)
+            {
+                _isEscaped = true;
+            }
+            else if (!_frame.empty())
+            {
+                // Hand the frame over and take the storage of the buffer it
+                // replaces.
+                if (count < frames.size())
+                {
+                    std::swap(frames[count], _frame);
+                }
+                else
+                {
+                    frames.push_back(std::move(_frame));
+                }
+
+                _frame.clear();
+                ++count;
+                ++_statistics.frames;
+            }
+        }
+    }
+
+    frames.resize(count);
+    return count;
+}
+
+
+std::size_t SLIPStreamDecoder::update(const ByteBufferView& buffer,
+                                      ThreadChannel<std::vector<ByteBuffer>>& channel)
+{
+    std::size_t count = update(buffer, _batch);
+
+    if (count > 0)
+    {
+        channel.send(std::move(_batch));
+        _batch.clear();
+    }
+
+    return count;
+}
+
+
+void SLIPStreamDecoder::reset()
+{
+    _frame.clear();
+    _isEscaped = false;
+    _isDiscarding = true;
+}
+
+
+const SLIPStreamDecoder::Statistics& SLIPStreamDecoder::statistics() const
+{
+    return _statistics;
+}
+
+
+std::size_t SLIPStreamDecoder::maximumFrameSize() const
+{
+    return _maximumFrameSize;
+}
+
+
+void SLIPStreamDecoder::_append(const uint8_t* buffer, std::size_t size)
+{
+    if (_frame.size() + size > _maximumFrameSize)
+    {
+        ++_statistics.oversizedFrames;
+        _frame.clear();
+        _isDiscarding = true;
+    }
+    else
+    {
+        _frame.writeBytes(buffer, size);
+    }
+}
+
+
+} }  // namespace ofx::IO
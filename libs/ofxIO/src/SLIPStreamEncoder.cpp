@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/IO/SLIPStreamEncoder.h"
+#include "ofx/IO/SLIPEncoding.h"
+
+
+namespace ofx {
+namespace IO {
+
+
+SLIPStreamEncoder::SLIPStreamEncoder()
+{
+}
+
+
+SLIPStreamEncoder::~SLIPStreamEncoder()
+{
+}
+
+
+std::size_t SLIPStreamEncoder::write(const uint8_t* buffer, std::size_t size)
+{
+    const std::size_t offset = _buffer.size();
+
+    // SLIPEncoding::encode() writes the leading END and the escaped frame,
+    // in at most 2 * size + 1 bytes. Over a batch, only the first frame
+    // keeps its leading END.
+    const std::size_t start = (offset > 0) ? offset - 1 : offset;
+    _buffer.resize(start + 2 * size + 2);
+
+    std::size_t written = 1;
+
+    if (size > 0)
+    {
+        written = SLIPEncoding::encode(buffer, size, _buffer.getPtr() + start);
+    }
+    else
+    {
+        _buffer.getPtr()[start] = SLIPEncoding::END;
+    }
+
+    _buffer.getPtr()[start + written] = SLIPEncoding::END;
+    _buffer.resize(start + written + 1);
+
+    ++_frames;
+    return _buffer.size() - offset;
+}
+
+
+std::size_t SLIPStreamEncoder::write(const ByteBufferView& buffer)
+{
+    return write(buffer.getPtr(), buffer.size());
+}
+
+
+const ByteBuffer& SLIPStreamEncoder::buffer() const
+{
+    return _buffer;
+}
+
+
+std::size_t SLIPStreamEncoder::frames() const
+{
+    return _frames;
+}
+
+
+void SLIPStreamEncoder::clear()
+{
+    _buffer.clear();
+    _frames = 0;
+}
+
+
+} }  // namespace ofx::IO
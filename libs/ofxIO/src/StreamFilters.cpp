@@ -28,7 +28,66 @@ InflatingInputStreamFilter::~InflatingInputStreamFilter()
 
 std::istream& InflatingInputStreamFilter::filter(std::istream& stream)
 {
-    _stream = std::make_unique<Poco::InflatingInputStream>(stream, _type);
+    if (_stream == nullptr || _source != &stream)
+    {
+        _stream.reset();
+        _stream = std::make_unique<Poco::InflatingInputStream>(stream, _type);
+        _source = &stream;
+    }
+
+    return *_stream;
+}
+
+
+ByteTransformInputStreamFilter::ByteTransformInputStreamFilter(std::unique_ptr<AbstractByteTransform> transform):
+    _transform(std::move(transform))
+{
+}
+
+
+ByteTransformInputStreamFilter::~ByteTransformInputStreamFilter()
+{
+}
+
+
+std::istream& ByteTransformInputStreamFilter::filter(std::istream& stream)
+{
+    if (_stream == nullptr || _source != &stream)
+    {
+        _stream.reset();
+        _transform->reset();
+        _stream = std::make_unique<ByteTransformInputStream>(stream, *_transform);
+        _source = &stream;
+    }
+
+    return *_stream;
+}
+
+
+ByteTransformOutputStreamFilter::ByteTransformOutputStreamFilter(std::unique_ptr<AbstractByteTransform> transform):
+    _transform(std::move(transform))
+{
+}
+
+
+ByteTransformOutputStreamFilter::~ByteTransformOutputStreamFilter()
+{
+}
+
+
+std::ostream& ByteTransformOutputStreamFilter::filter(std::ostream& stream)
+{
+    // The same stream is returned each time, so the transform is not
+    // finished in the middle of the content.
+    if (_stream == nullptr || _source != &stream)
+    {
+        // Replacing the stream closes, and so finishes, the previous one.
+        _stream.reset();
+        _transform->reset();
+        _stream = std::make_unique<ByteTransformOutputStream>(stream, *_transform);
+        _source = &stream;
+    }
+
     return *_stream;
 }
 
@@ -6,15 +6,315 @@
 
 
 #include "ofx/IO/URIEncoding.h"
+#include <algorithm>
+#include <cstring>
 #include "ofx/IO/ByteBuffer.h"
-#include "Poco/URI.h"
+#include "Poco/Exception.h"
 
 
 namespace ofx {
 namespace IO {
 
 
-URIEncoding::URIEncoding()
+namespace {
+
+
+/// \brief The bytes that are never escaped.
+const char UNRESERVED_BYTES[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-._~";
+
+
+/// \brief The bytes escaped by Poco::URI::encode() besides controls, space
+/// and non-ASCII bytes.
+const char ILLEGAL_BYTES[] = "%<>{}|\\\"^`!*'()$,[]";
+
+
+/// \brief The uppercase hex digits used in escapes.
+const char DIGITS[] = "0123456789ABCDEF";
+
+
+/// \returns the set of bytes that are not in the allowed bytes.
+ByteSet allBut(const std::string& allowed)
+{
+    ByteSet escaped;
+
+    for (std::size_t c = 0; c < 256; ++c)
+    {
+        escaped.insert(uint8_t(c));
+    }
+
+    for (char c: allowed)
+    {
+        escaped.erase(uint8_t(c));
+    }
+
+    return escaped;
+}
+
+
+/// \returns the bytes escaped by Poco::URI::encode().
+/// \param reserved The reserved bytes that are also escaped.
+ByteSet pocoEscapedBytes(const std::string& reserved)
+{
+    ByteSet escaped(std::string(ILLEGAL_BYTES) + reserved);
+
+    for (std::size_t c = 0; c < 256; ++c)
+    {
+        if (c <= 0x20 || c >= 0x7F)
+        {
+            escaped.insert(uint8_t(c));
+        }
+    }
+
+    // Poco never escapes an unreserved byte, even when it is reserved.
+    for (const char* c = UNRESERVED_BYTES; *c; ++c)
+    {
+        escaped.erase(uint8_t(*c));
+    }
+
+    return escaped;
+}
+
+
+/// \brief The precomputed escaped bytes of each profile.
+struct Profiles
+{
+    Profiles():
+        sets {
+            pocoEscapedBytes(""),
+            allBut(std::string(UNRESERVED_BYTES) + "!$&'()*+,;=:@/"),
+            allBut(std::string(UNRESERVED_BYTES) + "!$'()*,;:@/?"),
+            allBut("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789*-._"),
+            allBut(UNRESERVED_BYTES)
+        }
+    {
+    }
+
+    ByteSet sets[5];
+
+    static const Profiles& instance()
+    {
+        static const Profiles profiles;
+        return profiles;
+    }
+
+};
+
+
+/// \returns the exact size of the encoded bytes.
+std::size_t encodedSizeWith(const uint8_t* buffer,
+                            std::size_t size,
+                            const ByteSet& escaped,
+                            bool spaceAsPlus)
+{
+    std::size_t escapes = 0;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        escapes += escaped.contains(buffer[i]);
+    }
+
+    std::size_t encodedSize = size + 2 * escapes;
+
+    if (spaceAsPlus)
+    {
+        encodedSize -= 2 * std::size_t(std::count(buffer, buffer + size, uint8_t(' ')));
+    }
+
+    return encodedSize;
+}
+
+
+/// \brief Encode with a set of escaped bytes, copying the runs between
+/// escapes whole.
+std::size_t encodeWith(const uint8_t* buffer,
+                       std::size_t size,
+                       uint8_t* encodedBuffer,
+                       const ByteSet& escaped,
+                       bool spaceAsPlus)
+{
+    const uint8_t* in = buffer;
+    const uint8_t* end = buffer + size;
+    uint8_t* out = encodedBuffer;
+
+    while (in < end)
+    {
+        const uint8_t* run = in;
+
+        while (in < end && !escaped.contains(*in))
+        {
+            ++in;
+        }
+
+        std::memcpy(out, run, std::size_t(in - run));
+        out += in - run;
+
+        if (in == end)
+        {
+            break;
+        }
+
+        uint8_t byte = *in++;
+
+        if (spaceAsPlus && byte == ' ')
+        {
+            *out++ = '+';
+        }
+        else
+        {
+            *out++ = '%';
+            *out++ = DIGITS[byte >> 4];
+            *out++ = DIGITS[byte & 0xF];
+        }
+    }
+
+    return static_cast<std::size_t>(out - encodedBuffer);
+}
+
+
+/// \returns the value of a hex digit.
+/// \throws Poco::URISyntaxException if the byte is not a hex digit.
+uint8_t hexValue(uint8_t c)
+{
+    if (c >= '0' && c <= '9') return uint8_t(c - '0');
+    if (c >= 'A' && c <= 'F') return uint8_t(c - 'A' + 10);
+    if (c >= 'a' && c <= 'f') return uint8_t(c - 'a' + 10);
+    throw Poco::URISyntaxException("URI encoding: not a hex digit");
+}
+
+
+/// \brief An incremental URI encoder with the same output as encode().
+class URIStreamEncoder: public AbstractByteTransform
+{
+public:
+    URIStreamEncoder(URIEncoding::Profile profile):
+        _escaped(URIEncoding::escapedBytes(profile)),
+        _spaceAsPlus(profile == URIEncoding::Profile::FORM)
+    {
+    }
+
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        const std::size_t offset = outputBuffer.size();
+        outputBuffer.resize(offset + 3 * buffer.size());
+
+        std::size_t written = encodeWith(buffer.getPtr(),
+                                         buffer.size(),
+                                         outputBuffer.getPtr() + offset,
+                                         _escaped,
+                                         _spaceAsPlus);
+
+        outputBuffer.resize(offset + written);
+        return written;
+    }
+
+    std::size_t finish(ByteBuffer&) override
+    {
+        return 0;
+    }
+
+    void reset() override
+    {
+    }
+
+private:
+    /// \brief The bytes that are percent encoded.
+    const ByteSet& _escaped;
+
+    /// \brief True if a space is encoded as '+'.
+    bool _spaceAsPlus = false;
+
+};
+
+
+/// \brief An incremental URI decoder with the same output as decode().
+class URIStreamDecoder: public AbstractByteTransform
+{
+public:
+    URIStreamDecoder(bool plusAsSpace): _plusAsSpace(plusAsSpace)
+    {
+    }
+
+    std::size_t update(const ByteBufferView& buffer, ByteBuffer& outputBuffer) override
+    {
+        const std::size_t offset = outputBuffer.size();
+        outputBuffer.resize(offset + buffer.size());
+
+        uint8_t* out = outputBuffer.getPtr() + offset;
+
+        for (std::size_t i = 0; i < buffer.size(); ++i)
+        {
+            uint8_t byte = buffer.getPtr()[i];
+
+            if (_digits > 0)
+            {
+                _value = uint8_t((_value << 4) | hexValue(byte));
+
+                if (++_digits == 3)
+                {
+                    *out++ = _value;
+                    _digits = 0;
+                }
+            }
+            else if (byte == '%')
+            {
+                _value = 0;
+                _digits = 1;
+            }
+            else if (_plusAsSpace && byte == '+')
+            {
+                *out++ = ' ';
+            }
+            else
+            {
+                *out++ = byte;
+            }
+        }
+
+        std::size_t written = static_cast<std::size_t>(out - (outputBuffer.getPtr() + offset));
+        outputBuffer.resize(offset + written);
+        return written;
+    }
+
+    std::size_t finish(ByteBuffer&) override
+    {
+        std::size_t digits = _digits;
+        reset();
+
+        if (digits == 1)
+        {
+            throw Poco::URISyntaxException("URI encoding: no hex digit following percent sign");
+        }
+        else if (digits == 2)
+        {
+            throw Poco::URISyntaxException("URI encoding: two hex digits must follow percent sign");
+        }
+
+        return 0;
+    }
+
+    void reset() override
+    {
+        _value = 0;
+        _digits = 0;
+    }
+
+private:
+    /// \brief True if a '+' is decoded as a space.
+    bool _plusAsSpace = false;
+
+    /// \brief The value of the current escape.
+    uint8_t _value = 0;
+
+    /// \brief The position in the current escape, 0 if not escaping.
+    std::size_t _digits = 0;
+
+};
+
+
+} // namespace
+
+
+URIEncoding::URIEncoding(Profile profile): _profile(profile)
 {
 }
 
@@ -27,36 +327,202 @@ URIEncoding::~URIEncoding()
 std::size_t URIEncoding::encode(const ByteBuffer& buffer,
                                 ByteBuffer& encodedBuffer)
 {
-    std::string encoded;
-    Poco::URI::encode(buffer.toString(), "", encoded);
-    encodedBuffer = ByteBuffer(encoded);
-    return encodedBuffer.size();
+    return encode(ByteBufferView(buffer), encodedBuffer);
 }
 
 
 std::size_t URIEncoding::decode(const ByteBuffer& buffer,
                                 ByteBuffer& decodedBuffer)
 {
-    std::string decoded;
-    Poco::URI::decode(buffer.toString(), decoded);
-    decodedBuffer = ByteBuffer(decoded);
-    return decodedBuffer.size();
+    return decode(ByteBufferView(buffer), decodedBuffer);
+}
+
+
+std::size_t URIEncoding::encode(const ByteBufferView& buffer,
+                                ByteBuffer& encodedBuffer)
+{
+    encodedBuffer.resize(encodedSize(buffer.getPtr(), buffer.size(), _profile));
+    return encode(buffer.getPtr(), buffer.size(), encodedBuffer.getPtr(), _profile);
+}
+
+
+std::size_t URIEncoding::decode(const ByteBufferView& buffer,
+                                ByteBuffer& decodedBuffer)
+{
+    decodedBuffer.resize(buffer.size());
+
+    std::size_t size = decode(buffer.getPtr(),
+                              buffer.size(),
+                              decodedBuffer.getPtr(),
+                              _profile == Profile::FORM);
+
+    decodedBuffer.resize(size);
+    return size;
+}
+
+
+std::unique_ptr<AbstractByteTransform> URIEncoding::createStreamEncoder()
+{
+    return std::make_unique<URIStreamEncoder>(_profile);
+}
+
+
+std::unique_ptr<AbstractByteTransform> URIEncoding::createStreamDecoder()
+{
+    return std::make_unique<URIStreamDecoder>(_profile == Profile::FORM);
+}
+
+
+URIEncoding::Profile URIEncoding::profile() const
+{
+    return _profile;
+}
+
+
+const ByteSet& URIEncoding::escapedBytes(Profile profile)
+{
+    return Profiles::instance().sets[static_cast<std::size_t>(profile)];
+}
+
+
+std::size_t URIEncoding::encodedSize(const uint8_t* buffer,
+                                     std::size_t size,
+                                     Profile profile)
+{
+    return encodedSizeWith(buffer,
+                           size,
+                           escapedBytes(profile),
+                           profile == Profile::FORM);
+}
+
+
+std::size_t URIEncoding::encode(const uint8_t* buffer,
+                                std::size_t size,
+                                uint8_t* encodedBuffer,
+                                Profile profile)
+{
+    return encodeWith(buffer,
+                      size,
+                      encodedBuffer,
+                      escapedBytes(profile),
+                      profile == Profile::FORM);
+}
+
+
+std::size_t URIEncoding::decode(const uint8_t* buffer,
+                                std::size_t size,
+                                uint8_t* decodedBuffer,
+                                bool plusAsSpace)
+{
+    const uint8_t* in = buffer;
+    const uint8_t* end = buffer + size;
+    uint8_t* out = decodedBuffer;
+
+    while (in < end)
+    {
+        const uint8_t* run = in;
+
+        if (plusAsSpace)
+        {
+            while (in < end && *in != '%' && *in != '+')
+            {
+                ++in;
+            }
+        }
+        else
+        {
+            in = static_cast<const uint8_t*>(std::memchr(in, '%', std::size_t(end - in)));
+
+            if (in == nullptr)
+            {
+                in = end;
+            }
+        }
+
+        // The output never passes the input, so a run may overlap itself
+        // when decoding in place.
+        if (out != run)
+        {
+            std::memmove(out, run, std::size_t(in - run));
+        }
+
+        out += in - run;
+
+        if (in == end)
+        {
+            break;
+        }
+
+        if (*in++ == '+')
+        {
+            *out++ = ' ';
+            continue;
+        }
+
+        if (in == end)
+        {
+            throw Poco::URISyntaxException("URI encoding: no hex digit following percent sign");
+        }
+
+        if (end - in < 2)
+        {
+            throw Poco::URISyntaxException("URI encoding: two hex digits must follow percent sign");
+        }
+
+        uint8_t hi = hexValue(in[0]);
+        uint8_t lo = hexValue(in[1]);
+        in += 2;
+
+        *out++ = uint8_t((hi << 4) | lo);
+    }
+
+    return static_cast<std::size_t>(out - decodedBuffer);
+}
+
+
+std::size_t URIEncoding::decodeInPlace(ByteBuffer& buffer, bool plusAsSpace)
+{
+    std::size_t size = decode(buffer.getPtr(), buffer.size(), buffer.getPtr(), plusAsSpace);
+    buffer.resize(size);
+    return size;
 }
 
 
 std::string URIEncoding::encode(const std::string& buffer,
                                 const std::string& reserved)
 {
-    std::string encoded;
-    Poco::URI::encode(buffer, reserved, encoded);
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(buffer.data());
+
+    if (reserved.empty())
+    {
+        std::string encoded(encodedSize(data, buffer.size()), '\0');
+        encode(data, buffer.size(), reinterpret_cast<uint8_t*>(&encoded[0]));
+        return encoded;
+    }
+
+    ByteSet escaped = pocoEscapedBytes(reserved);
+    std::string encoded(encodedSizeWith(data, buffer.size(), escaped, false), '\0');
+    encodeWith(data, buffer.size(), reinterpret_cast<uint8_t*>(&encoded[0]), escaped, false);
     return encoded;
 }
 
 
 std::string URIEncoding::decode(const std::string& buffer, bool plusAsSpace)
 {
-    std::string decoded;
-    Poco::URI::decode(buffer, decoded, plusAsSpace);
+    std::string decoded(buffer);
+    uint8_t* data = reinterpret_cast<uint8_t*>(&decoded[0]);
+
+    // Like Poco::URI::decode(), a plus sign is only a space in the query.
+    std::size_t query = plusAsSpace ? decoded.find('?') : std::string::npos;
+
+    if (query == std::string::npos)
+    {
+        query = decoded.size();
+    }
+
+    std::size_t size = decode(data, query, data, false);
+    size += decode(data + query, decoded.size() - query, data + size, plusAsSpace);
+    decoded.resize(size);
     return decoded;
 }
 
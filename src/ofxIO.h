@@ -16,15 +16,32 @@
 #include "ofx/RecursiveDirectoryIterator.h"
 #include "ofx/LRUCache.h"
 #include "ofx/IO/AbstractTypes.h"
+#include "ofx/IO/AsyncFileIO.h"
 #include "ofx/IO/Base64Encoding.h"
 #include "ofx/IO/ByteBuffer.h"
+#include "ofx/IO/ByteBufferParser.h"
+#include "ofx/IO/ByteBufferPool.h"
 #include "ofx/IO/ByteBufferReader.h"
 #include "ofx/IO/ByteBufferStream.h"
 #include "ofx/IO/ByteBufferUtils.h"
+#include "ofx/IO/ByteBufferView.h"
 #include "ofx/IO/ByteBufferWriter.h"
+#include "ofx/IO/ByteOrder.h"
+#include "ofx/IO/ByteSet.h"
+#include "ofx/IO/ByteTransformStream.h"
+#include "ofx/IO/ByteChain.h"
 #include "ofx/IO/COBSEncoding.h"
+#include "ofx/IO/COBSStreamDecoder.h"
+#include "ofx/IO/CodecPipeline.h"
+#include "ofx/IO/CodecRegistry.h"
 #include "ofx/IO/SLIPEncoding.h"
+#include "ofx/IO/SLIPStreamDecoder.h"
+#include "ofx/IO/SLIPStreamEncoder.h"
 #include "ofx/IO/Compression.h"
+#include "ofx/IO/CompressionDictionary.h"
+#include "ofx/IO/CompressionEncoding.h"
+#include "ofx/IO/Compressor.h"
+#include "ofx/IO/Decompressor.h"
 #include "ofx/IO/DeviceFilter.h"
 #include "ofx/IO/DirectoryUtils.h"
 #include "ofx/IO/DirectoryFilter.h"
@@ -35,6 +52,9 @@
 #include "ofx/IO/ImageUtils.h"
 #include "ofx/IO/JSONUtils.h"
 #include "ofx/IO/LinkFilter.h"
+#include "ofx/IO/LZ4Frame.h"
+#include "ofx/IO/MappedFileBuffer.h"
+#include "ofx/IO/ParallelCompression.h"
 #include "ofx/IO/PathFilterCollection.h"
 #include "ofx/IO/RegexPathFilter.h"
 #include "ofx/IO/SearchPath.h"